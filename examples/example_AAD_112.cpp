@@ -2,6 +2,7 @@
 
 #include <Eigen/Dense>
 
+#include "Derivatives.hpp"
 #include "RecordType.hpp"
 
 #include "save_to_dot.hpp"
@@ -27,4 +28,13 @@ auto main() -> int {
   f(v);
 
   save_to_dot(__FILE__, graph.get());
+
+  // Jacobian using one reverse sweep per output
+  const std::array outputs{v(0).id(), v(1).id()};
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    std::array seeds{0.0, 0.0};
+    seeds[i]        = 1.0;
+    const auto grad = RT::gradient<PassiveType>(*graph, outputs, seeds);
+    std::cout << "d v(" << i << ") / d v = [" << grad[0] << ", " << grad[1] << "]\n";
+  }
 }
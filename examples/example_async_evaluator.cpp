@@ -0,0 +1,70 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "AsyncEvaluator.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+// Usage: example_async_evaluator [n]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  const auto n = static_cast<Eigen::Index>(argc > 1 ? std::stol(argv[1]) : 60l);
+
+  // The factorization is shared by all columns of the inverse, the solves are independent
+  Eigen::MatrixX<RType> A(n, n);
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  for (Eigen::Index j = 0; j < n; ++j) {
+    for (Eigen::Index i = 0; i < n; ++i) {
+      A(i, j) = 1.0 / static_cast<double>(i + j + 1) + (i == j ? static_cast<double>(n) : 0.0);
+      A(i, j).register_graph(graph);
+    }
+  }
+  const Eigen::MatrixX<RType> A_inv = A.llt().solve(Eigen::MatrixX<RType>::Identity(n, n));
+
+  std::vector<int64_t> outputs{};
+  std::vector<PassiveType> inputs{};
+  for (const auto& r : A_inv.reshaped()) {
+    outputs.push_back(r.id());
+  }
+  for (const auto& a : A.reshaped()) {
+    inputs.push_back(2.0 * a.value());
+  }
+
+  RT::Evaluator<PassiveType> eval(*graph);
+  const auto begin_eval = std::chrono::steady_clock::now();
+  eval.evaluate(inputs);
+  const auto end_eval = std::chrono::steady_clock::now();
+
+  RT::AsyncEvaluator<PassiveType> async_eval(*graph, outputs, static_cast<size_t>(n));
+  const auto begin_async = std::chrono::steady_clock::now();
+  const auto futures     = async_eval.evaluate_async(inputs);
+
+  // Consume the inverse column by column as soon as a column is ready
+  std::vector<double> column_times{};
+  bool correct = true;
+  for (Eigen::Index col = 0; col < n; ++col) {
+    for (Eigen::Index row = 0; row < n; ++row) {
+      const auto o = static_cast<size_t>(col * n + row);
+      correct      = correct && futures[o].get() == eval.value(outputs[o]);
+    }
+    column_times.push_back(
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_async).count());
+  }
+
+  std::cout << "Inverse of a " << n << 'x' << n << " matrix, graph with "
+            << graph->operations().size() << " nodes, " << async_eval.num_tasks() << " tasks on "
+            << async_eval.num_threads() << " threads\n";
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << "  Evaluator:          "
+            << std::chrono::duration<double>(end_eval - begin_eval).count() << " s\n";
+  std::cout << "  First column ready: " << column_times.front() << " s\n";
+  std::cout << "  All columns ready:  " << column_times.back() << " s\n";
+  std::cout << "  Matches evaluator:  " << std::boolalpha << correct << '\n';
+}
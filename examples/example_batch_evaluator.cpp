@@ -0,0 +1,101 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include <Eigen/Dense>
+
+#include "BatchEvaluator.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+// Same kernel as in `example_AAD_112`
+template <typename T>
+void f(Eigen::Vector2<T>& v) {
+  T u;
+  u    = v(0) * v(0) * v(1) * v(1);
+  v(0) = sin(u);
+  v(1) = v(1) * u;
+}
+
+template <typename Eval>
+[[nodiscard]] auto run_batched(Eval& eval,
+                               const std::vector<double>& xs,
+                               const std::vector<double>& ys,
+                               int64_t out_id) -> double {
+  constexpr auto W = Eval::width();
+  std::vector<double> inputs(2 * W);
+  double checksum = 0.0;
+  for (size_t i = 0; i < xs.size(); i += W) {
+    std::copy_n(std::next(std::cbegin(xs), static_cast<std::ptrdiff_t>(i)), W, std::begin(inputs));
+    std::copy_n(std::next(std::cbegin(ys), static_cast<std::ptrdiff_t>(i)),
+                W,
+                std::next(std::begin(inputs), static_cast<std::ptrdiff_t>(W)));
+    eval.evaluate(inputs);
+    for (auto value : eval.lanes(out_id)) {
+      checksum += value;
+    }
+  }
+  return checksum;
+}
+
+template <typename Func>
+[[nodiscard]] auto time_it(const Func& func) -> std::pair<double, double> {
+  const auto begin    = std::chrono::steady_clock::now();
+  const auto checksum = func();
+  const auto end      = std::chrono::steady_clock::now();
+  return {std::chrono::duration<double>(end - begin).count(), checksum};
+}
+
+auto main() -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  Eigen::Vector2<RType> v{1.0, 2.0};
+
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  v(0).register_graph(graph);
+  v(1).register_graph(graph);
+  f(v);
+  const auto out_id = v(1).id();
+
+  constexpr size_t num_samples = 1ul << 20ul;
+  std::mt19937 gen(42);  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<double> xs(num_samples);
+  std::vector<double> ys(num_samples);
+  std::generate(std::begin(xs), std::end(xs), [&] { return dist(gen); });
+  std::generate(std::begin(ys), std::end(ys), [&] { return dist(gen); });
+
+  RT::Evaluator<PassiveType> scalar_eval(*graph);
+  const auto [scalar_time, scalar_checksum] = time_it([&] {
+    double checksum = 0.0;
+    for (size_t i = 0; i < num_samples; ++i) {
+      const std::array inputs{xs[i], ys[i]};
+      scalar_eval.evaluate(inputs);
+      checksum += scalar_eval.value(out_id);
+    }
+    return checksum;
+  });
+
+  RT::BatchEvaluator<PassiveType, 4> eval_4(*graph);
+  RT::BatchEvaluator<PassiveType, 8> eval_8(*graph);
+  RT::BatchEvaluator<PassiveType, 16> eval_16(*graph);
+  const auto [time_4, checksum_4]   = time_it([&] { return run_batched(eval_4, xs, ys, out_id); });
+  const auto [time_8, checksum_8]   = time_it([&] { return run_batched(eval_8, xs, ys, out_id); });
+  const auto [time_16, checksum_16] = time_it([&] { return run_batched(eval_16, xs, ys, out_id); });
+
+  const auto report = [&](const std::string& name, double time, double checksum) {
+    std::cout << std::setw(16) << name << ": " << std::setw(10) << std::fixed
+              << std::setprecision(2) << static_cast<double>(num_samples) / time * 1e-6
+              << " Msamples/s, speedup " << std::setw(5) << scalar_time / time
+              << ", checksum " << std::scientific << checksum << '\n';
+  };
+
+  std::cout << "Replay of " << graph->operations().size() << " nodes for " << num_samples
+            << " input sets\n";
+  report("scalar", scalar_time, scalar_checksum);
+  report("batch width 4", time_4, checksum_4);
+  report("batch width 8", time_8, checksum_8);
+  report("batch width 16", time_16, checksum_16);
+}
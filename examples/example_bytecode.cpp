@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Bytecode.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+// Explicit time stepping of a 1D heat equation with a nonlinear source term
+template <typename T>
+[[nodiscard]] auto heat(std::vector<T> u, size_t num_steps) -> std::vector<T> {
+  const T dt = 0.2;
+  const T k  = 0.05;
+  for (size_t step = 0; step < num_steps; ++step) {
+    std::vector<T> next(u.size());
+    next.front() = u.front();
+    next.back()  = u.back();
+    for (size_t i = 1; i + 1 < u.size(); ++i) {
+      next[i] = u[i] + dt * (u[i - 1] - u[i] - u[i] + u[i + 1]) + k * sin(u[i]);
+    }
+    u = std::move(next);
+  }
+  return u;
+}
+
+template <typename Eval>
+[[nodiscard]] auto time_evaluate(Eval& eval, const std::vector<double>& inputs, int repetitions)
+    -> double {
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i) {
+    eval.evaluate(inputs);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - begin).count() / static_cast<double>(repetitions);
+}
+
+// Usage: example_bytecode [n] [num_steps]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  const size_t n            = argc > 1 ? std::stoul(argv[1]) : 1'000ul;
+  const size_t num_steps    = argc > 2 ? std::stoul(argv[2]) : 100ul;
+  constexpr int repetitions = 20;
+
+  std::vector<RType> u(n);
+  std::vector<PassiveType> inputs(n);
+  for (size_t i = 0; i < n; ++i) {
+    const auto t = static_cast<PassiveType>(i) / static_cast<PassiveType>(n);
+    inputs[i]    = std::sin(std::numbers::pi * t);
+    u[i]      = inputs[i];
+  }
+
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  RT::register_variable(u, graph);
+  std::vector<int64_t> outputs{};
+  {
+    const auto res = heat(u, num_steps);
+    for (const auto& r : res) {
+      outputs.push_back(r.id());
+    }
+  }
+
+  RT::Evaluator<PassiveType> eval(*graph);
+  RT::BytecodeInterpreter<PassiveType> interpreter(*graph, outputs);
+
+  // The node-indexed interpreter reads the tape and one value slot per node
+  const auto& tape = eval.tape();
+  size_t num_args  = 0;
+  for (int64_t id = 0; id < static_cast<int64_t>(tape.num_nodes()); ++id) {
+    num_args += tape.args(id).size();
+  }
+  const auto tape_working_set =
+      tape.num_nodes() * (sizeof(RT::NodeType) + sizeof(size_t) + sizeof(int64_t) +
+                          sizeof(PassiveType)) +
+      num_args * sizeof(int64_t);
+
+  const auto& bytecode = interpreter.bytecode();
+  const auto eval_time = time_evaluate(eval, inputs, repetitions);
+  const auto bc_time   = time_evaluate(interpreter, inputs, repetitions);
+
+  double max_diff = 0.0;
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    max_diff = std::max(max_diff, std::abs(interpreter.output(i) - eval.value(outputs[i])));
+  }
+
+  constexpr double MIB = 1024.0 * 1024.0;
+  std::cout << "Replay of " << num_steps << " steps of a heat equation with " << n << " points\n";
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  Node-indexed: " << tape.num_nodes() << " nodes, " << tape.num_nodes()
+            << " value slots, working set " << static_cast<double>(tape_working_set) / MIB
+            << " MiB\n";
+  std::cout << "  Bytecode:     " << bytecode.code.size() << " instructions, "
+            << bytecode.num_registers << " registers, working set "
+            << static_cast<double>(bytecode.working_set_size()) / MIB << " MiB\n";
+  std::cout << "  Node-indexed: " << eval_time * 1e3 << " ms, "
+            << static_cast<double>(tape.num_nodes()) / eval_time * 1e-6 << " Mnodes/s\n";
+  std::cout << "  Bytecode:     " << bc_time * 1e3 << " ms, "
+            << static_cast<double>(tape.num_nodes()) / bc_time * 1e-6 << " Mnodes/s, speedup "
+            << eval_time / bc_time << '\n';
+  std::cout << "  Max. difference: " << std::scientific << max_diff << '\n';
+}
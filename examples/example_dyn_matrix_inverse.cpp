@@ -4,6 +4,7 @@
 
 #include <Eigen/Dense>
 
+#include "Derivatives.hpp"
 #include "RecordType.hpp"
 #include "TypeTraits.hpp"
 #include "save_to_dot.hpp"
@@ -138,5 +139,29 @@ auto main() -> int {
               << '\n';
   }
 
+  // Jacobian of all entries of the inverse w.r.t. all entries of the matrix; the entries of `mat`
+  // are registered in row major order, the outputs are collected in row major order as well
+  {
+    std::vector<int64_t> outputs{};
+    for (Eigen::Index i = 0; i < n; ++i) {
+      for (Eigen::Index j = 0; j < n; ++j) {
+        outputs.push_back(mat_inv(i, j).id());
+      }
+    }
+    const auto jac = RT::jacobian<DecayType>(*graph, outputs);
+
+    // d inv(i, j) / d A(k, l) = -inv(i, k) * inv(l, j)
+    const Eigen::MatrixX<DecayType> inv = decay_mat.inverse();
+    DecayType max_error                 = 0.0;
+    for (Eigen::Index out = 0; out < n * n; ++out) {
+      for (Eigen::Index in = 0; in < n * n; ++in) {
+        const auto expected = -inv(out / n, in / n) * inv(in % n, out % n);
+        const auto actual   = jac[static_cast<size_t>(out * n * n + in)];
+        max_error           = std::max(max_error, std::abs(actual - expected));
+      }
+    }
+    std::cout << "Jacobian: " << n * n << 'x' << n * n << ", max. error " << max_error << '\n';
+  }
+
   save_to_dot(__FILE__, graph.get(), opt);
 }
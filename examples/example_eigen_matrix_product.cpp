@@ -2,7 +2,7 @@
 
 #include <Eigen/Dense>
 
-#include "RecordType.hpp"
+#include "EigenSupport.hpp"
 #include "save_to_dot.hpp"
 
 auto main() -> int {
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ErrorAnalysis.hpp"
+#include "RecordType.hpp"
+
+// Explicit steps of a stencil code
+template <typename T>
+[[nodiscard]] auto smooth(std::vector<T> x, size_t num_iterations) -> std::vector<T> {
+  const T weight = 0.25;
+  for (size_t iter = 0; iter < num_iterations; ++iter) {
+    std::vector<T> next(x.size());
+    next.front() = x.front();
+    next.back()  = x.back();
+    for (size_t i = 1; i + 1 < x.size(); ++i) {
+      next[i] = x[i] + weight * (x[i - 1] - x[i] - x[i] + x[i + 1]) + sin(x[i]) * weight;
+    }
+    x = std::move(next);
+  }
+  return x;
+}
+
+template <typename Func>
+[[nodiscard]] auto time_it(const Func& func) -> double {
+  const auto begin = std::chrono::steady_clock::now();
+  func();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - begin).count();
+}
+
+// Usage: example_error_analysis [n]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  const size_t n              = argc > 1 ? std::stoul(argv[1]) : 20'000ul;
+  constexpr size_t iterations = 10;
+
+  std::vector<RType> x(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = 1e3 + std::cos(static_cast<PassiveType>(i));
+  }
+
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  RT::register_variable(x, graph);
+  std::vector<int64_t> outputs{};
+  {
+    // Subtract the offset again, the deviations lose about three digits
+    const RType offset = 1e3;
+    for (const auto& y : smooth(x, iterations)) {
+      outputs.push_back((y - offset).id());
+    }
+  }
+
+  const RT::Tape<PassiveType> tape(*graph);
+  const auto num_nodes = static_cast<double>(tape.num_nodes());
+
+  std::vector<RT::Interval<PassiveType>> box(n);
+  for (size_t i = 0; i < n; ++i) {
+    const auto value = tape.values()[static_cast<size_t>(tape.inputs()[i])];
+    box[i]           = {value - 1e-3, value + 1e-3};
+  }
+
+  std::vector<RT::Interval<PassiveType>> intervals{};
+  std::vector<PassiveType> errors{};
+  RT::PrecisionAnalysis<PassiveType> analysis{};
+  const auto interval_time =
+      time_it([&] { intervals = RT::interval_sweep<PassiveType>(tape, box); });
+  const auto error_time = time_it([&] {
+    errors = RT::rounding_error_sweep<PassiveType>(
+        tape, tape.values(), static_cast<PassiveType>(std::numeric_limits<float>::epsilon()) / 2);
+  });
+  const auto analysis_time = time_it([&] {
+    analysis = RT::analyze_precision<PassiveType>(tape, tape.values(), outputs, 1e-6);
+  });
+
+  PassiveType max_width = 0.0;
+  PassiveType max_error = 0.0;
+  for (auto out : outputs) {
+    max_width = std::max(max_width, intervals[static_cast<size_t>(out)].width());
+    max_error = std::max(max_error, errors[static_cast<size_t>(out)]);
+  }
+
+  std::cout << "Analysis of a graph with " << tape.num_nodes() << " nodes\n";
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << "  Interval sweep:       " << interval_time << " s, " << interval_time / num_nodes
+            << " s per node, max output width " << max_width << '\n';
+  std::cout << "  Rounding error sweep: " << error_time << " s, " << error_time / num_nodes
+            << " s per node, max float error bound " << max_error << '\n';
+  std::cout << "  Precision analysis:   " << analysis_time << " s, " << analysis_time / num_nodes
+            << " s per node, " << analysis.num_float_safe << " float safe nodes ("
+            << std::fixed << std::setprecision(1)
+            << 100.0 * static_cast<double>(analysis.num_float_safe) / num_nodes << "%)\n";
+}
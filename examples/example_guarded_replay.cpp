@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "GuardedReplay.hpp"
+#include "RecordType.hpp"
+
+// Smoothing of a signal that is clipped if its mean leaves a band, the clipping changes rarely
+template <typename T>
+[[nodiscard]] auto clipped_smooth(const std::vector<T>& x) -> std::vector<T> {
+  const T weight = 0.25;
+  std::vector<T> y(x.size());
+  T mean = 0.0;
+  for (size_t i = 0; i < x.size(); ++i) {
+    const T left  = x[i == 0 ? 0 : i - 1];
+    const T right = x[i + 1 == x.size() ? i : i + 1];
+    y[i]          = x[i] + weight * (left - x[i] - x[i] + right);
+    mean          = mean + y[i];
+  }
+  mean = mean * (1.0 / static_cast<double>(x.size()));
+
+  const T bound = 0.9;
+  if (mean > bound) {
+    for (auto& yi : y) {
+      yi = yi - (mean - bound);
+    }
+  }
+  return y;
+}
+
+// Usage: example_guarded_replay [n] [num_evaluations]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  const size_t n               = argc > 1 ? std::stoul(argv[1]) : 1'000ul;
+  const size_t num_evaluations = argc > 2 ? std::stoul(argv[2]) : 1'000ul;
+
+  // The mean crosses the bound for a few evaluations only
+  std::vector<std::vector<PassiveType>> inputs(num_evaluations, std::vector<PassiveType>(n));
+  for (size_t e = 0; e < num_evaluations; ++e) {
+    const auto offset = 0.5 + 0.5 * std::sin(static_cast<PassiveType>(e) * 0.01);
+    for (size_t i = 0; i < n; ++i) {
+      inputs[e][i] = offset + 0.1 * std::cos(static_cast<PassiveType>(i + e));
+    }
+  }
+
+  PassiveType checksum_replay = 0.0;
+  RT::GuardedReplay<PassiveType> replay(clipped_smooth<RType>);
+  const auto begin_replay = std::chrono::steady_clock::now();
+  for (const auto& x : inputs) {
+    checksum_replay += replay.evaluate(x)[n / 2];
+  }
+  const auto end_replay = std::chrono::steady_clock::now();
+
+  PassiveType checksum_record = 0.0;
+  const auto begin_record     = std::chrono::steady_clock::now();
+  for (const auto& x : inputs) {
+    auto graph = std::make_shared<RT::Graph<PassiveType>>();
+    std::vector<RType> x_record(x.begin(), x.end());
+    RT::register_variable(x_record, graph);
+    checksum_record += clipped_smooth(x_record)[n / 2].value();
+  }
+  const auto end_record = std::chrono::steady_clock::now();
+
+  const auto replay_time = std::chrono::duration<double>(end_replay - begin_replay).count();
+  const auto record_time = std::chrono::duration<double>(end_record - begin_record).count();
+
+  std::cout << num_evaluations << " evaluations of a function with " << n << " inputs\n";
+  std::cout << "  Guarded replay: " << replay.num_replays() << " replays, " << replay.num_switches()
+            << " switches to a cached trace, " << replay.num_records() << " records\n";
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << "  Record every evaluation: " << record_time << " s\n";
+  std::cout << "  Guarded replay:          " << replay_time << " s, speedup " << std::fixed
+            << std::setprecision(1) << record_time / replay_time << '\n';
+  std::cout << "  Checksums agree: " << std::boolalpha << (checksum_replay == checksum_record)
+            << '\n';
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "Derivatives.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+// Extended Rosenbrock function
+template <typename T>
+[[nodiscard]] auto rosenbrock(const std::vector<T>& x) -> T {
+  const T one     = 1.0;
+  const T hundred = 100.0;
+  T res           = 0.0;
+  for (size_t i = 0; i + 1 < x.size(); ++i) {
+    const T a = x[i + 1] - x[i] * x[i];
+    const T b = one - x[i];
+    res       = res + hundred * a * a + b * b;
+  }
+  return res;
+}
+
+template <typename Func>
+[[nodiscard]] auto time_it(const Func& func, int repetitions) -> double {
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i) {
+    func();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - begin).count() / static_cast<double>(repetitions);
+}
+
+auto main() -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  constexpr size_t n        = 10'000;
+  constexpr int repetitions = 20;
+
+  std::vector<RType> x(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = 0.5 + 0.5 * std::sin(static_cast<PassiveType>(i));
+  }
+
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  RT::register_variable(x, graph);
+  const RType res = rosenbrock(x);
+
+  std::vector<PassiveType> inputs(n);
+  std::vector<PassiveType> direction(n);
+  for (size_t i = 0; i < n; ++i) {
+    inputs[i]    = x[i].value();
+    direction[i] = std::cos(static_cast<PassiveType>(i));
+  }
+
+  const std::array outputs{res.id()};
+  const std::array seeds{1.0};
+  RT::Evaluator<PassiveType> eval(*graph);
+  eval.evaluate(inputs);
+
+  std::vector<PassiveType> hvp{};
+  const auto eval_time = time_it([&] { eval.evaluate(inputs); }, repetitions);
+  const auto hvp_time  = time_it(
+      [&] {
+        hvp = RT::hessian_vector_product<PassiveType>(
+            eval.tape(), eval.values(), outputs, seeds, direction);
+      },
+      repetitions);
+
+  // Central finite differences of the gradient, each gradient needs a replay and a reverse sweep
+  constexpr PassiveType h = 1e-6;
+  std::vector<PassiveType> fd(n);
+  std::vector<PassiveType> shifted(n);
+  const auto fd_time = time_it(
+      [&] {
+        for (size_t i = 0; i < n; ++i) {
+          shifted[i] = inputs[i] + h * direction[i];
+        }
+        eval.evaluate(shifted);
+        const auto grad_fwd = RT::gradient<PassiveType>(eval.tape(), eval.values(), outputs, seeds);
+
+        for (size_t i = 0; i < n; ++i) {
+          shifted[i] = inputs[i] - h * direction[i];
+        }
+        eval.evaluate(shifted);
+        const auto grad_bwd = RT::gradient<PassiveType>(eval.tape(), eval.values(), outputs, seeds);
+
+        for (size_t i = 0; i < n; ++i) {
+          fd[i] = (grad_fwd[i] - grad_bwd[i]) / (2.0 * h);
+        }
+      },
+      repetitions);
+
+  PassiveType max_diff = 0.0;
+  PassiveType max_hvp  = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    max_diff = std::max(max_diff, std::abs(hvp[i] - fd[i]));
+    max_hvp  = std::max(max_hvp, std::abs(hvp[i]));
+  }
+
+  std::cout << "Hessian-vector product of the Rosenbrock function with " << n << " inputs ("
+            << graph->operations().size() << " nodes)\n";
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << "  Function evaluation (replay):     " << eval_time << " s\n";
+  std::cout << "  Forward over reverse:             " << hvp_time << " s ("
+            << std::fixed << std::setprecision(1) << hvp_time / eval_time << "x evaluation)\n";
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << "  Finite differences of gradient:   " << fd_time << " s ("
+            << std::fixed << std::setprecision(1) << fd_time / eval_time << "x evaluation)\n";
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << "  Max. relative difference:         " << max_diff / max_hvp << '\n';
+}
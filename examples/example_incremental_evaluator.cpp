@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Evaluator.hpp"
+#include "IncrementalEvaluator.hpp"
+#include "RecordType.hpp"
+
+// Every entry of the output only depends on a small neighbourhood of the input, like one explicit
+// step of a stencil code applied several times
+template <typename T>
+[[nodiscard]] auto smooth(std::vector<T> x, size_t num_iterations) -> std::vector<T> {
+  const T weight = 0.25;
+  for (size_t iter = 0; iter < num_iterations; ++iter) {
+    std::vector<T> next(x.size());
+    next.front() = x.front();
+    next.back()  = x.back();
+    for (size_t i = 1; i + 1 < x.size(); ++i) {
+      next[i] = x[i] + weight * (x[i - 1] - x[i] - x[i] + x[i + 1]) + sin(x[i]) * weight;
+    }
+    x = std::move(next);
+  }
+  return x;
+}
+
+// Usage: example_incremental_evaluator [n]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  const size_t n              = argc > 1 ? std::stoul(argv[1]) : 10'000ul;
+  constexpr size_t iterations = 10;
+  constexpr int repetitions   = 100;
+
+  std::vector<RType> x(n);
+  std::vector<PassiveType> inputs(n);
+  for (size_t i = 0; i < n; ++i) {
+    inputs[i] = std::cos(static_cast<PassiveType>(i));
+    x[i]      = inputs[i];
+  }
+
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  RT::register_variable(x, graph);
+  { [[maybe_unused]] const auto y = smooth(x, iterations); }
+
+  RT::Evaluator<PassiveType> eval(*graph);
+  RT::IncrementalEvaluator<PassiveType> inc_eval(*graph);
+
+  // What-if analysis: change one input at a time
+  const auto begin_full = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < repetitions; ++rep) {
+    inputs[n / 2] += 0.01;
+    eval.evaluate(inputs);
+  }
+  const auto end_full = std::chrono::steady_clock::now();
+
+  size_t num_touched = 0;
+  const auto begin_inc = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < repetitions; ++rep) {
+    inputs[n / 2] += 0.01;
+    inc_eval.set_input(n / 2, inputs[n / 2]);
+    num_touched += inc_eval.update();
+  }
+  const auto end_inc = std::chrono::steady_clock::now();
+
+  const auto full_time = std::chrono::duration<double>(end_full - begin_full).count() / repetitions;
+  const auto inc_time  = std::chrono::duration<double>(end_inc - begin_inc).count() / repetitions;
+
+  std::cout << "Change of a single input of a graph with " << graph->operations().size()
+            << " nodes\n";
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << "  Full replay:        " << full_time << " s\n";
+  std::cout << "  Incremental update: " << inc_time << " s, " << num_touched / repetitions
+            << " touched nodes, speedup " << std::fixed << std::setprecision(1)
+            << full_time / inc_time << '\n';
+}
@@ -69,8 +69,8 @@ auto main() -> int {
 
   try {
     const std::string filename{"python/llt.py"};
-    RT::to_python(graph.get(), filename);
-    std::cout << "Wrote Graph code to `" << filename << "`.\n";
+    RT::to_python(graph.get(), filename, true);
+    std::cout << "Wrote Graph code and its adjoint to `" << filename << "`.\n";
   } catch (const std::exception& e) {
     std::cerr << "[ERROR] " << e.what() << '\n';
     std::exit(1);
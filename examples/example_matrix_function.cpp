@@ -25,5 +25,10 @@ auto main() -> int {
 
   RType res = f(x, y);
 
+  std::cout << "Number of operations: " << g->count_ops() << '\n';
+  std::cout << "  Number ADD:  " << g->count_op(RT::NodeType::ADD) << '\n';
+  std::cout << "  Number GEMM: " << g->count_op(RT::NodeType::GEMM) << '\n';
+  std::cout << "Number of FLOPs: " << g->count_flops() << '\n';
+
   save_to_dot(__FILE__, g.get());
 }
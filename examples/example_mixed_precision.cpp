@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DoubleDouble.hpp"
+#include "MixedPrecisionEvaluator.hpp"
+#include "RecordType.hpp"
+
+// Explicit steps of a stencil code, the rounding errors accumulate over the iterations
+template <typename T>
+[[nodiscard]] auto smooth(std::vector<T> x, size_t num_iterations) -> std::vector<T> {
+  const T weight = 0.25;
+  for (size_t iter = 0; iter < num_iterations; ++iter) {
+    std::vector<T> next(x.size());
+    next.front() = x.front();
+    next.back()  = x.back();
+    for (size_t i = 1; i + 1 < x.size(); ++i) {
+      next[i] = x[i] + weight * (x[i - 1] - x[i] - x[i] + x[i + 1]) + sin(x[i]) * weight;
+    }
+    x = std::move(next);
+  }
+  return x;
+}
+
+template <typename ReplayType, typename PassiveType, typename ReferenceType>
+void report(const std::string& name, const RT::Graph<PassiveType>& graph,
+            const std::vector<ReferenceType>& reference) {
+  RT::MixedPrecisionEvaluator<ReplayType, PassiveType> eval(graph);
+
+  constexpr int repetitions = 10;
+  const auto begin          = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < repetitions; ++rep) {
+    eval.evaluate();
+  }
+  const auto end  = std::chrono::steady_clock::now();
+  const auto time = std::chrono::duration<double>(end - begin).count() / repetitions;
+
+  const auto stats = eval.error_statistics(reference);
+  std::cout << "  " << std::left << std::setw(14) << name << std::right << std::scientific
+            << std::setprecision(3) << time << " s, max relative error " << stats.max_relative_error
+            << ", mean relative error " << stats.mean_relative_error << ", violated guards "
+            << eval.violated_guards().size() << '\n';
+}
+
+// Usage: example_mixed_precision [n]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  const size_t n              = argc > 1 ? std::stoul(argv[1]) : 10'000ul;
+  constexpr size_t iterations = 20;
+
+  std::vector<RType> x(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = std::cos(static_cast<PassiveType>(i));
+  }
+
+  // Record once in double ...
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  RT::register_variable(x, graph);
+  { [[maybe_unused]] const auto y = smooth(x, iterations); }
+
+  // ... and replay in double-double as reference
+  RT::MixedPrecisionEvaluator<RT::DoubleDouble, PassiveType> reference(*graph);
+  reference.evaluate();
+
+  std::cout << "Replay of a graph with " << graph->operations().size()
+            << " nodes against a double-double reference\n";
+  report<float>("float", *graph, reference.values());
+  report<double>("double", *graph, reference.values());
+  report<long double>("long double", *graph, reference.values());
+  report<RT::DoubleDouble>("double-double", *graph, reference.values());
+}
@@ -0,0 +1,83 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Evaluator.hpp"
+#include "ParallelEvaluator.hpp"
+#include "RecordType.hpp"
+
+// Matrix product of two (n x n) matrices stored in row major order
+template <typename T>
+[[nodiscard]] auto matmul(const std::vector<T>& A, const std::vector<T>& B, size_t n)
+    -> std::vector<T> {
+  std::vector<T> C(n * n);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      T sum = A[i * n] * B[j];
+      for (size_t k = 1; k < n; ++k) {
+        sum += A[i * n + k] * B[k * n + j];
+      }
+      C[i * n + j] = sum;
+    }
+  }
+  return C;
+}
+
+template <typename Eval>
+[[nodiscard]] auto time_evaluate(Eval& eval, const std::vector<double>& inputs, int repetitions)
+    -> double {
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i) {
+    eval.evaluate(inputs);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - begin).count() / static_cast<double>(repetitions);
+}
+
+// Usage: example_parallel_evaluator [n] [max_threads]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  // A traced (n x n) matrix product has about 4n^3 nodes, a (1000 x 1000) product does not fit
+  // into memory, therefore the default size is smaller
+  const size_t n           = argc > 1 ? std::stoul(argv[1]) : 96ul;
+  const size_t max_threads = argc > 2 ? std::stoul(argv[2])
+                                      : std::max(std::thread::hardware_concurrency(), 1u);
+  constexpr int repetitions = 5;
+
+  std::vector<RType> A(n * n);
+  std::vector<RType> B(n * n);
+  for (size_t i = 0; i < n * n; ++i) {
+    A[i] = static_cast<PassiveType>(i % 13);
+    B[i] = static_cast<PassiveType>(i % 7);
+  }
+
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  RT::register_variable(A, graph);
+  RT::register_variable(B, graph);
+  { [[maybe_unused]] const auto C = matmul(A, B, n); }
+
+  std::vector<PassiveType> inputs(2 * n * n);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i] = 1.0 / static_cast<PassiveType>(i + 1);
+  }
+
+  RT::Evaluator<PassiveType> seq_eval(*graph);
+  const auto seq_time = time_evaluate(seq_eval, inputs, repetitions);
+
+  std::cout << "Replay of (" << n << " x " << n << ") matrix product with "
+            << graph->operations().size() << " nodes\n";
+  std::cout << std::setw(12) << "sequential" << ": " << std::fixed << std::setprecision(4)
+            << seq_time << " s\n";
+  for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    RT::ParallelEvaluator<PassiveType> par_eval(*graph, num_threads);
+    const auto par_time = time_evaluate(par_eval, inputs, repetitions);
+    std::cout << std::setw(4) << num_threads << " threads: " << par_time
+              << " s, speedup " << std::setprecision(2) << seq_time / par_time
+              << std::setprecision(4) << " (" << par_eval.num_levels() << " levels)\n";
+  }
+}
@@ -0,0 +1,84 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "Bytecode.hpp"
+#include "RecordType.hpp"
+#include "StaticGraph.hpp"
+
+// Same kernel as `example_AAD_112`
+template <typename T>
+[[nodiscard]] constexpr auto f(std::array<T, 2> v) -> std::array<T, 2> {
+  const T u = v[0] * v[0] * v[1] * v[1];
+  v[0]      = std::sin(u);
+  v[1]      = v[1] * u;
+  return v;
+}
+
+// Recorded once at compile time
+constexpr auto static_graph = RT::record_static<double, 2>([](const auto& v) { return f(v); });
+
+[[nodiscard]] constexpr auto input(size_t e) noexcept -> std::array<double, 2> {
+  const auto x = 0.5 + 1e-6 * static_cast<double>(e);
+  return {x, 1.0 - 0.5 * x};
+}
+
+// Nanoseconds per evaluation, the checksum keeps the compiler from removing the evaluations
+template <typename Function>
+[[nodiscard]] auto benchmark(size_t num_evaluations, const Function& eval) -> double {
+  double checksum  = 0.0;
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t e = 0; e < num_evaluations; ++e) {
+    const auto result = eval(input(e));
+    checksum += result[0] + result[1];
+  }
+  const auto end = std::chrono::steady_clock::now();
+  if (!std::isfinite(checksum)) {
+    std::cerr << "Checksum is not finite.\n";
+  }
+  return std::chrono::duration<double, std::nano>(end - begin).count() /
+         static_cast<double>(num_evaluations);
+}
+
+// Usage: example_static_graph [num_evaluations]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  const size_t num_evaluations = argc > 1 ? std::stoul(argv[1]) : 10'000'000ul;
+
+  // Same kernel recorded at runtime and replayed by the bytecode interpreter
+  std::array<RType, 2> v{1.0, 2.0};
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  RT::register_variable(v, graph);
+  const auto w = f(v);
+  RT::BytecodeInterpreter<PassiveType> interpreter(*graph, std::array{w[0].id(), w[1].id()});
+
+  const auto replay = [&](const std::array<PassiveType, 2>& x) {
+    interpreter.evaluate(x);
+    return std::array{interpreter.output(0), interpreter.output(1)};
+  };
+
+  // The static graph reproduces the hand-written function exactly
+  bool correct = true;
+  for (size_t e = 0; e < num_evaluations; e += 997) {
+    const auto expected = f(input(e));
+    correct             = correct && RT::static_evaluate<static_graph>(input(e)) == expected &&
+              replay(input(e)) == expected;
+  }
+
+  const auto hand_time     = benchmark(num_evaluations, f<PassiveType>);
+  const auto static_time   = benchmark(num_evaluations, RT::static_evaluate<static_graph>);
+  const auto bytecode_time = benchmark(num_evaluations, replay);
+
+  std::cout << num_evaluations << " evaluations of a kernel with " << static_graph.num_nodes
+            << " nodes\n";
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  Hand-written function: " << hand_time << " ns per evaluation\n";
+  std::cout << "  Static graph:          " << static_time << " ns per evaluation\n";
+  std::cout << "  Bytecode interpreter:  " << bytecode_time << " ns per evaluation\n";
+  std::cout << "  Results agree:         " << std::boolalpha << correct << '\n';
+}
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Bytecode.hpp"
+#include "RecordType.hpp"
+#include "StreamingEvaluator.hpp"
+
+// Usage: example_streaming_evaluator [n] [num_steps] [chunk_size]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  const size_t n          = argc > 1 ? std::stoul(argv[1]) : 1'000ul;
+  const size_t num_steps  = argc > 2 ? std::stoul(argv[2]) : 200ul;
+  const size_t chunk_size = argc > 3 ? std::stoul(argv[3]) : 1ul << 14ul;
+
+  // Time stepping of a nonlinear diffusion, only two time levels are live at any time
+  std::vector<RType> u(n);
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  for (size_t i = 0; i < n; ++i) {
+    u[i] = std::sin(static_cast<PassiveType>(i) * 0.01);
+    u[i].register_graph(graph);
+  }
+  for (size_t step = 0; step < num_steps; ++step) {
+    std::vector<RType> next(n);
+    for (size_t i = 0; i < n; ++i) {
+      const RType& left  = u[i == 0 ? 0 : i - 1];
+      const RType& right = u[i + 1 == n ? i : i + 1];
+      next[i]            = u[i] + 0.1 * (left - 2.0 * u[i] + right) - 0.01 * u[i] * u[i] * u[i];
+    }
+    u = std::move(next);
+  }
+
+  std::vector<int64_t> outputs{};
+  for (const auto& ui : u) {
+    outputs.push_back(ui.id());
+  }
+  std::vector<PassiveType> inputs(n);
+  for (size_t i = 0; i < n; ++i) {
+    inputs[i] = std::cos(static_cast<PassiveType>(i) * 0.01);
+  }
+
+  const auto bytecode = RT::compile(*graph, outputs);
+  const auto file = std::filesystem::temp_directory_path() / "example_streaming_evaluator.rtbc";
+  RT::save_bytecode(bytecode, file, chunk_size);
+  graph.reset();
+
+  RT::BytecodeInterpreter<PassiveType> interpreter(bytecode);
+  const auto begin_interpreter = std::chrono::steady_clock::now();
+  interpreter.evaluate(inputs);
+  const auto end_interpreter = std::chrono::steady_clock::now();
+
+  RT::StreamingEvaluator<PassiveType> stream(file);
+  const auto begin_stream = std::chrono::steady_clock::now();
+  stream.evaluate(inputs);
+  const auto end_stream = std::chrono::steady_clock::now();
+
+  bool correct = true;
+  for (size_t o = 0; o < outputs.size(); ++o) {
+    correct = correct && stream.output(o) == interpreter.output(o);
+  }
+
+  std::cout << num_steps << " time steps on " << n << " points, " << bytecode.code.size()
+            << " instructions in " << stream.num_chunks() << " chunks\n";
+  std::cout << "  File size:                  " << std::filesystem::file_size(file) << " bytes\n";
+  std::cout << "  Resident bytecode:          " << bytecode.working_set_size() << " bytes\n";
+  std::cout << "  Resident while streaming:   " << stream.resident_size() << " bytes\n";
+  std::cout << std::scientific << std::setprecision(3);
+  std::cout << "  Bytecode interpreter:       "
+            << std::chrono::duration<double>(end_interpreter - begin_interpreter).count() << " s\n";
+  std::cout << "  Streaming evaluator:        "
+            << std::chrono::duration<double>(end_stream - begin_stream).count() << " s\n";
+  std::cout << "  Matches interpreter:        " << std::boolalpha << correct << '\n';
+
+  std::filesystem::remove(file);
+}
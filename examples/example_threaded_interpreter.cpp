@@ -0,0 +1,106 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "Bytecode.hpp"
+#include "RecordType.hpp"
+#include "ThreadedInterpreter.hpp"
+
+using PassiveType = double;
+using RType       = RT::RecordType<PassiveType>;
+
+struct TracedGraph {
+  std::string name;
+  std::shared_ptr<RT::Graph<PassiveType>> graph;
+  std::vector<int64_t> outputs{};
+  std::vector<PassiveType> inputs{};
+};
+
+// - Record an Eigen computation on an (n x n) input matrix ----------------------------------------
+template <typename Func>
+[[nodiscard]] auto trace(const std::string& name, Eigen::Index n, const Func& func)
+    -> TracedGraph {
+  TracedGraph traced{.name = name, .graph = std::make_shared<RT::Graph<PassiveType>>()};
+  Eigen::MatrixX<RType> A(n, n);
+  for (Eigen::Index j = 0; j < n; ++j) {
+    for (Eigen::Index i = 0; i < n; ++i) {
+      const auto diagonal = i == j ? static_cast<PassiveType>(n) : 0.0;
+      const auto value    = 1.0 / static_cast<PassiveType>(i + j + 1) + diagonal;
+      A(i, j)             = value;
+      A(i, j).register_graph(traced.graph);
+      traced.inputs.push_back(value);
+    }
+  }
+
+  const Eigen::MatrixX<RType> res = func(A);
+  for (const auto& r : res.reshaped()) {
+    traced.outputs.push_back(r.id());
+  }
+  return traced;
+}
+
+template <typename Interpreter>
+[[nodiscard]] auto time_evaluate(Interpreter& interpreter,
+                                 const std::vector<PassiveType>& inputs,
+                                 int repetitions) -> double {
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i) {
+    interpreter.evaluate(inputs);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - begin).count() / static_cast<double>(repetitions);
+}
+
+// Usage: example_threaded_interpreter [n]
+auto main(int argc, char** argv) -> int {
+  const Eigen::Index n      = argc > 1 ? std::stol(argv[1]) : 40;
+  constexpr int repetitions = 50;
+
+  const std::vector<TracedGraph> graphs{
+      trace("Matrix product",
+            n,
+            [](const Eigen::MatrixX<RType>& A) -> Eigen::MatrixX<RType> { return A * A; }),
+      trace("LLT solve",
+            n,
+            [n](const Eigen::MatrixX<RType>& A) -> Eigen::MatrixX<RType> {
+              return A.llt().solve(Eigen::MatrixX<RType>::Identity(n, n));
+            }),
+  };
+
+  std::cout << std::fixed << std::setprecision(3);
+  for (const auto& traced : graphs) {
+    const auto bytecode = RT::compile(*traced.graph, traced.outputs);
+    std::cout << traced.name << " (" << n << " x " << n << "): " << bytecode.code.size()
+              << " instructions\n";
+
+    std::cout << "  Most frequent dependent op pairs:";
+    const auto pairs = RT::profile_op_pairs(bytecode);
+    for (size_t i = 0; i < std::min(pairs.size(), 3ul); ++i) {
+      std::cout << ' ' << pairs[i].first << "->" << pairs[i].second << " (" << pairs[i].count
+                << ')';
+    }
+    std::cout << '\n';
+
+    RT::ThreadedInterpreter<PassiveType> switch_dispatch(
+        bytecode, {.superinstructions = false, .computed_goto = false});
+    const auto switch_time = time_evaluate(switch_dispatch, traced.inputs, repetitions);
+    std::cout << std::left << std::setw(32) << "  Switch dispatch:" << switch_time * 1e3 << " ms\n";
+
+    for (bool superinstructions : {false, true}) {
+      RT::ThreadedInterpreter<PassiveType> threaded(
+          bytecode, {.superinstructions = superinstructions, .computed_goto = true});
+      const auto time = time_evaluate(threaded, traced.inputs, repetitions);
+      std::cout << std::setw(32)
+                << (superinstructions ? "  Threaded + superinstructions:" : "  Threaded:")
+                << time * 1e3 << " ms, speedup " << switch_time / time;
+      if (superinstructions) {
+        std::cout << " (" << threaded.num_superinstructions() << " fused)";
+      }
+      std::cout << '\n';
+    }
+  }
+}
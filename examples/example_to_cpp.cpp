@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "RecordType.hpp"
+#include "ThreadedInterpreter.hpp"
+#include "ToCpp.hpp"
+
+// Explicit time stepping of a 1D heat equation with a logistic source term, only arithmetic
+// operations such that the compiler can vectorize the replay over independent lanes
+template <typename T>
+[[nodiscard]] auto heat(std::vector<T> u, size_t num_steps) -> std::vector<T> {
+  const T dt  = 0.2;
+  const T k   = 0.05;
+  const T one = 1.0;
+  for (size_t step = 0; step < num_steps; ++step) {
+    std::vector<T> next(u.size());
+    next.front() = u.front();
+    next.back()  = u.back();
+    for (size_t i = 1; i + 1 < u.size(); ++i) {
+      next[i] = u[i] + dt * (u[i - 1] - u[i] - u[i] + u[i + 1]) + k * u[i] * (one - u[i]);
+    }
+    u = std::move(next);
+  }
+  return u;
+}
+
+template <typename Func>
+[[nodiscard]] auto time_per_call(const Func& func, int repetitions) -> double {
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i) {
+    func();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - begin).count() / static_cast<double>(repetitions);
+}
+
+// Usage: example_to_cpp [n] [num_steps] [num_lanes]
+auto main(int argc, char** argv) -> int {
+  using PassiveType = double;
+  using RType       = RT::RecordType<PassiveType>;
+
+  const size_t n            = argc > 1 ? std::stoul(argv[1]) : 50ul;
+  const size_t num_steps    = argc > 2 ? std::stoul(argv[2]) : 20ul;
+  const size_t num_lanes    = argc > 3 ? std::stoul(argv[3]) : 64ul;
+  constexpr int repetitions = 20;
+
+  std::vector<RType> u(n);
+  std::vector<PassiveType> inputs(n);
+  for (size_t i = 0; i < n; ++i) {
+    const auto t = static_cast<PassiveType>(i) / static_cast<PassiveType>(n);
+    inputs[i]    = std::sin(std::numbers::pi * t);
+    u[i]         = inputs[i];
+  }
+
+  auto graph = std::make_shared<RT::Graph<PassiveType>>();
+  RT::register_variable(u, graph);
+  std::vector<int64_t> outputs{};
+  {
+    const auto res = heat(u, num_steps);
+    for (const auto& r : res) {
+      outputs.push_back(r.id());
+    }
+  }
+
+  RT::ThreadedInterpreter<PassiveType> interpreter(*graph, outputs);
+
+  const auto compile_begin = std::chrono::steady_clock::now();
+  try {
+    const RT::CompiledFunction<PassiveType> compiled(*graph, outputs);
+    const auto compile_end = std::chrono::steady_clock::now();
+
+    // Single replay
+    std::vector<PassiveType> values(n);
+    const auto interpreter_time =
+        time_per_call([&] { interpreter.evaluate(inputs); }, repetitions);
+    const auto native_time =
+        time_per_call([&] { compiled.evaluate(inputs, values); }, repetitions);
+
+    double max_diff = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      max_diff = std::max(max_diff, std::abs(values[i] - interpreter.output(i)));
+    }
+
+    // Independent replays with perturbed inputs, input `i` of lane `l` at `i * num_lanes + l`
+    std::vector<PassiveType> batch_inputs(n * num_lanes);
+    std::vector<PassiveType> batch_outputs(n * num_lanes);
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t l = 0; l < num_lanes; ++l) {
+        batch_inputs[i * num_lanes + l] = inputs[i] * (1.0 + 1e-3 * static_cast<double>(l));
+      }
+    }
+    const auto batch_time = time_per_call(
+        [&] { compiled.evaluate(batch_inputs, batch_outputs, num_lanes); }, repetitions);
+
+    std::cout << "Replay of " << num_steps << " steps of a heat equation with " << n
+              << " points, " << graph->operations().size() << " nodes\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  Compile time:         "
+              << std::chrono::duration<double>(compile_end - compile_begin).count() << " s\n";
+    std::cout << "  Threaded interpreter: " << interpreter_time * 1e3 << " ms\n";
+    std::cout << "  Native:               " << native_time * 1e3 << " ms, speedup "
+              << interpreter_time / native_time << '\n';
+    std::cout << "  Native, " << num_lanes << " lanes:     "
+              << batch_time / static_cast<double>(num_lanes) * 1e3 << " ms per lane, speedup "
+              << interpreter_time * static_cast<double>(num_lanes) / batch_time << '\n';
+    std::cout << "  Max. difference: " << std::scientific << max_diff << '\n';
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+}
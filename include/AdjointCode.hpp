@@ -0,0 +1,156 @@
+#ifndef RT_ADJOINT_CODE_HPP_
+#define RT_ADJOINT_CODE_HPP_
+
+#include <cstdint>
+#include <set>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CustomOp.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+
+namespace RT {
+
+namespace detail {
+
+enum class CodeLanguage { CPP, PYTHON };
+
+// - Straight-line code of a reverse sweep ---------------------------------------------------------
+struct AdjointCode {
+  std::vector<std::string> statements{};
+  std::vector<bool> has_adjoint{};      // Node is reached by the sweep, its adjoint is `a<id>`
+  std::set<int64_t> used_custom_ops{};  // Require a user defined `<name>_derivative`
+};
+
+// - Generate the reverse sweep of a tape ----------------------------------------------------------
+// Emits the same accumulations as `reverse_sweep`, in the same order, such that the generated code
+// reproduces `gradient`. The value of node `id` is the variable `v<representative[id]>` and its
+// adjoint is `a<representative[id]>`; copies are differentiated through their representative. The
+// adjoints start with `seeds`, pairs of a node and an expression for its seed, and only `live`
+// nodes are differentiated. Adjoint variables are declared on their first write.
+template <typename PassiveType>
+[[nodiscard]] auto adjoint_code(const Tape<PassiveType>& tape,
+                                const std::vector<bool>& live,
+                                std::span<const size_t> representative,
+                                std::span<const std::pair<int64_t, std::string>> seeds,
+                                CodeLanguage language) -> AdjointCode {
+  static_assert(std::is_floating_point_v<PassiveType>,
+                "Derivatives require a floating point type as `PassiveType`.");
+  using namespace std::string_literals;
+
+  const bool is_cpp   = language == CodeLanguage::CPP;
+  const auto end      = is_cpp ? ";"s : ""s;
+  const auto one      = is_cpp ? "static_cast<T>(1)"s : "1.0"s;
+  const auto two      = is_cpp ? "static_cast<T>(2)"s : "2.0"s;
+  const auto zero     = is_cpp ? "static_cast<T>(0)"s : "0"s;
+  const auto as_value = is_cpp ? "static_cast<T>("s : "float("s;
+  const auto math     = is_cpp ? "std::"s : "math."s;
+
+  const auto rep = [&](int64_t id) { return representative[static_cast<size_t>(id)]; };
+  const auto var = [&](int64_t id) { return "v"s + std::to_string(rep(id)); };
+
+  AdjointCode code{.has_adjoint = std::vector<bool>(tape.num_nodes(), false)};
+  const auto accumulate = [&](int64_t id, const std::string& contribution) {
+    const auto idx  = rep(id);
+    const auto name = "a"s + std::to_string(idx);
+    if (code.has_adjoint[idx]) {
+      code.statements.push_back(name + " += "s + contribution + end);
+    } else {
+      code.has_adjoint[idx] = true;
+      code.statements.push_back((is_cpp ? "T "s : ""s) + name + " = "s + contribution + end);
+    }
+  };
+
+  for (const auto& [id, seed] : seeds) {
+    accumulate(id, seed);
+  }
+
+  for (auto id = static_cast<int64_t>(tape.num_nodes()) - 1; id >= 0; --id) {
+    const auto idx  = static_cast<size_t>(id);
+    const auto args = tape.args(id);
+    if (!live[idx] || representative[idx] != idx || !code.has_adjoint[idx] || args.empty()) {
+      continue;
+    }
+
+    const auto adj    = "a"s + std::to_string(idx);
+    const auto scaled = [&](const std::string& partial) { return adj + " * ("s + partial + ")"s; };
+    switch (tape.op(id)) {
+      case NodeType::LITERAL:
+      case NodeType::VAR:
+      case NodeType::ADD:
+      case NodeType::SUM:
+        for (auto arg : args) {
+          accumulate(arg, adj);
+        }
+        break;
+      case NodeType::SUB:
+        accumulate(args[0], adj);
+        accumulate(args[1], "-"s + adj);
+        break;
+      case NodeType::NEG:
+        accumulate(args[0], "-"s + adj);
+        break;
+      case NodeType::MUL:
+        accumulate(args[0], adj + " * "s + var(args[1]));
+        accumulate(args[1], adj + " * "s + var(args[0]));
+        break;
+      case NodeType::INV:
+        accumulate(args[0], scaled("-"s + var(id) + " * "s + var(id)));
+        break;
+      case NodeType::SQRT:
+        accumulate(args[0], scaled(one + " / ("s + two + " * "s + var(id) + ")"s));
+        break;
+      case NodeType::SIN:
+        accumulate(args[0], scaled(math + "cos("s + var(args[0]) + ")"s));
+        break;
+      case NodeType::COS:
+        accumulate(args[0], scaled("-"s + math + "sin("s + var(args[0]) + ")"s));
+        break;
+      case NodeType::CMP:
+      case NodeType::GUARD:
+        break;
+      case NodeType::SELECT:
+        accumulate(args[1], scaled(as_value + var(args[0]) + " != "s + zero + ")"s));
+        accumulate(args[2], scaled(as_value + var(args[0]) + " == "s + zero + ")"s));
+        break;
+      case NodeType::DOT:
+        {
+          const auto n = args.size() / 2;
+          for (size_t i = 0; i < args.size(); ++i) {
+            accumulate(args[i], adj + " * "s + var(args[i < n ? i + n : i - n]));
+          }
+        }
+        break;
+      case NodeType::CUSTOM:
+        {
+          const auto op_id = tape.attribute(id);
+          code.used_custom_ops.insert(op_id);
+          std::string arg_list{};
+          for (auto arg : args) {
+            arg_list += ", "s + var(arg);
+          }
+          for (size_t i = 0; i < args.size(); ++i) {
+            accumulate(args[i],
+                       scaled(CustomOpRegistry<PassiveType>::get(op_id).name + "_derivative("s +
+                              std::to_string(i) + arg_list + ")"s));
+          }
+        }
+        break;
+      default:
+        RT_PANIC("Operation " << tape.op(id) << " is not differentiable.");
+    }
+  }
+
+  return code;
+}
+
+}  // namespace detail
+
+}  // namespace RT
+
+#endif  // RT_ADJOINT_CODE_HPP_
@@ -0,0 +1,372 @@
+#ifndef RT_ASYNC_EVALUATOR_HPP_
+#define RT_ASYNC_EVALUATOR_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+namespace RT {
+
+// - Replay independent parts of a graph asynchronously --------------------------------------------
+// The outputs are grouped into blocks of `block_size` consecutive outputs, e.g. the columns of a
+// matrix. The nodes needed for the outputs are split into tasks: the nodes that only a single block
+// depends on form the cone of this block, the nodes that several blocks depend on are split into
+// weakly connected components. A cone can only depend on shared components and the shared
+// components are independent of each other, so all components run concurrently and every cone
+// starts as soon as the components it reads are finished. `evaluate_async` returns one future per
+// output that is ready as soon as the task computing the output is finished, e.g. the columns of
+// an inverse can be consumed one by one instead of after the whole tape. The guards of the graph
+// and the nodes only they depend on form one additional task.
+//
+// The tasks run on a pool of `num_threads` threads owned by the evaluator. The partition is
+// computed once in the constructor and reused for every evaluation.
+template <typename PassiveType>
+class AsyncEvaluator {
+  static_assert(!is_matrix_type_v<PassiveType>, "Asynchronous replay requires a scalar type.");
+
+  static constexpr int64_t UNREACHED = -1;
+  static constexpr int64_t SHARED    = -2;
+
+  Tape<PassiveType> m_tape;
+  std::vector<int64_t> m_outputs;
+  size_t m_block_size;
+  std::vector<PassiveType> m_values{};  // In slot order
+  std::vector<size_t> m_slots{};        // Slot of every node
+
+  // The nodes of task `t` are the slots `m_task_offsets[t]` (inclusive) to `m_task_offsets[t + 1]`
+  // (exclusive). Values, operations and arguments are stored in slot order, i.e. a task reads and
+  // writes contiguous memory instead of jumping through the tape.
+  std::vector<size_t> m_task_offsets{0ul};
+  std::vector<int64_t> m_task_nodes{};  // Node of every slot of a task
+  std::vector<NodeType> m_ops{};
+  std::vector<int64_t> m_attributes{};
+  std::vector<size_t> m_arg_offsets{0ul};
+  std::vector<size_t> m_args{};  // Slots of the arguments
+  std::vector<std::vector<size_t>> m_dependents{};  // Tasks waiting for task `t`
+  std::vector<size_t> m_num_dependencies{};
+  std::vector<std::vector<size_t>> m_task_outputs{};  // Outputs computed by task `t`
+
+  // State of the current evaluation, protected by `m_mutex`
+  std::mutex m_mutex;
+  std::condition_variable m_ready_cv;
+  std::condition_variable m_done_cv;
+  std::deque<size_t> m_ready{};
+  std::vector<size_t> m_remaining_dependencies{};
+  size_t m_remaining_tasks = 0;
+  std::vector<std::promise<PassiveType>> m_promises{};
+  std::vector<int64_t> m_violated_guards{};
+  bool m_stop = false;
+
+  std::vector<std::jthread> m_workers{};
+
+  // Splits the cones of the outputs into tasks
+  void partition() {
+    const auto num_nodes = m_tape.num_nodes();
+
+    // Block of outputs that depends on a node, `SHARED` if several blocks depend on it. All nodes
+    // that read a node have a larger id, i.e. a single backward pass is sufficient.
+    std::vector<int64_t> owner(num_nodes, UNREACHED);
+    const auto merge = [](int64_t& node_owner, int64_t new_owner) {
+      node_owner = node_owner == UNREACHED || node_owner == new_owner ? new_owner : SHARED;
+    };
+    for (size_t o = 0; o < m_outputs.size(); ++o) {
+      RT_ASSERT(m_outputs[o] >= 0 && static_cast<size_t>(m_outputs[o]) < num_nodes,
+                "Node with id " << m_outputs[o] << " is not part of the graph.");
+      merge(owner[static_cast<size_t>(m_outputs[o])], static_cast<int64_t>(o / m_block_size));
+    }
+    // Guards are not read by any node, all guards form one additional block after the outputs
+    const auto num_blocks = (m_outputs.size() + m_block_size - 1ul) / m_block_size;
+    bool has_guards       = false;
+    for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+      if (m_tape.op(id) == NodeType::GUARD) {
+        merge(owner[static_cast<size_t>(id)], static_cast<int64_t>(num_blocks));
+        has_guards = true;
+      }
+    }
+    for (auto id = static_cast<int64_t>(num_nodes) - 1; id >= 0; --id) {
+      const auto node_owner = owner[static_cast<size_t>(id)];
+      if (node_owner == UNREACHED) {
+        continue;
+      }
+      for (auto arg : m_tape.args(id)) {
+        merge(owner[static_cast<size_t>(arg)], node_owner);
+      }
+    }
+
+    // Weakly connected components of the shared nodes, the arguments of a shared node are shared.
+    // Inputs and constants are not evaluated and do not connect the nodes that read them.
+    std::vector<size_t> parent(num_nodes);
+    std::iota(std::begin(parent), std::end(parent), 0ul);
+    const auto find = [&](size_t idx) {
+      while (parent[idx] != idx) {
+        parent[idx] = parent[parent[idx]];
+        idx         = parent[idx];
+      }
+      return idx;
+    };
+    for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+      if (owner[static_cast<size_t>(id)] != SHARED) {
+        continue;
+      }
+      for (auto arg : m_tape.args(id)) {
+        if (m_tape.args(arg).empty()) {
+          continue;
+        }
+        const auto a           = find(static_cast<size_t>(arg));
+        const auto b           = find(static_cast<size_t>(id));
+        parent[std::max(a, b)] = std::min(a, b);
+      }
+    }
+
+    // Task of every node: shared components first, then one cone per block
+    constexpr auto NO_TASK = static_cast<size_t>(-1);
+    std::vector<size_t> component_task(num_nodes, NO_TASK);
+    std::vector<size_t> node_task(num_nodes, NO_TASK);
+    size_t num_tasks = 0;
+    for (size_t idx = 0; idx < num_nodes; ++idx) {
+      if (owner[idx] == SHARED && !m_tape.args(static_cast<int64_t>(idx)).empty()) {
+        auto& task     = component_task[find(idx)];
+        task           = task == NO_TASK ? num_tasks++ : task;
+        node_task[idx] = task;
+      }
+    }
+    const auto num_shared_tasks = num_tasks;
+    for (size_t idx = 0; idx < num_nodes; ++idx) {
+      if (owner[idx] >= 0) {
+        node_task[idx] = num_shared_tasks + static_cast<size_t>(owner[idx]);
+      }
+    }
+    num_tasks += num_blocks + (has_guards ? 1ul : 0ul);
+
+    // Nodes in topological order and dependencies between the tasks
+    std::vector<std::vector<int64_t>> nodes(num_tasks);
+    m_dependents.assign(num_tasks, {});
+    m_num_dependencies.assign(num_tasks, 0ul);
+    for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+      const auto task = node_task[static_cast<size_t>(id)];
+      const auto args = m_tape.args(id);
+      if (task == NO_TASK || args.empty()) {
+        continue;
+      }
+      nodes[task].push_back(id);
+      for (auto arg : args) {
+        const auto arg_task = node_task[static_cast<size_t>(arg)];
+        if (arg_task != task && arg_task != NO_TASK) {
+          m_dependents[arg_task].push_back(task);
+        }
+      }
+    }
+    for (auto& dependents : m_dependents) {
+      std::sort(std::begin(dependents), std::end(dependents));
+      dependents.erase(std::unique(std::begin(dependents), std::end(dependents)),
+                       std::end(dependents));
+      for (auto dependent : dependents) {
+        ++m_num_dependencies[dependent];
+      }
+    }
+
+    // The nodes of the tasks come first, the inputs, constants and unused nodes afterwards
+    constexpr auto NO_SLOT = static_cast<size_t>(-1);
+    m_slots.assign(num_nodes, NO_SLOT);
+    for (const auto& task_nodes : nodes) {
+      for (auto id : task_nodes) {
+        m_slots[static_cast<size_t>(id)] = m_task_nodes.size();
+        m_task_nodes.push_back(id);
+      }
+      m_task_offsets.push_back(m_task_nodes.size());
+    }
+    auto next_slot = m_task_nodes.size();
+    for (auto& slot : m_slots) {
+      slot = slot == NO_SLOT ? next_slot++ : slot;
+    }
+
+    m_values.resize(num_nodes);
+    for (size_t idx = 0; idx < num_nodes; ++idx) {
+      m_values[m_slots[idx]] = m_tape.values()[idx];
+    }
+    for (auto id : m_task_nodes) {
+      m_ops.push_back(m_tape.op(id));
+      m_attributes.push_back(m_tape.attribute(id));
+      for (auto arg : m_tape.args(id)) {
+        m_args.push_back(m_slots[static_cast<size_t>(arg)]);
+      }
+      m_arg_offsets.push_back(m_args.size());
+    }
+
+    m_task_outputs.assign(num_tasks, {});
+    for (size_t o = 0; o < m_outputs.size(); ++o) {
+      // Inputs and constants that several blocks depend on are returned with the block
+      const auto task = node_task[static_cast<size_t>(m_outputs[o])];
+      m_task_outputs[task == NO_TASK ? num_shared_tasks + o / m_block_size : task].push_back(o);
+    }
+  }
+
+  // Evaluates the nodes of `task`, returns the violated guards
+  [[nodiscard]] auto run_task(size_t task) -> std::vector<int64_t> {
+    std::vector<int64_t> violated_guards{};
+    for (auto i = m_task_offsets[task]; i < m_task_offsets[task + 1]; ++i) {
+      const auto args = std::span<const size_t>(m_args).subspan(
+          m_arg_offsets[i], m_arg_offsets[i + 1] - m_arg_offsets[i]);
+      const auto op   = m_ops[i];
+      m_values[i]     = detail::apply_operation<PassiveType>(
+          op, m_attributes[i], args.size(), [&](size_t a) -> const PassiveType& {
+            return m_values[args[a]];
+          });
+
+      if (op == NodeType::GUARD &&
+          static_cast<int64_t>(m_values[i] != static_cast<PassiveType>(0)) != m_attributes[i]) {
+        violated_guards.push_back(m_task_nodes[i]);
+      }
+    }
+    return violated_guards;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  void worker() {
+    std::unique_lock lock(m_mutex);
+    while (true) {
+      m_ready_cv.wait(lock, [&] { return m_stop || !m_ready.empty(); });
+      if (m_ready.empty()) {
+        return;
+      }
+      const auto task = m_ready.front();
+      m_ready.pop_front();
+
+      // The tasks this task depends on are finished, their values are visible via the mutex
+      lock.unlock();
+      const auto violated_guards = run_task(task);
+      for (auto o : m_task_outputs[task]) {
+        m_promises[o].set_value(m_values[m_slots[static_cast<size_t>(m_outputs[o])]]);
+      }
+      lock.lock();
+
+      m_violated_guards.insert(
+          std::end(m_violated_guards), std::cbegin(violated_guards), std::cend(violated_guards));
+      for (auto dependent : m_dependents[task]) {
+        if (--m_remaining_dependencies[dependent] == 0) {
+          m_ready.push_back(dependent);
+          m_ready_cv.notify_one();
+        }
+      }
+      if (--m_remaining_tasks == 0) {
+        m_done_cv.notify_all();
+      }
+    }
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  AsyncEvaluator(const Graph<PassiveType>& graph,
+                 std::span<const int64_t> outputs,
+                 size_t block_size  = 1ul,
+                 size_t num_threads = std::thread::hardware_concurrency())
+      : m_tape(graph),
+        m_outputs(std::cbegin(outputs), std::cend(outputs)),
+        m_block_size(block_size) {
+    RT_ASSERT(m_block_size > 0, "Blocks have to contain at least one output.");
+    partition();
+    m_workers.reserve(std::max(num_threads, 1ul));
+    for (size_t t = 0; t < std::max(num_threads, 1ul); ++t) {
+      m_workers.emplace_back([this] { worker(); });
+    }
+  }
+
+  AsyncEvaluator(const AsyncEvaluator&)                    = delete;
+  AsyncEvaluator(AsyncEvaluator&&)                         = delete;
+  auto operator=(const AsyncEvaluator&) -> AsyncEvaluator& = delete;
+  auto operator=(AsyncEvaluator&&) -> AsyncEvaluator&      = delete;
+
+  // -----------------------------------------------------------------------------------------------
+  // Finishes the current evaluation
+  ~AsyncEvaluator() noexcept {
+    wait();
+    {
+      const std::lock_guard lock(m_mutex);
+      m_stop = true;
+    }
+    m_ready_cv.notify_all();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Starts the evaluation and returns immediately, the futures are in the order of the outputs.
+  // Waits for the previous evaluation to finish first.
+  [[nodiscard]] auto evaluate_async(std::span<const PassiveType> inputs)
+      -> std::vector<std::shared_future<PassiveType>> {
+    wait();
+
+    const auto& input_ids = m_tape.inputs();
+    RT_ASSERT(inputs.size() == input_ids.size(),
+              "Expected " << input_ids.size() << " inputs, but got " << inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      m_values[m_slots[static_cast<size_t>(input_ids[i])]] = inputs[i];
+    }
+
+    std::vector<std::shared_future<PassiveType>> futures{};
+    {
+      const std::lock_guard lock(m_mutex);
+      m_promises = std::vector<std::promise<PassiveType>>(m_outputs.size());
+      futures.reserve(m_outputs.size());
+      for (auto& promise : m_promises) {
+        futures.push_back(promise.get_future().share());
+      }
+
+      m_violated_guards.clear();
+      m_remaining_dependencies = m_num_dependencies;
+      m_remaining_tasks        = num_tasks();
+      for (size_t task = 0; task < num_tasks(); ++task) {
+        if (m_num_dependencies[task] == 0) {
+          m_ready.push_back(task);
+        }
+      }
+    }
+    m_ready_cv.notify_all();
+    return futures;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Blocks until all tasks of the current evaluation are finished
+  void wait() {
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_remaining_tasks == 0; });
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Value of any node needed for the outputs, only valid after `wait`
+  [[nodiscard]] constexpr auto value(int64_t id) const noexcept -> const PassiveType& {
+    RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_slots.size(),
+              "Node with id " << id << " is not part of the graph.");
+    return m_values[m_slots[static_cast<size_t>(id)]];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Only valid after `wait`
+  [[nodiscard]] auto guards_hold() -> bool {
+    const std::lock_guard lock(m_mutex);
+    return m_violated_guards.empty();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_tasks() const noexcept -> size_t {
+    return m_task_offsets.size() - 1ul;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_threads() const noexcept -> size_t { return m_workers.size(); }
+};
+
+}  // namespace RT
+
+#endif  // RT_ASYNC_EVALUATOR_HPP_
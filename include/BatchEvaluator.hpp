@@ -0,0 +1,244 @@
+#ifndef RT_BATCH_EVALUATOR_HPP_
+#define RT_BATCH_EVALUATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+#ifndef RT_ONLY_FUNDAMENTAL
+#include <cmath>
+#endif  // RT_ONLY_FUNDAMENTAL
+
+#include "CustomOp.hpp"
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+namespace RT {
+
+// - Replay a recorded graph for `Width` input sets at once ----------------------------------------
+// The value of every node is stored as a vector of `Width` lanes, one lane per input set. Every
+// operation is dispatched once per batch and then applied to all lanes in a loop with a fixed trip
+// count that the compiler vectorizes (e.g. AVX2 or AVX-512 with `-march=native`).
+template <typename PassiveType, size_t Width = 8>
+class BatchEvaluator {
+  static_assert(!is_matrix_type_v<PassiveType>, "Batched replay requires a scalar type.");
+  static_assert(std::has_single_bit(Width), "`Width` must be a power of two.");
+
+ public:
+  struct alignas(Width * sizeof(PassiveType)) Lanes {
+    std::array<PassiveType, Width> v;
+  };
+
+ private:
+  Tape<PassiveType> m_tape;
+  std::vector<Lanes> m_values{};
+  std::array<bool, Width> m_guards_hold{};
+
+  // Apply `func(lane)` to all lanes; the result is computed in a local array such that the
+  // compiler does not need to consider aliasing with the arguments
+  template <typename Func>
+  [[nodiscard]] static constexpr auto map_lanes(const Func& func) noexcept -> Lanes {
+    Lanes res;
+    for (size_t l = 0; l < Width; ++l) {
+      res.v[l] = func(l);
+    }
+    return res;
+  }
+
+  [[nodiscard]] auto lanes_of(int64_t id) const noexcept -> const PassiveType* {
+    return m_values[static_cast<size_t>(id)].v.data();
+  }
+
+  [[nodiscard]] auto apply_operation(NodeType op, int64_t attribute, std::span<const int64_t> args)
+      -> Lanes {
+    const auto* a = lanes_of(args[0]);
+    switch (op) {
+      case NodeType::LITERAL:
+      case NodeType::VAR:
+      case NodeType::GUARD:
+        return map_lanes([&](size_t l) { return a[l]; });
+      case NodeType::ADD:
+        {
+          const auto* b = lanes_of(args[1]);
+          return map_lanes([&](size_t l) { return static_cast<PassiveType>(a[l] + b[l]); });
+        }
+      case NodeType::SUB:
+        {
+          const auto* b = lanes_of(args[1]);
+          return map_lanes([&](size_t l) { return static_cast<PassiveType>(a[l] - b[l]); });
+        }
+      case NodeType::MUL:
+        {
+          const auto* b = lanes_of(args[1]);
+          return map_lanes([&](size_t l) { return static_cast<PassiveType>(a[l] * b[l]); });
+        }
+      case NodeType::DIV:
+        {
+          const auto* b = lanes_of(args[1]);
+          for (size_t l = 0; l < Width; ++l) {
+            RT_ASSERT(b[l] != static_cast<PassiveType>(0), "Division by zero in lane " << l << '.');
+          }
+          return map_lanes([&](size_t l) { return static_cast<PassiveType>(a[l] / b[l]); });
+        }
+      case NodeType::MOD:
+        if constexpr (std::is_integral_v<PassiveType>) {
+          const auto* b = lanes_of(args[1]);
+          for (size_t l = 0; l < Width; ++l) {
+            RT_ASSERT(b[l] != static_cast<PassiveType>(0), "Division by zero in lane " << l << '.');
+          }
+          return map_lanes([&](size_t l) { return static_cast<PassiveType>(a[l] % b[l]); });
+        } else {
+          RT_PANIC("Operation MOD requires an integral type.");
+        }
+      case NodeType::INV:
+        return map_lanes(
+            [&](size_t l) { return static_cast<PassiveType>(static_cast<PassiveType>(1) / a[l]); });
+      case NodeType::NEG:
+        return map_lanes([&](size_t l) { return static_cast<PassiveType>(-a[l]); });
+#ifndef RT_ONLY_FUNDAMENTAL
+      case NodeType::SQRT:
+        return map_lanes([&](size_t l) { return static_cast<PassiveType>(std::sqrt(a[l])); });
+      case NodeType::SIN:
+        return map_lanes([&](size_t l) { return static_cast<PassiveType>(std::sin(a[l])); });
+      case NodeType::COS:
+        return map_lanes([&](size_t l) { return static_cast<PassiveType>(std::cos(a[l])); });
+#endif  // RT_ONLY_FUNDAMENTAL
+      case NodeType::CMP:
+        {
+          const auto* b  = lanes_of(args[1]);
+          const auto cmp = static_cast<ComparisonType>(attribute);
+          return map_lanes([&](size_t l) {
+            return static_cast<PassiveType>(evaluate_comparison(a[l], b[l], cmp));
+          });
+        }
+      case NodeType::SELECT:
+        {
+          const auto* t = lanes_of(args[1]);
+          const auto* f = lanes_of(args[2]);
+          return map_lanes(
+              [&](size_t l) { return a[l] != static_cast<PassiveType>(0) ? t[l] : f[l]; });
+        }
+      case NodeType::SUM:
+        {
+          Lanes res = m_values[static_cast<size_t>(args[0])];
+          for (size_t i = 1; i < args.size(); ++i) {
+            const auto* b = lanes_of(args[i]);
+            for (size_t l = 0; l < Width; ++l) {
+              res.v[l] = static_cast<PassiveType>(res.v[l] + b[l]);
+            }
+          }
+          return res;
+        }
+      case NodeType::DOT:
+        {
+          const auto n  = args.size() / 2;
+          const auto* b = lanes_of(args[n]);
+          Lanes res =
+              map_lanes([&](size_t l) { return static_cast<PassiveType>(a[l] * b[l]); });
+          for (size_t i = 1; i < n; ++i) {
+            const auto* x = lanes_of(args[i]);
+            const auto* y = lanes_of(args[n + i]);
+            for (size_t l = 0; l < Width; ++l) {
+              res.v[l] = static_cast<PassiveType>(res.v[l] + x[l] * y[l]);
+            }
+          }
+          return res;
+        }
+      case NodeType::CUSTOM:
+        {
+          // User defined kernels are scalar, they are called once per lane
+          const auto& custom = CustomOpRegistry<PassiveType>::get(attribute);
+          std::vector<PassiveType> arg_values(args.size());
+          return map_lanes([&](size_t l) {
+            for (size_t i = 0; i < args.size(); ++i) {
+              arg_values[i] = lanes_of(args[i])[l];
+            }
+            return custom.forward(arg_values);
+          });
+        }
+      default:
+        RT_PANIC("Operation " << op << " is not supported for scalar types.");
+    }
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  explicit BatchEvaluator(const Graph<PassiveType>& graph)
+      : m_tape(graph),
+        m_values(m_tape.num_nodes()) {
+    // Constants have the same value in all lanes
+    for (size_t id = 0; id < m_values.size(); ++id) {
+      m_values[id].v.fill(m_tape.values()[id]);
+    }
+    m_guards_hold.fill(true);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Input `i` of lane `l` is `inputs[i * Width + l]`
+  void evaluate(std::span<const PassiveType> inputs) {
+    const auto& input_ids = m_tape.inputs();
+    RT_ASSERT(inputs.size() == input_ids.size() * Width,
+              "Expected " << input_ids.size() * Width << " inputs, but got " << inputs.size());
+    for (size_t i = 0; i < input_ids.size(); ++i) {
+      auto& lanes = m_values[static_cast<size_t>(input_ids[i])];
+      std::copy_n(std::next(std::cbegin(inputs), static_cast<std::ptrdiff_t>(i * Width)),
+                  Width,
+                  std::begin(lanes.v));
+    }
+
+    m_guards_hold.fill(true);
+    for (int64_t id = 0; id < static_cast<int64_t>(m_tape.num_nodes()); ++id) {
+      const auto args = m_tape.args(id);
+      if (args.empty()) {
+        continue;
+      }
+
+      const auto op                     = m_tape.op(id);
+      m_values[static_cast<size_t>(id)] = apply_operation(op, m_tape.attribute(id), args);
+
+      if (op == NodeType::GUARD) {
+        const auto* outcome = lanes_of(id);
+        const auto recorded = m_tape.attribute(id) != 0;
+        for (size_t l = 0; l < Width; ++l) {
+          m_guards_hold[l] = m_guards_hold[l] &&
+                             ((outcome[l] != static_cast<PassiveType>(0)) == recorded);
+        }
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto value(int64_t id, size_t lane) const noexcept -> const PassiveType& {
+    RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_values.size(),
+              "Node with id " << id << " is not part of the graph.");
+    RT_ASSERT(lane < Width, "Lane " << lane << " is out of range, width is " << Width);
+    return m_values[static_cast<size_t>(id)].v[lane];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto lanes(int64_t id) const noexcept
+      -> std::span<const PassiveType, Width> {
+    RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_values.size(),
+              "Node with id " << id << " is not part of the graph.");
+    return m_values[static_cast<size_t>(id)].v;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // The replay of lane `lane` follows the recorded control flow only if all guards hold
+  [[nodiscard]] constexpr auto guards_hold(size_t lane) const noexcept -> bool {
+    RT_ASSERT(lane < Width, "Lane " << lane << " is out of range, width is " << Width);
+    return m_guards_hold[lane];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] static constexpr auto width() noexcept -> size_t { return Width; }
+};
+
+}  // namespace RT
+
+#endif  // RT_BATCH_EVALUATOR_HPP_
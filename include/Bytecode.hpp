@@ -0,0 +1,252 @@
+#ifndef RT_BYTECODE_HPP_
+#define RT_BYTECODE_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+namespace RT {
+
+// - Single bytecode instruction -------------------------------------------------------------------
+// Computes `op` of the registers `operands[args]` to `operands[args + num_args - 1]` and stores the
+// result in register `dst`. Instructions without arguments are loads: `VAR` loads the input `args`
+// and `LITERAL` loads the constant `args`.
+struct Instruction {
+  NodeType op;
+  uint32_t dst;
+  uint32_t num_args;
+  uint32_t args;
+  int32_t attribute;  // ComparisonType, custom op id or the outcome of a guard
+};
+
+// - Register-allocated bytecode of a recorded graph -----------------------------------------------
+template <typename PassiveType>
+struct Bytecode {
+  std::vector<Instruction> code{};
+  std::vector<uint32_t> operands{};
+  std::vector<PassiveType> constants{};
+  std::vector<uint32_t> output_registers{};
+  std::vector<int64_t> node_ids{};  // Node of every instruction, only used for error reporting
+  size_t num_inputs    = 0;
+  size_t num_registers = 0;
+
+  // Bytes touched by a single replay, without the inputs
+  [[nodiscard]] constexpr auto working_set_size() const noexcept -> size_t {
+    return code.size() * sizeof(Instruction) + operands.size() * sizeof(uint32_t) +
+           constants.size() * sizeof(PassiveType) + num_registers * sizeof(PassiveType);
+  }
+};
+
+// - Compile a recorded graph to bytecode ----------------------------------------------------------
+// Only nodes that contribute to `outputs` or to a guard are compiled, copies (`VAR` and `LITERAL`
+// with one argument) are coalesced with their argument. Registers are assigned by a linear scan in
+// topological order: the register of a node is released after its last use and reused by the next
+// node, so the register file only has to hold the nodes that are live at the same time. Inputs and
+// constants are loaded when they are first needed.
+template <typename PassiveType>
+[[nodiscard]] auto compile(const Graph<PassiveType>& graph, std::span<const int64_t> outputs)
+    -> Bytecode<PassiveType> {
+  constexpr auto NONE = std::numeric_limits<size_t>::max();
+
+  const Tape<PassiveType> tape(graph);
+  const auto num_nodes = tape.num_nodes();
+
+  // Copies are represented by the node they copy
+  std::vector<size_t> representative(num_nodes);
+  const auto rep = [&](int64_t id) { return representative[static_cast<size_t>(id)]; };
+  for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+    const auto op   = tape.op(id);
+    const auto args = tape.args(id);
+    representative[static_cast<size_t>(id)] =
+        (op == NodeType::VAR || op == NodeType::LITERAL) && args.size() == 1
+            ? rep(args[0])
+            : static_cast<size_t>(id);
+  }
+
+  // Nodes contributing to the outputs or to a guard
+  std::vector<bool> live(num_nodes, false);
+  std::vector<bool> is_output(num_nodes, false);
+  for (auto out : outputs) {
+    RT_ASSERT(out >= 0 && static_cast<size_t>(out) < num_nodes,
+              "Node with id " << out << " is not part of the graph.");
+    live[static_cast<size_t>(out)] = true;
+    is_output[rep(out)]            = true;
+  }
+  for (auto id = static_cast<int64_t>(num_nodes) - 1; id >= 0; --id) {
+    const auto idx = static_cast<size_t>(id);
+    live[idx]      = live[idx] || tape.op(id) == NodeType::GUARD;
+    if (live[idx]) {
+      for (auto arg : tape.args(id)) {
+        live[static_cast<size_t>(arg)] = true;
+      }
+    }
+  }
+
+  // Last instruction that reads a node
+  std::vector<size_t> last_use(num_nodes, NONE);
+  for (size_t idx = 0; idx < num_nodes; ++idx) {
+    if (live[idx] && representative[idx] == idx) {
+      last_use[idx] = idx;
+      for (auto arg : tape.args(static_cast<int64_t>(idx))) {
+        last_use[rep(arg)] = idx;
+      }
+    }
+  }
+
+  std::vector<size_t> input_index(num_nodes, NONE);
+  for (size_t i = 0; i < tape.inputs().size(); ++i) {
+    input_index[static_cast<size_t>(tape.inputs()[i])] = i;
+  }
+
+  // Linear scan register allocation
+  Bytecode<PassiveType> bytecode{.num_inputs = tape.inputs().size()};
+  std::vector<uint32_t> registers(num_nodes, 0);
+  std::vector<uint32_t> free_registers{};
+  const auto release = [&](size_t idx) {
+    if (!is_output[idx] && last_use[idx] != NONE) {
+      free_registers.push_back(registers[idx]);
+      last_use[idx] = NONE;
+    }
+  };
+
+  for (size_t idx = 0; idx < num_nodes; ++idx) {
+    const auto id = static_cast<int64_t>(idx);
+    if (!live[idx] || representative[idx] != idx) {
+      continue;
+    }
+
+    const auto args = tape.args(id);
+    Instruction ins{.op        = tape.op(id),
+                    .dst       = 0,
+                    .num_args  = static_cast<uint32_t>(args.size()),
+                    .args      = static_cast<uint32_t>(bytecode.operands.size()),
+                    .attribute = static_cast<int32_t>(tape.attribute(id))};
+    if (args.empty()) {
+      if (input_index[idx] != NONE) {
+        ins.op   = NodeType::VAR;
+        ins.args = static_cast<uint32_t>(input_index[idx]);
+      } else {
+        ins.op   = NodeType::LITERAL;
+        ins.args = static_cast<uint32_t>(bytecode.constants.size());
+        bytecode.constants.push_back(tape.values()[idx]);
+      }
+    }
+    for (auto arg : args) {
+      bytecode.operands.push_back(registers[rep(arg)]);
+    }
+
+    // Registers of arguments that die here can be reused for the result
+    for (auto arg : args) {
+      const auto arg_idx = rep(arg);
+      if (last_use[arg_idx] == idx) {
+        release(arg_idx);
+      }
+    }
+
+    if (free_registers.empty()) {
+      registers[idx] = static_cast<uint32_t>(bytecode.num_registers++);
+    } else {
+      registers[idx] = free_registers.back();
+      free_registers.pop_back();
+    }
+    ins.dst = registers[idx];
+    bytecode.code.push_back(ins);
+    bytecode.node_ids.push_back(id);
+
+    // Results that are never read, e.g. guards
+    if (last_use[idx] == idx) {
+      release(idx);
+    }
+  }
+
+  bytecode.output_registers.reserve(outputs.size());
+  for (auto out : outputs) {
+    bytecode.output_registers.push_back(registers[rep(out)]);
+  }
+  return bytecode;
+}
+
+// - Replay bytecode on a register file ------------------------------------------------------------
+template <typename PassiveType>
+class BytecodeInterpreter {
+  Bytecode<PassiveType> m_bytecode;
+  std::vector<PassiveType> m_registers{};
+  std::vector<int64_t> m_violated_guards{};
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  explicit BytecodeInterpreter(Bytecode<PassiveType> bytecode)
+      : m_bytecode(std::move(bytecode)),
+        m_registers(m_bytecode.num_registers) {}
+
+  // -----------------------------------------------------------------------------------------------
+  BytecodeInterpreter(const Graph<PassiveType>& graph, std::span<const int64_t> outputs)
+      : BytecodeInterpreter(compile(graph, outputs)) {}
+
+  // -----------------------------------------------------------------------------------------------
+  void evaluate(std::span<const PassiveType> inputs) {
+    RT_ASSERT(inputs.size() == m_bytecode.num_inputs,
+              "Expected " << m_bytecode.num_inputs << " inputs, but got " << inputs.size());
+
+    m_violated_guards.clear();
+    const auto* operands = m_bytecode.operands.data();
+    for (size_t pc = 0; pc < m_bytecode.code.size(); ++pc) {
+      const auto& ins = m_bytecode.code[pc];
+      if (ins.num_args == 0) {
+        m_registers[ins.dst] =
+            ins.op == NodeType::VAR ? inputs[ins.args] : m_bytecode.constants[ins.args];
+        continue;
+      }
+
+      const auto* args     = operands + ins.args;
+      m_registers[ins.dst] = detail::apply_operation<PassiveType>(
+          ins.op, ins.attribute, ins.num_args, [&](size_t i) -> const PassiveType& {
+            return m_registers[args[i]];
+          });
+
+      if constexpr (!is_matrix_type_v<PassiveType>) {
+        if (ins.op == NodeType::GUARD &&
+            static_cast<int64_t>(m_registers[ins.dst] != static_cast<PassiveType>(0)) !=
+                ins.attribute) {
+          m_violated_guards.push_back(m_bytecode.node_ids[pc]);
+        }
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Value of the `idx`-th output passed to `compile`
+  [[nodiscard]] constexpr auto output(size_t idx) const noexcept -> const PassiveType& {
+    RT_ASSERT(idx < m_bytecode.output_registers.size(),
+              "Output " << idx << " does not exist, there are "
+                        << m_bytecode.output_registers.size() << " outputs.");
+    return m_registers[m_bytecode.output_registers[idx]];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto guards_hold() const noexcept -> bool {
+    return m_violated_guards.empty();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto violated_guards() const noexcept -> const std::vector<int64_t>& {
+    return m_violated_guards;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto bytecode() const noexcept -> const Bytecode<PassiveType>& {
+    return m_bytecode;
+  }
+};
+
+}  // namespace RT
+
+#endif  // RT_BYTECODE_HPP_
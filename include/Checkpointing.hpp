@@ -0,0 +1,188 @@
+#ifndef RT_CHECKPOINTING_HPP_
+#define RT_CHECKPOINTING_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "Derivatives.hpp"
+#include "Evaluator.hpp"
+#include "Graph.hpp"
+#include "Macros.hpp"
+
+namespace RT {
+
+// - Binomial bound of the Revolve schedule --------------------------------------------------------
+// Maximal number of steps that can be reversed with `num_checkpoints` free checkpoints if every
+// step is evaluated at most `num_repetitions + 1` times, i.e. the binomial coefficient
+// `(num_checkpoints + num_repetitions) choose num_checkpoints`. Saturates instead of overflowing.
+[[nodiscard]] constexpr auto max_reversible_steps(size_t num_checkpoints,
+                                                  size_t num_repetitions) noexcept -> size_t {
+  size_t beta = 1;
+  for (size_t i = 1; i <= num_checkpoints; ++i) {
+    if (beta > std::numeric_limits<size_t>::max() / (num_repetitions + i)) {
+      return std::numeric_limits<size_t>::max();
+    }
+    beta = beta * (num_repetitions + i) / i;
+  }
+  return beta;
+}
+
+// - Gradient of a time-stepping loop with bounded memory ------------------------------------------
+// The graph records a single step of the loop, its inputs are the state at the beginning of the
+// step and `Graph::mark_iteration_boundary` marks the state at the end. Instead of a tape of the
+// whole loop only up to `max_checkpoints` states are kept; the steps in between are replayed from
+// the closest checkpoint during the reverse sweep. The checkpoints are placed according to the
+// binomial (Revolve) schedule, which minimizes the number of replayed steps for the given memory.
+//
+// Every replay has to follow the recorded control flow, which is checked with the guards of the
+// step.
+template <typename PassiveType>
+class CheckpointedGradient {
+  Evaluator<PassiveType> m_eval;
+  std::vector<int64_t> m_state_ids;
+  size_t m_max_checkpoints;
+  size_t m_num_steps = 0;
+
+  std::vector<std::vector<PassiveType>> m_checkpoints{};  // Stack of states, the first is the start
+  std::vector<PassiveType> m_state{};
+  std::vector<PassiveType> m_gradient{};
+  size_t m_num_evaluated_steps  = 0;
+  size_t m_max_used_checkpoints = 0;
+
+  // Replay a single step starting from `state`
+  void evaluate_step(std::span<const PassiveType> state) {
+    m_eval.evaluate(state);
+    RT_ASSERT(m_eval.guards_hold(),
+              "Control flow of the replayed step differs from the recorded one, "
+                  << m_eval.violated_guards().size() << " guards are violated.");
+    ++m_num_evaluated_steps;
+  }
+
+  // State after `num_steps` steps starting from `state`
+  [[nodiscard]] auto advance(std::span<const PassiveType> state, size_t num_steps)
+      -> std::vector<PassiveType> {
+    std::vector<PassiveType> next(state.begin(), state.end());
+    for (size_t step = 0; step < num_steps; ++step) {
+      evaluate_step(next);
+      for (size_t i = 0; i < m_state_ids.size(); ++i) {
+        next[i] = m_eval.value(m_state_ids[i]);
+      }
+    }
+    return next;
+  }
+
+  // Reverse the single step `step` starting from the state `state`
+  void reverse_step(std::span<const PassiveType> state, size_t step) {
+    evaluate_step(state);
+    if (step + 1 == m_num_steps) {
+      for (size_t i = 0; i < m_state_ids.size(); ++i) {
+        m_state[i] = m_eval.value(m_state_ids[i]);
+      }
+    }
+    m_gradient =
+        RT::gradient<PassiveType>(m_eval.tape(), m_eval.values(), m_state_ids, m_gradient);
+  }
+
+  // Reverse the steps [begin, end), the state at `begin` is the top of the checkpoint stack and
+  // `num_free` checkpoints are still available
+  void reverse(size_t begin, size_t end, size_t num_free) {
+    const auto num_steps = end - begin;
+    if (num_steps == 1) {
+      reverse_step(m_checkpoints.back(), begin);
+      return;
+    }
+
+    // Without free checkpoints every step is replayed from the top of the stack
+    if (num_free == 0) {
+      for (auto step = end; step-- > begin;) {
+        reverse_step(advance(m_checkpoints.back(), step - begin), step);
+      }
+      return;
+    }
+
+    // Split such that the left part is reversible with `num_repetitions - 1` and the right part
+    // with `num_repetitions` repetitions and one checkpoint less
+    size_t num_repetitions = 1;
+    while (max_reversible_steps(num_free, num_repetitions) < num_steps) {
+      ++num_repetitions;
+    }
+    const auto split =
+        begin + std::min(max_reversible_steps(num_free, num_repetitions - 1), num_steps - 1);
+
+    m_checkpoints.push_back(advance(m_checkpoints.back(), split - begin));
+    m_max_used_checkpoints = std::max(m_max_used_checkpoints, m_checkpoints.size());
+    reverse(split, end, num_free - 1);
+    m_checkpoints.pop_back();
+    reverse(begin, split, num_free);
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  // `max_checkpoints` is the number of states that are stored at the same time including the
+  // initial state, the memory is bounded by this number of states plus the values of one step
+  CheckpointedGradient(const Graph<PassiveType>& step, size_t max_checkpoints)
+      : m_eval(step),
+        m_state_ids(step.iteration_state()),
+        m_max_checkpoints(max_checkpoints) {
+    RT_ASSERT(m_max_checkpoints > 0, "At least the initial state has to be stored.");
+    RT_ASSERT(m_state_ids.size() == step.inputs().size(),
+              "The end of the step has to be marked via `mark_iteration_boundary`.");
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Runs `num_steps` steps starting from `initial_state` and computes the adjoints of the initial
+  // state for the adjoints `seeds` of the final state
+  void evaluate(std::span<const PassiveType> initial_state,
+                size_t num_steps,
+                std::span<const PassiveType> seeds) {
+    RT_ASSERT(initial_state.size() == m_state_ids.size(),
+              "Expected state of size " << m_state_ids.size() << ", but got "
+                                        << initial_state.size());
+    RT_ASSERT(seeds.size() == m_state_ids.size(),
+              "Expected one seed per state entry, but got " << seeds.size() << " seeds");
+
+    m_num_steps            = num_steps;
+    m_num_evaluated_steps  = 0;
+    m_max_used_checkpoints = 1;
+    m_state.assign(initial_state.begin(), initial_state.end());
+    m_gradient.assign(seeds.begin(), seeds.end());
+    if (num_steps == 0) {
+      return;
+    }
+
+    m_checkpoints.clear();
+    m_checkpoints.emplace_back(initial_state.begin(), initial_state.end());
+    reverse(0ul, num_steps, m_max_checkpoints - 1ul);
+    m_checkpoints.clear();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // State after the last step
+  [[nodiscard]] constexpr auto state() const noexcept -> const std::vector<PassiveType>& {
+    return m_state;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Adjoints of the initial state
+  [[nodiscard]] constexpr auto gradient() const noexcept -> const std::vector<PassiveType>& {
+    return m_gradient;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Number of replayed steps including the recomputations
+  [[nodiscard]] constexpr auto num_evaluated_steps() const noexcept -> size_t {
+    return m_num_evaluated_steps;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto max_used_checkpoints() const noexcept -> size_t {
+    return m_max_used_checkpoints;
+  }
+};
+
+}  // namespace RT
+
+#endif  // RT_CHECKPOINTING_HPP_
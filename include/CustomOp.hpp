@@ -0,0 +1,86 @@
+#ifndef RT_CUSTOM_OP_HPP_
+#define RT_CUSTOM_OP_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string>
+
+#include "Macros.hpp"
+
+namespace RT {
+
+// - User defined operation ------------------------------------------------------------------------
+template <typename PassiveType>
+struct CustomOp {
+  using Forward    = std::function<PassiveType(std::span<const PassiveType> args)>;
+  using Derivative = std::function<PassiveType(std::span<const PassiveType> args, size_t arg_idx)>;
+
+  std::string name;
+  size_t arity;
+  Forward forward;
+  Derivative derivative{};  // Partial derivative w.r.t. argument `arg_idx`, optional
+};
+
+// - Registry for user defined operations ----------------------------------------------------------
+// Operations can be registered while other threads record or replay, registering takes an exclusive
+// lock and looking up an operation a shared lock.
+template <typename PassiveType>
+class CustomOpRegistry {
+  // Use deque such that references to registered operations stay valid
+  [[nodiscard]] static auto ops() noexcept -> std::deque<CustomOp<PassiveType>>& {
+    static std::deque<CustomOp<PassiveType>> registered_ops{};
+    return registered_ops;
+  }
+
+  [[nodiscard]] static auto mutex() noexcept -> std::shared_mutex& {
+    static std::shared_mutex ops_mutex{};
+    return ops_mutex;
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] static auto add(CustomOp<PassiveType> op) noexcept -> int64_t {
+    RT_ASSERT(static_cast<bool>(op.forward),
+              "Custom operation `" << op.name << "` must have a forward kernel.");
+    const std::unique_lock lock(mutex());
+    ops().push_back(std::move(op));
+    return static_cast<int64_t>(ops().size()) - 1;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] static auto get(int64_t op_id) noexcept -> const CustomOp<PassiveType>& {
+    const std::shared_lock lock(mutex());
+    RT_ASSERT(op_id >= 0 && static_cast<size_t>(op_id) < ops().size(),
+              "Custom operation with id " << op_id << " is not registered.");
+    return ops()[static_cast<size_t>(op_id)];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] static auto size() noexcept -> size_t {
+    const std::shared_lock lock(mutex());
+    return ops().size();
+  }
+};
+
+// - Register custom operation, returns the id of the operation ------------------------------------
+template <typename PassiveType>
+[[nodiscard]] auto register_custom_op(std::string name,
+                                      size_t arity,
+                                      typename CustomOp<PassiveType>::Forward forward,
+                                      typename CustomOp<PassiveType>::Derivative derivative = {})
+    -> int64_t {
+  return CustomOpRegistry<PassiveType>::add(CustomOp<PassiveType>{
+      .name       = std::move(name),
+      .arity      = arity,
+      .forward    = std::move(forward),
+      .derivative = std::move(derivative),
+  });
+}
+
+}  // namespace RT
+
+#endif  // RT_CUSTOM_OP_HPP_
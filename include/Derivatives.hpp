@@ -0,0 +1,496 @@
+#ifndef RT_DERIVATIVES_HPP_
+#define RT_DERIVATIVES_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+#ifndef RT_ONLY_FUNDAMENTAL
+#include <cmath>
+#endif  // RT_ONLY_FUNDAMENTAL
+
+#include "CustomOp.hpp"
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+namespace RT {
+
+namespace detail {
+
+// - Local partial derivative of a single operation ------------------------------------------------
+// Derivative of the node w.r.t. its argument `arg_idx`; `arg(i)` returns the value of the i-th
+// argument and `value` is the value of the node itself. Comparisons and guards do not contribute to
+// the derivative.
+template <typename PassiveType, typename ArgFunc>
+[[nodiscard]] auto local_partial(NodeType op,
+                                 int64_t attribute,
+                                 size_t num_args,
+                                 const ArgFunc& arg,
+                                 const PassiveType& value,
+                                 size_t arg_idx) -> PassiveType {
+  static_assert(std::is_floating_point_v<PassiveType>,
+                "Derivatives require a floating point type as `PassiveType`.");
+  constexpr auto zero = static_cast<PassiveType>(0);
+  constexpr auto one  = static_cast<PassiveType>(1);
+
+  switch (op) {
+    case NodeType::LITERAL:
+    case NodeType::VAR:
+    case NodeType::ADD:
+    case NodeType::SUM:
+      return one;
+    case NodeType::SUB:
+      return arg_idx == 0 ? one : -one;
+    case NodeType::NEG:
+      return -one;
+    case NodeType::MUL:
+      return arg(1 - arg_idx);
+    case NodeType::INV:
+      return -value * value;
+#ifndef RT_ONLY_FUNDAMENTAL
+    case NodeType::SQRT:
+      return one / (static_cast<PassiveType>(2) * value);
+    case NodeType::SIN:
+      return std::cos(arg(0));
+    case NodeType::COS:
+      return -std::sin(arg(0));
+#endif  // RT_ONLY_FUNDAMENTAL
+    case NodeType::CMP:
+    case NodeType::GUARD:
+      return zero;
+    case NodeType::SELECT:
+      if (arg_idx == 0) {
+        return zero;
+      }
+      return (arg(0) != zero) == (arg_idx == 1) ? one : zero;
+    case NodeType::DOT:
+      {
+        const auto n = num_args / 2;
+        return arg_idx < n ? arg(arg_idx + n) : arg(arg_idx - n);
+      }
+    case NodeType::CUSTOM:
+      {
+        const auto& custom = CustomOpRegistry<PassiveType>::get(attribute);
+        RT_ASSERT(static_cast<bool>(custom.derivative),
+                  "Custom operation `" << custom.name << "` has no derivative.");
+        std::vector<PassiveType> arg_values(num_args);
+        for (size_t i = 0; i < num_args; ++i) {
+          arg_values[i] = arg(i);
+        }
+        return custom.derivative(arg_values, arg_idx);
+      }
+    default:
+      RT_PANIC("Operation " << op << " is not differentiable.");
+  }
+}
+
+// - Second order local derivative of a single operation -------------------------------------------
+// Sum over `j` of the second derivative of the node w.r.t. its arguments `arg_idx` and `j` times
+// `arg_tangent(j)`, i.e. the directional derivative of `local_partial` for the argument `arg_idx`
+template <typename PassiveType, typename ArgFunc, typename ArgTangentFunc>
+[[nodiscard]] auto local_partial_tangent(NodeType op,
+                                         size_t num_args,
+                                         const ArgFunc& arg,
+                                         const ArgTangentFunc& arg_tangent,
+                                         const PassiveType& value,
+                                         size_t arg_idx) -> PassiveType {
+  static_assert(std::is_floating_point_v<PassiveType>,
+                "Derivatives require a floating point type as `PassiveType`.");
+
+  switch (op) {
+    case NodeType::LITERAL:
+    case NodeType::VAR:
+    case NodeType::ADD:
+    case NodeType::SUM:
+    case NodeType::SUB:
+    case NodeType::NEG:
+    case NodeType::CMP:
+    case NodeType::GUARD:
+    case NodeType::SELECT:
+      return static_cast<PassiveType>(0);
+    case NodeType::MUL:
+      return arg_tangent(1 - arg_idx);
+    case NodeType::INV:
+      // d^2 (1 / x) / dx^2 = 2 / x^3
+      return static_cast<PassiveType>(2) * value * value * value * arg_tangent(0);
+#ifndef RT_ONLY_FUNDAMENTAL
+    case NodeType::SQRT:
+      // d^2 sqrt(x) / dx^2 = -1 / (4 x^(3/2))
+      return -arg_tangent(0) / (static_cast<PassiveType>(4) * value * value * value);
+    case NodeType::SIN:
+    case NodeType::COS:
+      // d^2 sin(x) / dx^2 = -sin(x), same for cos
+      return -value * arg_tangent(0);
+#endif  // RT_ONLY_FUNDAMENTAL
+    case NodeType::DOT:
+      {
+        const auto n = num_args / 2;
+        return arg_idx < n ? arg_tangent(arg_idx + n) : arg_tangent(arg_idx - n);
+      }
+    default:
+      static_cast<void>(arg);
+      RT_PANIC("Second order derivative of operation " << op << " is not available.");
+  }
+}
+
+// - Reverse sweep ---------------------------------------------------------------------------------
+// Propagates the adjoints of all nodes from the last to the first node, `adjoints` has to contain
+// the seeds of the outputs and is accumulated in place
+template <typename PassiveType>
+void reverse_sweep(const Tape<PassiveType>& tape,
+                   std::span<const PassiveType> values,
+                   std::span<PassiveType> adjoints) {
+  RT_ASSERT(values.size() == tape.num_nodes() && adjoints.size() == tape.num_nodes(),
+            "Expected values and adjoints for " << tape.num_nodes() << " nodes, but got "
+                                                << values.size() << " values and "
+                                                << adjoints.size() << " adjoints");
+  for (auto id = static_cast<int64_t>(tape.num_nodes()) - 1; id >= 0; --id) {
+    const auto adjoint = adjoints[static_cast<size_t>(id)];
+    const auto args    = tape.args(id);
+    if (args.empty() || adjoint == static_cast<PassiveType>(0)) {
+      continue;
+    }
+
+    const auto arg = [&](size_t i) -> const PassiveType& {
+      return values[static_cast<size_t>(args[i])];
+    };
+    for (size_t i = 0; i < args.size(); ++i) {
+      adjoints[static_cast<size_t>(args[i])] +=
+          adjoint * local_partial<PassiveType>(tape.op(id),
+                                               tape.attribute(id),
+                                               args.size(),
+                                               arg,
+                                               values[static_cast<size_t>(id)],
+                                               i);
+    }
+  }
+}
+
+// - Vector reverse sweep --------------------------------------------------------------------------
+// Same as `reverse_sweep`, but propagates `num_lanes` adjoints per node, the adjoints of node `id`
+// are `adjoints[id * num_lanes]` to `adjoints[(id + 1) * num_lanes - 1]`
+template <typename PassiveType>
+void vector_reverse_sweep(const Tape<PassiveType>& tape,
+                          std::span<const PassiveType> values,
+                          std::span<PassiveType> adjoints,
+                          size_t num_lanes) {
+  RT_ASSERT(values.size() == tape.num_nodes() && adjoints.size() == tape.num_nodes() * num_lanes,
+            "Expected values and adjoints for " << tape.num_nodes() << " nodes, but got "
+                                                << values.size() << " values and "
+                                                << adjoints.size() << " adjoints");
+  for (auto id = static_cast<int64_t>(tape.num_nodes()) - 1; id >= 0; --id) {
+    const auto args = tape.args(id);
+    if (args.empty()) {
+      continue;
+    }
+    const auto* adjoint = &adjoints[static_cast<size_t>(id) * num_lanes];
+    if (std::all_of(adjoint, adjoint + num_lanes, [](const PassiveType& a) {
+          return a == static_cast<PassiveType>(0);
+        })) {
+      continue;
+    }
+
+    const auto arg = [&](size_t i) -> const PassiveType& {
+      return values[static_cast<size_t>(args[i])];
+    };
+    for (size_t i = 0; i < args.size(); ++i) {
+      const auto partial = local_partial<PassiveType>(
+          tape.op(id), tape.attribute(id), args.size(), arg, values[static_cast<size_t>(id)], i);
+      if (partial == static_cast<PassiveType>(0)) {
+        continue;
+      }
+      auto* arg_adjoint = &adjoints[static_cast<size_t>(args[i]) * num_lanes];
+      for (size_t l = 0; l < num_lanes; ++l) {
+        arg_adjoint[l] += partial * adjoint[l];
+      }
+    }
+  }
+}
+
+// - Tangent sweep ---------------------------------------------------------------------------------
+// Propagates `num_directions` tangents per node from the first to the last node, the tangents of
+// node `id` are `tangents[id * num_directions]` to `tangents[(id + 1) * num_directions - 1]`. The
+// tangents of the inputs have to be set, all other tangents are overwritten.
+template <typename PassiveType>
+void tangent_sweep(const Tape<PassiveType>& tape,
+                   std::span<const PassiveType> values,
+                   std::span<PassiveType> tangents,
+                   size_t num_directions) {
+  RT_ASSERT(values.size() == tape.num_nodes() &&
+                tangents.size() == tape.num_nodes() * num_directions,
+            "Expected values and tangents for " << tape.num_nodes() << " nodes, but got "
+                                                << values.size() << " values and "
+                                                << tangents.size() << " tangents");
+  for (int64_t id = 0; id < static_cast<int64_t>(tape.num_nodes()); ++id) {
+    const auto args = tape.args(id);
+    if (args.empty()) {
+      continue;
+    }
+
+    const auto arg = [&](size_t i) -> const PassiveType& {
+      return values[static_cast<size_t>(args[i])];
+    };
+    auto res = tangents.subspan(static_cast<size_t>(id) * num_directions, num_directions);
+    std::fill(std::begin(res), std::end(res), static_cast<PassiveType>(0));
+    for (size_t i = 0; i < args.size(); ++i) {
+      const auto partial = local_partial<PassiveType>(
+          tape.op(id), tape.attribute(id), args.size(), arg, values[static_cast<size_t>(id)], i);
+      if (partial == static_cast<PassiveType>(0)) {
+        continue;
+      }
+      const auto* arg_tangents = &tangents[static_cast<size_t>(args[i]) * num_directions];
+      for (size_t d = 0; d < num_directions; ++d) {
+        res[d] += partial * arg_tangents[d];
+      }
+    }
+  }
+}
+
+}  // namespace detail
+
+// - Jacobian-matrix product using the forward mode (tangent) --------------------------------------
+// Propagates `num_directions` directions in a single sweep, `directions[i * num_directions + d]`
+// is the component of direction `d` for input `i`; the result for output `o` and direction `d` is
+// stored at `o * num_directions + d`
+template <typename PassiveType>
+[[nodiscard]] auto jacobian_matrix_product(const Tape<PassiveType>& tape,
+                                           std::span<const PassiveType> values,
+                                           std::span<const int64_t> outputs,
+                                           std::span<const PassiveType> directions,
+                                           size_t num_directions) -> std::vector<PassiveType> {
+  const auto& inputs = tape.inputs();
+  RT_ASSERT(directions.size() == inputs.size() * num_directions,
+            "Expected " << inputs.size() * num_directions << " direction components, but got "
+                        << directions.size());
+
+  std::vector<PassiveType> tangents(tape.num_nodes() * num_directions,
+                                    static_cast<PassiveType>(0));
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    std::copy_n(std::next(std::cbegin(directions), static_cast<std::ptrdiff_t>(i * num_directions)),
+                num_directions,
+                std::next(std::begin(tangents),
+                          static_cast<std::ptrdiff_t>(static_cast<size_t>(inputs[i]) *
+                                                      num_directions)));
+  }
+
+  detail::tangent_sweep<PassiveType>(tape, values, tangents, num_directions);
+
+  std::vector<PassiveType> res(outputs.size() * num_directions);
+  for (size_t o = 0; o < outputs.size(); ++o) {
+    RT_ASSERT(outputs[o] >= 0 && static_cast<size_t>(outputs[o]) < tape.num_nodes(),
+              "Node with id " << outputs[o] << " is not part of the graph.");
+    std::copy_n(std::next(std::cbegin(tangents),
+                          static_cast<std::ptrdiff_t>(static_cast<size_t>(outputs[o]) *
+                                                      num_directions)),
+                num_directions,
+                std::next(std::begin(res), static_cast<std::ptrdiff_t>(o * num_directions)));
+  }
+  return res;
+}
+
+// Same as above, uses the recorded values
+template <typename PassiveType>
+[[nodiscard]] auto jacobian_matrix_product(const Graph<PassiveType>& graph,
+                                           std::span<const int64_t> outputs,
+                                           std::span<const PassiveType> directions,
+                                           size_t num_directions) -> std::vector<PassiveType> {
+  const Tape<PassiveType> tape(graph);
+  return jacobian_matrix_product<PassiveType>(
+      tape, tape.values(), outputs, directions, num_directions);
+}
+
+// - Jacobian-vector product using the forward mode (tangent) --------------------------------------
+// Directional derivative `J * direction` of the outputs, `direction` has one entry per input
+template <typename PassiveType>
+[[nodiscard]] auto jacobian_vector_product(const Tape<PassiveType>& tape,
+                                           std::span<const PassiveType> values,
+                                           std::span<const int64_t> outputs,
+                                           std::span<const PassiveType> direction)
+    -> std::vector<PassiveType> {
+  return jacobian_matrix_product<PassiveType>(tape, values, outputs, direction, 1ul);
+}
+
+// Same as above, uses the recorded values
+template <typename PassiveType>
+[[nodiscard]] auto jacobian_vector_product(const Graph<PassiveType>& graph,
+                                           std::span<const int64_t> outputs,
+                                           std::span<const PassiveType> direction)
+    -> std::vector<PassiveType> {
+  return jacobian_matrix_product<PassiveType>(graph, outputs, direction, 1ul);
+}
+
+// - Jacobian using the vector reverse mode -------------------------------------------------------
+// Full Jacobian of `outputs` w.r.t. all registered inputs in row major order, i.e. the derivative
+// of output `o` w.r.t. input `i` is stored at `o * num_inputs + i`. The outputs are processed in
+// chunks of at most `max_lanes` adjoints per node, one sweep over the tape per chunk; this bounds
+// the memory to `num_nodes * max_lanes` adjoints.
+template <typename PassiveType>
+[[nodiscard]] auto jacobian(const Tape<PassiveType>& tape,
+                            std::span<const PassiveType> values,
+                            std::span<const int64_t> outputs,
+                            size_t max_lanes = 16) -> std::vector<PassiveType> {
+  RT_ASSERT(max_lanes > 0, "At least one lane is required.");
+  const auto& inputs   = tape.inputs();
+  const auto num_lanes = std::min(max_lanes, outputs.size());
+
+  std::vector<PassiveType> jac(outputs.size() * inputs.size());
+  std::vector<PassiveType> adjoints(tape.num_nodes() * num_lanes);
+  for (size_t chunk_begin = 0; chunk_begin < outputs.size(); chunk_begin += num_lanes) {
+    const auto chunk_size = std::min(num_lanes, outputs.size() - chunk_begin);
+
+    std::fill(std::begin(adjoints), std::end(adjoints), static_cast<PassiveType>(0));
+    for (size_t l = 0; l < chunk_size; ++l) {
+      const auto out = outputs[chunk_begin + l];
+      RT_ASSERT(out >= 0 && static_cast<size_t>(out) < tape.num_nodes(),
+                "Node with id " << out << " is not part of the graph.");
+      adjoints[static_cast<size_t>(out) * num_lanes + l] = static_cast<PassiveType>(1);
+    }
+
+    detail::vector_reverse_sweep<PassiveType>(tape, values, adjoints, num_lanes);
+
+    for (size_t l = 0; l < chunk_size; ++l) {
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        jac[(chunk_begin + l) * inputs.size() + i] =
+            adjoints[static_cast<size_t>(inputs[i]) * num_lanes + l];
+      }
+    }
+  }
+  return jac;
+}
+
+// Same as above, uses the recorded values
+template <typename PassiveType>
+[[nodiscard]] auto jacobian(const Graph<PassiveType>& graph,
+                            std::span<const int64_t> outputs,
+                            size_t max_lanes = 16) -> std::vector<PassiveType> {
+  const Tape<PassiveType> tape(graph);
+  return jacobian<PassiveType>(tape, tape.values(), outputs, max_lanes);
+}
+
+// - Hessian-vector product using forward over reverse mode ----------------------------------------
+// Product of the Hessian of `sum_i seeds[i] * outputs[i]` w.r.t. all registered inputs and
+// `direction`, which has one entry per input. Costs one tangent sweep and one reverse sweep that
+// propagates the adjoints together with their tangents.
+template <typename PassiveType>
+[[nodiscard]] auto hessian_vector_product(const Tape<PassiveType>& tape,
+                                          std::span<const PassiveType> values,
+                                          std::span<const int64_t> outputs,
+                                          std::span<const PassiveType> seeds,
+                                          std::span<const PassiveType> direction)
+    -> std::vector<PassiveType> {
+  const auto& inputs = tape.inputs();
+  RT_ASSERT(outputs.size() == seeds.size(),
+            "Expected one seed per output, but got " << outputs.size() << " outputs and "
+                                                     << seeds.size() << " seeds");
+  RT_ASSERT(direction.size() == inputs.size(),
+            "Expected " << inputs.size() << " direction components, but got "
+                        << direction.size());
+  constexpr auto zero = static_cast<PassiveType>(0);
+
+  // Forward: tangents of all nodes
+  std::vector<PassiveType> tangents(tape.num_nodes(), zero);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    tangents[static_cast<size_t>(inputs[i])] = direction[i];
+  }
+  detail::tangent_sweep<PassiveType>(tape, values, tangents, 1ul);
+
+  // Reverse: adjoints and their tangents
+  std::vector<PassiveType> adjoints(tape.num_nodes(), zero);
+  std::vector<PassiveType> adjoint_tangents(tape.num_nodes(), zero);
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    RT_ASSERT(outputs[i] >= 0 && static_cast<size_t>(outputs[i]) < tape.num_nodes(),
+              "Node with id " << outputs[i] << " is not part of the graph.");
+    adjoints[static_cast<size_t>(outputs[i])] += seeds[i];
+  }
+
+  for (auto id = static_cast<int64_t>(tape.num_nodes()) - 1; id >= 0; --id) {
+    const auto idx             = static_cast<size_t>(id);
+    const auto adjoint         = adjoints[idx];
+    const auto adjoint_tangent = adjoint_tangents[idx];
+    const auto args            = tape.args(id);
+    if (args.empty() || (adjoint == zero && adjoint_tangent == zero)) {
+      continue;
+    }
+
+    const auto arg = [&](size_t i) -> const PassiveType& {
+      return values[static_cast<size_t>(args[i])];
+    };
+    const auto arg_tangent = [&](size_t i) -> const PassiveType& {
+      return tangents[static_cast<size_t>(args[i])];
+    };
+    for (size_t i = 0; i < args.size(); ++i) {
+      const auto arg_idx = static_cast<size_t>(args[i]);
+      const auto partial = detail::local_partial<PassiveType>(
+          tape.op(id), tape.attribute(id), args.size(), arg, values[idx], i);
+      adjoints[arg_idx]         += adjoint * partial;
+      adjoint_tangents[arg_idx] += adjoint_tangent * partial;
+      if (adjoint != zero) {
+        adjoint_tangents[arg_idx] +=
+            adjoint * detail::local_partial_tangent<PassiveType>(
+                          tape.op(id), args.size(), arg, arg_tangent, values[idx], i);
+      }
+    }
+  }
+
+  std::vector<PassiveType> res(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    res[i] = adjoint_tangents[static_cast<size_t>(inputs[i])];
+  }
+  return res;
+}
+
+// Same as above, uses the recorded values
+template <typename PassiveType>
+[[nodiscard]] auto hessian_vector_product(const Graph<PassiveType>& graph,
+                                          std::span<const int64_t> outputs,
+                                          std::span<const PassiveType> seeds,
+                                          std::span<const PassiveType> direction)
+    -> std::vector<PassiveType> {
+  const Tape<PassiveType> tape(graph);
+  return hessian_vector_product<PassiveType>(tape, tape.values(), outputs, seeds, direction);
+}
+
+// - Gradient using the reverse mode (adjoint) -----------------------------------------------------
+// Adjoints of all registered inputs for the given output nodes and their seeds, i.e.
+// `sum_i seeds[i] * d outputs[i] / d input`; `values` are the values of all nodes, e.g. from an
+// `Evaluator`
+template <typename PassiveType>
+[[nodiscard]] auto gradient(const Tape<PassiveType>& tape,
+                            std::span<const PassiveType> values,
+                            std::span<const int64_t> outputs,
+                            std::span<const PassiveType> seeds) -> std::vector<PassiveType> {
+  RT_ASSERT(outputs.size() == seeds.size(),
+            "Expected one seed per output, but got " << outputs.size() << " outputs and "
+                                                     << seeds.size() << " seeds");
+  std::vector<PassiveType> adjoints(tape.num_nodes(), static_cast<PassiveType>(0));
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    RT_ASSERT(outputs[i] >= 0 && static_cast<size_t>(outputs[i]) < tape.num_nodes(),
+              "Node with id " << outputs[i] << " is not part of the graph.");
+    adjoints[static_cast<size_t>(outputs[i])] += seeds[i];
+  }
+
+  detail::reverse_sweep<PassiveType>(tape, values, adjoints);
+
+  std::vector<PassiveType> input_adjoints(tape.inputs().size());
+  for (size_t i = 0; i < tape.inputs().size(); ++i) {
+    input_adjoints[i] = adjoints[static_cast<size_t>(tape.inputs()[i])];
+  }
+  return input_adjoints;
+}
+
+// Same as above, uses the recorded values
+template <typename PassiveType>
+[[nodiscard]] auto gradient(const Graph<PassiveType>& graph,
+                            std::span<const int64_t> outputs,
+                            std::span<const PassiveType> seeds) -> std::vector<PassiveType> {
+  const Tape<PassiveType> tape(graph);
+  return gradient<PassiveType>(tape, tape.values(), outputs, seeds);
+}
+
+}  // namespace RT
+
+#endif  // RT_DERIVATIVES_HPP_
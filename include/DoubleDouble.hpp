@@ -0,0 +1,195 @@
+#ifndef RT_DOUBLE_DOUBLE_HPP_
+#define RT_DOUBLE_DOUBLE_HPP_
+
+#include <cmath>
+#include <compare>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+namespace RT {
+
+// - Double-double arithmetic ----------------------------------------------------------------------
+// Represents a number as the unevaluated sum `hi + lo` of two doubles with `|lo| <= ulp(hi) / 2`,
+// which gives about 106 bits of precision. The operations use error-free transformations (Dekker,
+// Knuth) and are only correct with IEEE double arithmetic, i.e. without `-ffast-math`.
+class DoubleDouble {
+  double m_hi = 0.0;
+  double m_lo = 0.0;
+
+  // - Error-free transformations ----------------------------------------------
+  // `a + b` exactly as `s + e`
+  static auto two_sum(double a, double b, double& e) noexcept -> double {
+    const double s  = a + b;
+    const double bb = s - a;
+    e               = (a - (s - bb)) + (b - bb);
+    return s;
+  }
+
+  // Same as `two_sum`, requires `|a| >= |b|`
+  static auto quick_two_sum(double a, double b, double& e) noexcept -> double {
+    const double s = a + b;
+    e              = b - (s - a);
+    return s;
+  }
+
+  // `a * b` exactly as `p + e`
+  static auto two_prod(double a, double b, double& e) noexcept -> double {
+    const double p = a * b;
+    e              = std::fma(a, b, -p);
+    return p;
+  }
+  // - Error-free transformations ----------------------------------------------
+
+  // -----------------------------------------------------------------------------------------------
+  // Taylor series of sin or cos for `|x| <= pi / 4`
+  static auto taylor(const DoubleDouble& x, bool is_sin) noexcept -> DoubleDouble {
+    const DoubleDouble x2 = x * x;
+    DoubleDouble term     = is_sin ? x : DoubleDouble{1.0};
+    DoubleDouble sum      = term;
+    for (int i = 1; i < 30; ++i) {
+      const auto k = static_cast<double>(2 * i);
+      term         = -(term * x2) / (is_sin ? k * (k + 1.0) : (k - 1.0) * k);
+      sum          = sum + term;
+      if (std::abs(term.m_hi) <= std::abs(sum.m_hi) * 1e-33) {
+        break;
+      }
+    }
+    return sum;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // sin(x) and cos(x) after reducing `x` by a multiple of pi / 2
+  static auto sin_cos(const DoubleDouble& x, bool is_sin) noexcept -> DoubleDouble {
+    const DoubleDouble PI_2{0x1.921fb54442d18p+0, 0x1.1a62633145c07p-54};
+    const double k       = std::nearbyint(x.m_hi / PI_2.m_hi);
+    const DoubleDouble r = x - DoubleDouble{k} * PI_2;
+    const auto quadrant  = static_cast<int>(std::fmod(k, 4.0) + (k < 0.0 ? 4.0 : 0.0)) % 4;
+
+    // sin(r + q pi / 2) and cos(r + q pi / 2) are +-sin(r) or +-cos(r)
+    const bool use_sin   = (quadrant % 2 == 0) == is_sin;
+    const bool negate    = is_sin ? quadrant >= 2 : (quadrant == 1 || quadrant == 2);
+    const DoubleDouble y = taylor(r, use_sin);
+    return negate ? -y : y;
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  constexpr DoubleDouble() noexcept = default;
+
+  // -----------------------------------------------------------------------------------------------
+  constexpr DoubleDouble(double hi, double lo) noexcept
+      : m_hi(hi),
+        m_lo(lo) {}
+
+  // -----------------------------------------------------------------------------------------------
+  template <typename T>
+  requires std::is_arithmetic_v<T>
+  constexpr DoubleDouble(T value) noexcept
+      : m_hi(static_cast<double>(value)),
+        m_lo(static_cast<double>(static_cast<long double>(value) -
+                                 static_cast<long double>(static_cast<double>(value)))) {}
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto hi() const noexcept -> double { return m_hi; }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto lo() const noexcept -> double { return m_lo; }
+
+  // -----------------------------------------------------------------------------------------------
+  template <typename T>
+  requires std::is_floating_point_v<T>
+  constexpr explicit operator T() const noexcept {
+    return static_cast<T>(static_cast<long double>(m_hi) + static_cast<long double>(m_lo));
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  friend auto operator-(const DoubleDouble& a) noexcept -> DoubleDouble {
+    return {-a.m_hi, -a.m_lo};
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  friend auto operator+(const DoubleDouble& a, const DoubleDouble& b) noexcept -> DoubleDouble {
+    double e1      = 0.0;
+    double e2      = 0.0;
+    double s       = two_sum(a.m_hi, b.m_hi, e1);
+    const double t = two_sum(a.m_lo, b.m_lo, e2);
+    e1 += t;
+    s = quick_two_sum(s, e1, e1);
+    e1 += e2;
+    s = quick_two_sum(s, e1, e1);
+    return {s, e1};
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  friend auto operator-(const DoubleDouble& a, const DoubleDouble& b) noexcept -> DoubleDouble {
+    return a + (-b);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  friend auto operator*(const DoubleDouble& a, const DoubleDouble& b) noexcept -> DoubleDouble {
+    double e       = 0.0;
+    const double p = two_prod(a.m_hi, b.m_hi, e);
+    e += a.m_hi * b.m_lo + a.m_lo * b.m_hi;
+    const double s = quick_two_sum(p, e, e);
+    return {s, e};
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  friend auto operator/(const DoubleDouble& a, const DoubleDouble& b) noexcept -> DoubleDouble {
+    // Long division, every quotient digit adds about 53 bits
+    const double q1 = a.m_hi / b.m_hi;
+    DoubleDouble r  = a - DoubleDouble{q1} * b;
+    const double q2 = r.m_hi / b.m_hi;
+    r               = r - DoubleDouble{q2} * b;
+    const double q3 = r.m_hi / b.m_hi;
+
+    double e       = 0.0;
+    const double s = quick_two_sum(q1, q2, e);
+    return DoubleDouble{s, e} + DoubleDouble{q3};
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  friend constexpr auto operator==(const DoubleDouble& a, const DoubleDouble& b) noexcept -> bool {
+    return a.m_hi == b.m_hi && a.m_lo == b.m_lo;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  friend constexpr auto operator<=>(const DoubleDouble& a, const DoubleDouble& b) noexcept
+      -> std::partial_ordering {
+    const auto cmp = a.m_hi <=> b.m_hi;
+    return cmp == 0 ? a.m_lo <=> b.m_lo : cmp;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  friend auto sqrt(const DoubleDouble& a) noexcept -> DoubleDouble {
+    if (a.m_hi == 0.0) {
+      return {};
+    }
+    if (a.m_hi < 0.0) {
+      return DoubleDouble{std::numeric_limits<double>::quiet_NaN()};
+    }
+
+    // One Newton step on the double approximation (Karp's method)
+    const double x  = 1.0 / std::sqrt(a.m_hi);
+    const double ax = a.m_hi * x;
+    double e        = 0.0;
+    const double p  = two_prod(ax, ax, e);
+    return DoubleDouble{ax} + DoubleDouble{(a - DoubleDouble{p, e}).m_hi * (x * 0.5)};
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  friend auto sin(const DoubleDouble& a) noexcept -> DoubleDouble { return sin_cos(a, true); }
+
+  // -----------------------------------------------------------------------------------------------
+  friend auto cos(const DoubleDouble& a) noexcept -> DoubleDouble { return sin_cos(a, false); }
+
+  // -----------------------------------------------------------------------------------------------
+  friend auto operator<<(std::ostream& out, const DoubleDouble& a) -> std::ostream& {
+    return out << static_cast<long double>(a);
+  }
+};
+
+}  // namespace RT
+
+#endif  // RT_DOUBLE_DOUBLE_HPP_
@@ -0,0 +1,172 @@
+#ifndef RT_EIGEN_SUPPORT_HPP_
+#define RT_EIGEN_SUPPORT_HPP_
+
+#include <deque>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "RecordType.hpp"
+
+// Include this header before using Eigen with `RT::RecordType` as scalar type, otherwise the
+// specializations below are not used.
+
+namespace RT::detail {
+
+// - Collect the coefficients of an Eigen expression -----------------------------------------------
+// Coefficients that are computed by the expression are stored in `storage`, coefficients that are
+// stored in a matrix are referenced directly to avoid recording copies.
+template <typename PassiveType>
+struct CoefficientStorage {
+  RecordType<PassiveType> coeff;
+
+  template <typename Func>
+  explicit CoefficientStorage(Func&& func)
+      : coeff(func()) {}
+};
+
+template <typename PassiveType, typename Xpr>
+void collect_coefficients(const Xpr& xpr,
+                          std::vector<const RecordType<PassiveType>*>& coeffs,
+                          std::deque<CoefficientStorage<PassiveType>>& storage) {
+  const Eigen::internal::evaluator<Xpr> eval(xpr);
+  for (Eigen::Index col = 0; col < xpr.cols(); ++col) {
+    for (Eigen::Index row = 0; row < xpr.rows(); ++row) {
+      if constexpr (static_cast<bool>(Xpr::Flags & Eigen::DirectAccessBit)) {
+        coeffs.push_back(xpr.data() + row * xpr.rowStride() + col * xpr.colStride());
+      } else if constexpr (std::is_reference_v<decltype(eval.coeff(row, col))>) {
+        coeffs.push_back(&eval.coeff(row, col));
+      } else {
+        storage.emplace_back([&] { return eval.coeff(row, col); });
+        coeffs.push_back(&storage.back().coeff);
+      }
+    }
+  }
+}
+
+// - Kind of reduction -----------------------------------------------------------------------------
+template <typename Xpr>
+struct is_product_expr : std::false_type {};
+
+template <typename PassiveType, typename Lhs, typename Rhs>
+struct is_product_expr<Eigen::CwiseBinaryOp<
+    Eigen::internal::scalar_conj_product_op<RecordType<PassiveType>, RecordType<PassiveType>>,
+    Lhs,
+    Rhs>> : std::true_type {};
+
+template <typename PassiveType, typename Lhs, typename Rhs>
+struct is_product_expr<Eigen::CwiseBinaryOp<
+    Eigen::internal::scalar_product_op<RecordType<PassiveType>, RecordType<PassiveType>>,
+    Lhs,
+    Rhs>> : std::true_type {};
+
+template <typename Xpr>
+struct is_abs2_expr : std::false_type {};
+
+template <typename PassiveType, typename Arg>
+struct is_abs2_expr<
+    Eigen::CwiseUnaryOp<Eigen::internal::scalar_abs2_op<RecordType<PassiveType>>, Arg>>
+    : std::true_type {};
+
+// - Record the sum of all coefficients of an expression as a single operation ---------------------
+// Sums of elementwise products, e.g. `dot` or coefficients of a matrix product, are recorded as
+// dot product, the same holds for `squaredNorm`.
+template <typename PassiveType, typename Xpr>
+[[nodiscard]] auto record_sum(const Xpr& xpr) -> RecordType<PassiveType> {
+  std::deque<CoefficientStorage<PassiveType>> storage{};
+
+  if constexpr (is_product_expr<Xpr>::value) {
+    std::vector<const RecordType<PassiveType>*> lhs{};
+    std::vector<const RecordType<PassiveType>*> rhs{};
+    collect_coefficients(xpr.lhs(), lhs, storage);
+    collect_coefficients(xpr.rhs(), rhs, storage);
+    return dot(std::span<const RecordType<PassiveType>* const>(lhs),
+               std::span<const RecordType<PassiveType>* const>(rhs));
+  } else if constexpr (is_abs2_expr<Xpr>::value) {
+    std::vector<const RecordType<PassiveType>*> coeffs{};
+    collect_coefficients(xpr.nestedExpression(), coeffs, storage);
+    return dot(std::span<const RecordType<PassiveType>* const>(coeffs),
+               std::span<const RecordType<PassiveType>* const>(coeffs));
+  } else {
+    std::vector<const RecordType<PassiveType>*> coeffs{};
+    collect_coefficients(xpr, coeffs, storage);
+    return sum(std::span<const RecordType<PassiveType>* const>(coeffs));
+  }
+}
+
+}  // namespace RT::detail
+
+namespace Eigen {
+
+// - Numeric traits --------------------------------------------------------------------------------
+template <typename PassiveType>
+struct NumTraits<RT::RecordType<PassiveType>> : GenericNumTraits<RT::RecordType<PassiveType>> {
+  using PassiveTraits = NumTraits<PassiveType>;
+
+  using Real       = RT::RecordType<typename PassiveTraits::Real>;
+  using NonInteger = RT::RecordType<typename PassiveTraits::NonInteger>;
+  using Nested     = RT::RecordType<PassiveType>;
+  using Literal    = RT::RecordType<PassiveType>;
+
+  enum {
+    IsComplex             = PassiveTraits::IsComplex,
+    IsInteger             = PassiveTraits::IsInteger,
+    IsSigned              = PassiveTraits::IsSigned,
+    RequireInitialization = 1,
+    ReadCost              = PassiveTraits::ReadCost,
+    AddCost               = PassiveTraits::AddCost,
+    MulCost               = PassiveTraits::MulCost,
+  };
+
+  [[nodiscard]] static auto epsilon() -> Real { return PassiveTraits::epsilon(); }
+  [[nodiscard]] static auto dummy_precision() -> Real { return PassiveTraits::dummy_precision(); }
+  [[nodiscard]] static auto highest() -> RT::RecordType<PassiveType> {
+    return PassiveTraits::highest();
+  }
+  [[nodiscard]] static auto lowest() -> RT::RecordType<PassiveType> {
+    return PassiveTraits::lowest();
+  }
+  [[nodiscard]] static constexpr auto digits10() -> int { return PassiveTraits::digits10(); }
+  [[nodiscard]] static constexpr auto digits() -> int { return PassiveTraits::digits(); }
+};
+
+namespace internal {
+
+// - Reductions, e.g. `sum`, `dot` and `squaredNorm` -----------------------------------------------
+// RecordType is never vectorized, therefore only the default traversal needs to be specialized.
+template <typename PassiveType, typename Evaluator>
+struct redux_impl<scalar_sum_op<RT::RecordType<PassiveType>, RT::RecordType<PassiveType>>,
+                  Evaluator,
+                  DefaultTraversal,
+                  NoUnrolling> {
+  using Scalar = RT::RecordType<PassiveType>;
+
+  template <typename XprType>
+  static auto run(const Evaluator& /*eval*/,
+                  const scalar_sum_op<Scalar, Scalar>& /*func*/,
+                  const XprType& xpr) -> Scalar {
+    eigen_assert(xpr.rows() > 0 && xpr.cols() > 0 && "you are using an empty matrix");
+    return RT::detail::record_sum<PassiveType>(xpr);
+  }
+};
+
+template <typename PassiveType, typename Evaluator>
+struct redux_impl<scalar_sum_op<RT::RecordType<PassiveType>, RT::RecordType<PassiveType>>,
+                  Evaluator,
+                  DefaultTraversal,
+                  CompleteUnrolling> {
+  using Scalar = RT::RecordType<PassiveType>;
+
+  template <typename XprType>
+  static auto run(const Evaluator& /*eval*/,
+                  const scalar_sum_op<Scalar, Scalar>& /*func*/,
+                  const XprType& xpr) -> Scalar {
+    return RT::detail::record_sum<PassiveType>(xpr);
+  }
+};
+
+}  // namespace internal
+
+}  // namespace Eigen
+
+#endif  // RT_EIGEN_SUPPORT_HPP_
@@ -0,0 +1,505 @@
+#ifndef RT_ERROR_ANALYSIS_HPP_
+#define RT_ERROR_ANALYSIS_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Derivatives.hpp"
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+
+namespace RT {
+
+// - Closed interval -------------------------------------------------------------------------------
+template <typename PassiveType>
+struct Interval {
+  PassiveType lower = static_cast<PassiveType>(0);
+  PassiveType upper = static_cast<PassiveType>(0);
+
+  [[nodiscard]] constexpr auto contains(const PassiveType& x) const noexcept -> bool {
+    return lower <= x && x <= upper;
+  }
+
+  [[nodiscard]] constexpr auto width() const noexcept -> PassiveType { return upper - lower; }
+
+  // Largest absolute value in the interval
+  [[nodiscard]] constexpr auto magnitude() const noexcept -> PassiveType {
+    return std::max(std::abs(lower), std::abs(upper));
+  }
+};
+
+namespace detail {
+
+// - Interval operations with outward rounding -----------------------------------------------------
+// The bounds are computed in round to nearest and widened by one ulp, this contains the exact
+// result for all correctly rounded operations and for `std::sin`, `std::cos` of common libm.
+template <typename PassiveType>
+[[nodiscard]] auto round_down(PassiveType x) noexcept -> PassiveType {
+  return std::nextafter(x, -std::numeric_limits<PassiveType>::infinity());
+}
+
+template <typename PassiveType>
+[[nodiscard]] auto round_up(PassiveType x) noexcept -> PassiveType {
+  return std::nextafter(x, std::numeric_limits<PassiveType>::infinity());
+}
+
+template <typename PassiveType>
+[[nodiscard]] auto widen(PassiveType lower, PassiveType upper) noexcept -> Interval<PassiveType> {
+  return {round_down(lower), round_up(upper)};
+}
+
+template <typename PassiveType>
+[[nodiscard]] auto whole_line() noexcept -> Interval<PassiveType> {
+  return {-std::numeric_limits<PassiveType>::infinity(),
+          std::numeric_limits<PassiveType>::infinity()};
+}
+
+// Product of two bounds with 0 * inf = 0, the bounds are limits of real numbers, i.e. 0 is only
+// multiplied with finite values
+template <typename PassiveType>
+[[nodiscard]] auto bound_mul(PassiveType x, PassiveType y) noexcept -> PassiveType {
+  constexpr auto zero = static_cast<PassiveType>(0);
+  return x == zero || y == zero ? zero : x * y;
+}
+
+template <typename PassiveType>
+[[nodiscard]] auto interval_mul(const Interval<PassiveType>& a, const Interval<PassiveType>& b)
+    -> Interval<PassiveType> {
+  const PassiveType p[] = {bound_mul(a.lower, b.lower),
+                           bound_mul(a.lower, b.upper),
+                           bound_mul(a.upper, b.lower),
+                           bound_mul(a.upper, b.upper)};
+  return widen(*std::min_element(std::begin(p), std::end(p)),
+               *std::max_element(std::begin(p), std::end(p)));
+}
+
+template <typename PassiveType>
+[[nodiscard]] auto interval_inv(const Interval<PassiveType>& a) -> Interval<PassiveType> {
+  if (a.contains(static_cast<PassiveType>(0))) {
+    return whole_line<PassiveType>();
+  }
+  return widen(static_cast<PassiveType>(1) / a.upper, static_cast<PassiveType>(1) / a.lower);
+}
+
+// Range of sin(x + shift) over `a`, the maxima are at pi / 2 + 2 k pi and the minima at -pi / 2 +
+// 2 k pi
+template <typename PassiveType>
+[[nodiscard]] auto interval_sin(const Interval<PassiveType>& a, PassiveType shift)
+    -> Interval<PassiveType> {
+  constexpr auto pi  = std::numbers::pi_v<PassiveType>;
+  constexpr auto one = static_cast<PassiveType>(1);
+  if (!std::isfinite(a.lower) || !std::isfinite(a.upper) || a.width() >= 2 * pi) {
+    return {-one, one};
+  }
+
+  const auto lower      = a.lower + shift;
+  const auto upper      = a.upper + shift;
+  const auto contains_k = [&](PassiveType offset) {
+    const auto k = std::ceil((round_down(lower) - offset) / (2 * pi));
+    return offset + 2 * pi * k <= round_up(upper);
+  };
+
+  const auto s0 = std::sin(lower);
+  const auto s1 = std::sin(upper);
+  auto res      = widen(std::min(s0, s1), std::max(s0, s1));
+  if (contains_k(pi / 2)) {
+    res.upper = one;
+  }
+  if (contains_k(-pi / 2)) {
+    res.lower = -one;
+  }
+  return {std::max(res.lower, -one), std::min(res.upper, one)};
+}
+
+// - Interval extension of a single operation ------------------------------------------------------
+template <typename PassiveType, typename ArgFunc>
+[[nodiscard]] auto interval_operation(NodeType op,
+                                      int64_t attribute,
+                                      size_t num_args,
+                                      const ArgFunc& arg) -> Interval<PassiveType> {
+  constexpr auto zero = static_cast<PassiveType>(0);
+  constexpr auto one  = static_cast<PassiveType>(1);
+
+  switch (op) {
+    case NodeType::LITERAL:
+    case NodeType::VAR:
+    case NodeType::GUARD:
+      return arg(0);
+    case NodeType::NEG:
+      return {-arg(0).upper, -arg(0).lower};
+    case NodeType::ADD:
+      return widen(arg(0).lower + arg(1).lower, arg(0).upper + arg(1).upper);
+    case NodeType::SUB:
+      return widen(arg(0).lower - arg(1).upper, arg(0).upper - arg(1).lower);
+    case NodeType::MUL:
+      return interval_mul(arg(0), arg(1));
+    case NodeType::INV:
+      return interval_inv(arg(0));
+    case NodeType::DIV:
+      return interval_mul(arg(0), interval_inv(arg(1)));
+    case NodeType::SQRT:
+      {
+        if (arg(0).upper < zero) {
+          const auto nan = std::numeric_limits<PassiveType>::quiet_NaN();
+          return {nan, nan};
+        }
+        const auto res = widen(std::sqrt(std::max(arg(0).lower, zero)), std::sqrt(arg(0).upper));
+        return {std::max(res.lower, zero), res.upper};
+      }
+    case NodeType::SIN:
+      return interval_sin(arg(0), zero);
+    case NodeType::COS:
+      return interval_sin(arg(0), std::numbers::pi_v<PassiveType> / 2);
+    case NodeType::CMP:
+      {
+        const auto cmp    = static_cast<ComparisonType>(attribute);
+        const auto& a     = arg(0);
+        const auto& b     = arg(1);
+        bool always       = false;
+        bool never        = false;
+        const bool a_lt_b = a.upper < b.lower;
+        const bool a_gt_b = a.lower > b.upper;
+        const bool a_eq_b = a.lower == a.upper && b.lower == b.upper && a.lower == b.lower;
+        const bool a_le_b = a.upper <= b.lower;
+        const bool a_ge_b = a.lower >= b.upper;
+        switch (cmp) {
+          case ComparisonType::LT:
+            always = a_lt_b;
+            never  = a_ge_b;
+            break;
+          case ComparisonType::LE:
+            always = a_le_b;
+            never  = a_gt_b;
+            break;
+          case ComparisonType::GT:
+            always = a_gt_b;
+            never  = a_le_b;
+            break;
+          case ComparisonType::GE:
+            always = a_ge_b;
+            never  = a_lt_b;
+            break;
+          case ComparisonType::EQ:
+            always = a_eq_b;
+            never  = a_lt_b || a_gt_b;
+            break;
+          case ComparisonType::NE:
+            always = a_lt_b || a_gt_b;
+            never  = a_eq_b;
+            break;
+        }
+        return {always ? one : zero, never ? zero : one};
+      }
+    case NodeType::SELECT:
+      if (!arg(0).contains(zero)) {
+        return arg(1);
+      }
+      if (arg(0).lower == zero && arg(0).upper == zero) {
+        return arg(2);
+      }
+      return {std::min(arg(1).lower, arg(2).lower), std::max(arg(1).upper, arg(2).upper)};
+    case NodeType::SUM:
+      {
+        Interval<PassiveType> res = arg(0);
+        for (size_t i = 1; i < num_args; ++i) {
+          res = widen(res.lower + arg(i).lower, res.upper + arg(i).upper);
+        }
+        return res;
+      }
+    case NodeType::DOT:
+      {
+        const auto n              = num_args / 2;
+        Interval<PassiveType> res = interval_mul(arg(0), arg(n));
+        for (size_t i = 1; i < n; ++i) {
+          const auto p = interval_mul(arg(i), arg(n + i));
+          res          = widen(res.lower + p.lower, res.upper + p.upper);
+        }
+        return res;
+      }
+    case NodeType::CUSTOM:
+      // Nothing is known about the range of a custom operation
+      return whole_line<PassiveType>();
+    default:
+      RT_PANIC("Operation " << op << " is not supported in interval arithmetic.");
+  }
+}
+
+// - Local rounding error of a single operation ----------------------------------------------------
+// Bound of the absolute rounding error of the operation itself for exact arguments, `u` is the
+// unit roundoff of the precision the operation is evaluated in
+template <typename PassiveType, typename ArgFunc>
+[[nodiscard]] auto local_rounding_error(NodeType op,
+                                        size_t num_args,
+                                        const ArgFunc& arg,
+                                        const PassiveType& value,
+                                        const PassiveType& u) -> PassiveType {
+  switch (op) {
+    case NodeType::LITERAL:
+    case NodeType::VAR:
+    case NodeType::NEG:
+    case NodeType::CMP:
+    case NodeType::SELECT:
+    case NodeType::GUARD:
+      return static_cast<PassiveType>(0);
+    case NodeType::SUM:
+      {
+        // Recursive summation, every partial sum is rounded
+        PassiveType sum = static_cast<PassiveType>(0);
+        for (size_t i = 0; i < num_args; ++i) {
+          sum += std::abs(arg(i));
+        }
+        return static_cast<PassiveType>(num_args - 1) * u * sum;
+      }
+    case NodeType::DOT:
+      {
+        const auto n    = num_args / 2;
+        PassiveType sum = static_cast<PassiveType>(0);
+        for (size_t i = 0; i < n; ++i) {
+          sum += std::abs(arg(i) * arg(n + i));
+        }
+        return static_cast<PassiveType>(n) * u * sum;
+      }
+    default:
+      return u * std::abs(value);
+  }
+}
+
+}  // namespace detail
+
+// - Interval sweep --------------------------------------------------------------------------------
+// Evaluates the tape in interval arithmetic, the result contains the value of every node for all
+// inputs in the given intervals (one per registered input). Constants are point intervals of the
+// recorded values. Guards are replayed as recorded, `uncertain_guards` returns the guards that may
+// take the other branch.
+template <typename PassiveType>
+[[nodiscard]] auto interval_sweep(const Tape<PassiveType>& tape,
+                                  std::span<const Interval<PassiveType>> inputs)
+    -> std::vector<Interval<PassiveType>> {
+  static_assert(std::is_floating_point_v<PassiveType>,
+                "Interval arithmetic requires a floating point type as `PassiveType`.");
+  RT_ASSERT(inputs.size() == tape.inputs().size(),
+            "Expected " << tape.inputs().size() << " inputs, but got " << inputs.size());
+
+  std::vector<Interval<PassiveType>> intervals(tape.num_nodes());
+  for (size_t idx = 0; idx < tape.num_nodes(); ++idx) {
+    intervals[idx] = {tape.values()[idx], tape.values()[idx]};
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    intervals[static_cast<size_t>(tape.inputs()[i])] = inputs[i];
+  }
+
+  for (int64_t id = 0; id < static_cast<int64_t>(tape.num_nodes()); ++id) {
+    const auto args = tape.args(id);
+    if (args.empty()) {
+      continue;
+    }
+    intervals[static_cast<size_t>(id)] = detail::interval_operation<PassiveType>(
+        tape.op(id), tape.attribute(id), args.size(), [&](size_t i) -> const auto& {
+          return intervals[static_cast<size_t>(args[i])];
+        });
+  }
+  return intervals;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Guards whose condition is not certain over the intervals of an `interval_sweep`
+template <typename PassiveType>
+[[nodiscard]] auto uncertain_guards(const Tape<PassiveType>& tape,
+                                    std::span<const Interval<PassiveType>> intervals)
+    -> std::vector<int64_t> {
+  RT_ASSERT(intervals.size() == tape.num_nodes(),
+            "Expected " << tape.num_nodes() << " intervals, but got " << intervals.size());
+  std::vector<int64_t> guards{};
+  for (int64_t id = 0; id < static_cast<int64_t>(tape.num_nodes()); ++id) {
+    if (tape.op(id) != NodeType::GUARD) {
+      continue;
+    }
+    const auto& cond = intervals[static_cast<size_t>(id)];
+    const bool holds = tape.attribute(id) != 0 ? !cond.contains(static_cast<PassiveType>(0))
+                                               : cond.lower == 0 && cond.upper == 0;
+    if (!holds) {
+      guards.push_back(id);
+    }
+  }
+  return guards;
+}
+
+// - Rounding error sweep --------------------------------------------------------------------------
+// First order bound of the absolute error of every node if all operations, inputs and constants
+// are rounded with unit roundoff `unit_roundoff`, e.g. `std::numeric_limits<float>::epsilon() / 2`
+// for a replay in float. The error of the arguments is propagated with the absolute value of the
+// local partial derivatives, changes of comparisons are not taken into account.
+template <typename PassiveType>
+[[nodiscard]] auto rounding_error_sweep(const Tape<PassiveType>& tape,
+                                        std::span<const PassiveType> values,
+                                        PassiveType unit_roundoff) -> std::vector<PassiveType> {
+  static_assert(std::is_floating_point_v<PassiveType>,
+                "Error analysis requires a floating point type as `PassiveType`.");
+  RT_ASSERT(values.size() == tape.num_nodes(),
+            "Expected " << tape.num_nodes() << " values, but got " << values.size());
+
+  std::vector<PassiveType> errors(tape.num_nodes());
+  for (int64_t id = 0; id < static_cast<int64_t>(tape.num_nodes()); ++id) {
+    const auto idx    = static_cast<size_t>(id);
+    const auto args   = tape.args(id);
+    const auto& value = values[idx];
+    if (args.empty()) {
+      errors[idx] = unit_roundoff * std::abs(value);
+      continue;
+    }
+
+    const auto arg = [&](size_t i) -> const PassiveType& {
+      return values[static_cast<size_t>(args[i])];
+    };
+    PassiveType error = detail::local_rounding_error(tape.op(id), args.size(), arg, value,
+                                                      unit_roundoff);
+    for (size_t i = 0; i < args.size(); ++i) {
+      const auto arg_error = errors[static_cast<size_t>(args[i])];
+      if (arg_error != static_cast<PassiveType>(0)) {
+        error += arg_error * std::abs(detail::local_partial<PassiveType>(
+                                 tape.op(id), tape.attribute(id), args.size(), arg, value, i));
+      }
+    }
+    errors[idx] = error;
+  }
+  return errors;
+}
+
+// - Precision analysis ----------------------------------------------------------------------------
+template <typename PassiveType>
+struct PrecisionAnalysis {
+  // Sum over the outputs of |d output / d node| / |output|
+  std::vector<PassiveType> sensitivities{};
+  // First order relative error of the outputs if only this node is rounded to float
+  std::vector<PassiveType> float_errors{};
+  // First order change of the decided values relative to their distance from the decision
+  // boundary if only this node is rounded to float, a decision can flip if this reaches one
+  std::vector<PassiveType> flip_risks{};
+  // Nodes with `float_errors` below the tolerance that cannot flip a decision
+  std::vector<bool> float_safe{};
+  size_t num_float_safe = 0;
+};
+
+// -------------------------------------------------------------------------------------------------
+// Classifies which nodes can be evaluated in float while the other nodes stay in `PassiveType`. A
+// reverse sweep with the absolute values of the local partial derivatives gives the sensitivity of
+// the outputs to every node; rounding a node to float perturbs it by at most `u |value|` with the
+// unit roundoff `u` of float. A node is float safe if this changes the outputs by at most
+// `tolerance` relative to their values. The errors of several float nodes add up (to first
+// order), i.e. the tolerance should be divided by the expected number of float nodes on a path.
+//
+// Comparisons, guards and the condition of a select have no derivative, instead the difference of
+// the compared values (the condition for guards and selects) is propagated in the same way with
+// weight one over its magnitude. Nodes for which rounding to float can reach the decision boundary
+// are not float safe.
+template <typename PassiveType>
+[[nodiscard]] auto analyze_precision(const Tape<PassiveType>& tape,
+                                     std::span<const PassiveType> values,
+                                     std::span<const int64_t> outputs,
+                                     PassiveType tolerance) -> PrecisionAnalysis<PassiveType> {
+  static_assert(std::is_floating_point_v<PassiveType>,
+                "Error analysis requires a floating point type as `PassiveType`.");
+  RT_ASSERT(values.size() == tape.num_nodes(),
+            "Expected " << tape.num_nodes() << " values, but got " << values.size());
+
+  PrecisionAnalysis<PassiveType> analysis{
+      .sensitivities = std::vector<PassiveType>(tape.num_nodes()),
+      .float_errors  = std::vector<PassiveType>(tape.num_nodes()),
+      .flip_risks    = std::vector<PassiveType>(tape.num_nodes()),
+      .float_safe    = std::vector<bool>(tape.num_nodes())};
+  auto& sensitivities = analysis.sensitivities;
+  for (auto out : outputs) {
+    RT_ASSERT(out >= 0 && static_cast<size_t>(out) < tape.num_nodes(),
+              "Node with id " << out << " is not part of the graph.");
+    const auto magnitude = std::abs(values[static_cast<size_t>(out)]);
+    sensitivities[static_cast<size_t>(out)] +=
+        magnitude > static_cast<PassiveType>(0) ? static_cast<PassiveType>(1) / magnitude
+                                                : static_cast<PassiveType>(1);
+  }
+
+  // Sum over the decisions of |d (lhs - rhs) / d node| / |lhs - rhs|, a tie has the largest finite
+  // weight instead of an infinite one
+  std::vector<PassiveType> flip_sensitivities(tape.num_nodes());
+  const auto decision_weight = [](PassiveType margin) {
+    return static_cast<PassiveType>(1) /
+           std::max(std::abs(margin), std::numeric_limits<PassiveType>::min());
+  };
+
+  for (auto id = static_cast<int64_t>(tape.num_nodes()) - 1; id >= 0; --id) {
+    const auto args = tape.args(id);
+    if (args.empty()) {
+      continue;
+    }
+    const auto arg = [&](size_t i) -> const PassiveType& {
+      return values[static_cast<size_t>(args[i])];
+    };
+
+    const auto op = tape.op(id);
+    if (op == NodeType::CMP) {
+      const auto weight = decision_weight(arg(0) - arg(1));
+      flip_sensitivities[static_cast<size_t>(args[0])] += weight;
+      flip_sensitivities[static_cast<size_t>(args[1])] += weight;
+    } else if (op == NodeType::GUARD || op == NodeType::SELECT) {
+      flip_sensitivities[static_cast<size_t>(args[0])] += decision_weight(arg(0));
+    }
+
+    const auto sensitivity      = sensitivities[static_cast<size_t>(id)];
+    const auto flip_sensitivity = flip_sensitivities[static_cast<size_t>(id)];
+    if (sensitivity == static_cast<PassiveType>(0) &&
+        flip_sensitivity == static_cast<PassiveType>(0)) {
+      continue;
+    }
+    for (size_t i = 0; i < args.size(); ++i) {
+      const auto partial = std::abs(detail::local_partial<PassiveType>(
+          op, tape.attribute(id), args.size(), arg, values[static_cast<size_t>(id)], i));
+      // Skip zero partials, the flip sensitivity of a near tie can overflow to infinity
+      if (partial != static_cast<PassiveType>(0)) {
+        sensitivities[static_cast<size_t>(args[i])] += sensitivity * partial;
+        flip_sensitivities[static_cast<size_t>(args[i])] += flip_sensitivity * partial;
+      }
+    }
+  }
+
+  constexpr auto float_roundoff =
+      static_cast<PassiveType>(std::numeric_limits<float>::epsilon()) / 2;
+  for (size_t idx = 0; idx < tape.num_nodes(); ++idx) {
+    // The result of a comparison is exact in float, the flip risk of its arguments covers it. A
+    // zero is exact as well, this also avoids 0 * inf for the flip risk.
+    const auto op        = tape.op(static_cast<int64_t>(idx));
+    const auto magnitude = std::abs(values[idx]);
+    const bool exact =
+        op == NodeType::CMP || op == NodeType::GUARD || magnitude == static_cast<PassiveType>(0);
+    const auto error =
+        exact ? static_cast<PassiveType>(0) : sensitivities[idx] * float_roundoff * magnitude;
+    const auto flip_risk =
+        exact ? static_cast<PassiveType>(0) : flip_sensitivities[idx] * float_roundoff * magnitude;
+    const bool safe = error <= tolerance && flip_risk < static_cast<PassiveType>(1);
+    analysis.float_errors[idx] = error;
+    analysis.flip_risks[idx]   = flip_risk;
+    analysis.float_safe[idx]   = safe;
+    analysis.num_float_safe += safe ? 1ul : 0ul;
+  }
+  return analysis;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Same as above, uses the recorded values
+template <typename PassiveType>
+[[nodiscard]] auto analyze_precision(const Graph<PassiveType>& graph,
+                                     std::span<const int64_t> outputs,
+                                     PassiveType tolerance) -> PrecisionAnalysis<PassiveType> {
+  const Tape<PassiveType> tape(graph);
+  return analyze_precision(tape, std::span<const PassiveType>(tape.values()), outputs, tolerance);
+}
+
+}  // namespace RT
+
+#endif  // RT_ERROR_ANALYSIS_HPP_
@@ -0,0 +1,94 @@
+#ifndef RT_EVALUATOR_HPP_
+#define RT_EVALUATOR_HPP_
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+
+namespace RT {
+
+// - Replay a recorded graph with new inputs -------------------------------------------------------
+// The inputs are the nodes registered via `register_graph` in the order they were registered. All
+// other nodes without dependencies are constants and keep their recorded value.
+template <typename PassiveType>
+class Evaluator {
+  Tape<PassiveType> m_tape;
+  std::vector<PassiveType> m_values{};
+  std::vector<int64_t> m_violated_guards{};
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  explicit Evaluator(const Graph<PassiveType>& graph)
+      : m_tape(graph),
+        m_values(m_tape.values()) {}
+
+  // -----------------------------------------------------------------------------------------------
+  // Recompute the values of all nodes in a single forward sweep
+  void evaluate(std::span<const PassiveType> inputs) {
+    const auto& input_ids = m_tape.inputs();
+    RT_ASSERT(inputs.size() == input_ids.size(),
+              "Expected " << input_ids.size() << " inputs, but got " << inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      m_values[static_cast<size_t>(input_ids[i])] = inputs[i];
+    }
+
+    m_violated_guards.clear();
+    for (int64_t id = 0; id < static_cast<int64_t>(m_tape.num_nodes()); ++id) {
+      const auto args = m_tape.args(id);
+      if (args.empty()) {
+        continue;
+      }
+
+      const auto op  = m_tape.op(id);
+      const auto idx = static_cast<size_t>(id);
+      m_values[idx]  = detail::apply_operation<PassiveType>(
+          op, m_tape.attribute(id), args.size(), [&](size_t i) -> const PassiveType& {
+            return m_values[static_cast<size_t>(args[i])];
+          });
+
+      if constexpr (!is_matrix_type_v<PassiveType>) {
+        if (op == NodeType::GUARD &&
+            static_cast<int64_t>(m_values[idx] != static_cast<PassiveType>(0)) !=
+                m_tape.attribute(id)) {
+          m_violated_guards.push_back(id);
+        }
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto value(int64_t id) const noexcept -> const PassiveType& {
+    RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_values.size(),
+              "Node with id " << id << " is not part of the graph.");
+    return m_values[static_cast<size_t>(id)];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto values() const noexcept -> const std::vector<PassiveType>& {
+    return m_values;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // The replay follows the recorded control flow only if all guards hold, otherwise the graph has
+  // to be recorded again
+  [[nodiscard]] constexpr auto guards_hold() const noexcept -> bool {
+    return m_violated_guards.empty();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto violated_guards() const noexcept -> const std::vector<int64_t>& {
+    return m_violated_guards;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto tape() const noexcept -> const Tape<PassiveType>& { return m_tape; }
+};
+
+}  // namespace RT
+
+#endif  // RT_EVALUATOR_HPP_
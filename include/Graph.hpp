@@ -4,9 +4,13 @@
 #include <cstring>
 #include <fstream>
 #include <numeric>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
+#include "CustomOp.hpp"
 #include "NodeType.hpp"
+#include "TypeTraits.hpp"
 
 namespace RT {
 
@@ -20,6 +24,12 @@ struct GraphToDotOptions {
   bool use_op_symbols       = false;  // Operatrion like ADD and MUL are shown as Symbols
 };
 
+// Shape of the value of a node, scalars have shape 1x1
+struct Shape {
+  int64_t rows = 1;
+  int64_t cols = 1;
+};
+
 template <typename T>
 concept RecordTypeId = std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, int64_t>;
 
@@ -29,6 +39,10 @@ class Graph {
   std::vector<int64_t> m_dependencies{};
   std::vector<NodeType> m_operations{};
   std::vector<PassiveType> m_values{};
+  std::unordered_map<int64_t, int64_t> m_attributes{};  // Additional data, e.g. ComparisonType
+  std::vector<Shape> m_shapes{};                        // Only used for matrix types
+  std::vector<int64_t> m_inputs{};                      // Nodes registered via `register_graph`
+  std::vector<int64_t> m_iteration_state{};             // State at the end of an iteration
 
  public:
   // -----------------------------------------------------------------------------------------------
@@ -41,6 +55,15 @@ class Graph {
     m_dependencies.push_back(-static_cast<int64_t>(sizeof...(ids)));
   }
 
+  // -----------------------------------------------------------------------------------------------
+  constexpr void add_dependencies(std::span<const int64_t> ids) noexcept {
+    if (ids.empty()) {
+      return;
+    }
+    m_dependencies.insert(std::end(m_dependencies), std::cbegin(ids), std::cend(ids));
+    m_dependencies.push_back(-static_cast<int64_t>(ids.size()));
+  }
+
   // -----------------------------------------------------------------------------------------------
   [[nodiscard]] constexpr auto add_operation(NodeType op, PassiveType value) noexcept -> int64_t {
     RT_ASSERT(m_operations.size() == m_values.size(),
@@ -49,10 +72,97 @@ class Graph {
     const auto id = static_cast<int64_t>(m_operations.size());
     m_dependencies.push_back(id);
     m_operations.push_back(op);
+    if constexpr (is_matrix_type_v<PassiveType>) {
+      m_shapes.push_back(Shape{.rows = static_cast<int64_t>(value.rows()),
+                               .cols = static_cast<int64_t>(value.cols())});
+    }
     m_values.push_back(std::move(value));
     return id;
   }
 
+  // -----------------------------------------------------------------------------------------------
+  // Independent variable, its value is an input when the graph is evaluated again
+  [[nodiscard]] constexpr auto add_input(NodeType op, PassiveType value) noexcept -> int64_t {
+    const auto id = add_operation(op, std::move(value));
+    m_inputs.push_back(id);
+    return id;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Marks the end of one iteration of a time-stepping loop: the graph records a single step, its
+  // inputs are the state at the beginning and `state` are the nodes passed to the next step
+  constexpr void mark_iteration_boundary(std::span<const int64_t> state) noexcept {
+    RT_ASSERT(state.size() == m_inputs.size(),
+              "Expected state of size " << m_inputs.size() << ", but got " << state.size());
+    for (auto id : state) {
+      RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_operations.size(),
+                "Node with id " << id << " is not part of the graph.");
+    }
+    m_iteration_state.assign(std::cbegin(state), std::cend(state));
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  constexpr void set_attribute(int64_t id, int64_t attribute) noexcept {
+    RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_operations.size(),
+              "Node with id " << id << " is not part of the graph.");
+    m_attributes[id] = attribute;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto attribute(int64_t id) const noexcept -> int64_t {
+    const auto it = m_attributes.find(id);
+    RT_ASSERT(it != std::cend(m_attributes), "Node with id " << id << " has no attribute.");
+    return it->second;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto shape(int64_t id) const noexcept -> Shape {
+    RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_operations.size(),
+              "Node with id " << id << " is not part of the graph.");
+    if constexpr (is_matrix_type_v<PassiveType>) {
+      return m_shapes[static_cast<size_t>(id)];
+    } else {
+      return Shape{};
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Calls `func(id, op, args)` for every node in the order the nodes were added, `args` are the ids
+  // of the nodes the node depends on
+  template <typename Func>
+  constexpr void for_each_node(Func&& func) const {
+    auto dep_it = std::cbegin(m_dependencies);
+    for (int64_t id = 0; id < static_cast<int64_t>(m_operations.size()); ++id) {
+      RT_ASSERT(dep_it != std::cend(m_dependencies),
+                "`dep_it` should not have reached the end of the array");
+
+      // The dependencies of a node can never contain the node itself
+      if (*dep_it == id) {
+        func(id, m_operations[static_cast<size_t>(id)], std::span<const int64_t>{});
+        ++dep_it;
+        continue;
+      }
+
+      const auto args_begin = dep_it;
+      while (*dep_it >= 0) {
+        ++dep_it;
+        RT_ASSERT(dep_it != std::cend(m_dependencies),
+                  "`dep_it` should not have reached the end of the array");
+      }
+      const auto num_deps = static_cast<size_t>(-*dep_it);
+      RT_ASSERT(static_cast<size_t>(dep_it - args_begin) == num_deps,
+                "Expected " << num_deps << " dependencies, but got " << dep_it - args_begin);
+      ++dep_it;
+      RT_ASSERT(dep_it != std::cend(m_dependencies) && *dep_it == id,
+                "Expected node " << id << " after its dependencies.");
+      ++dep_it;
+
+      func(id,
+           m_operations[static_cast<size_t>(id)],
+           std::span<const int64_t>(args_begin, num_deps));
+    }
+  }
+
   // -----------------------------------------------------------------------------------------------
   [[nodiscard]] constexpr auto count_ops() const noexcept -> size_t {
     return std::accumulate(std::cbegin(m_operations),
@@ -73,6 +183,44 @@ class Graph {
                            });
   }
 
+  // -----------------------------------------------------------------------------------------------
+  // Number of floating point operations, for matrix types this considers the shape of the operands,
+  // e.g. a GEMM of a (m x k) and a (k x n) matrix counts 2mnk operations
+  [[nodiscard]] constexpr auto count_flops() const noexcept -> size_t {
+    size_t flops = 0ul;
+    for_each_node([&](int64_t id, NodeType op, std::span<const int64_t> args) {
+      if (!is_op(op)) {
+        return;
+      }
+      const auto [rows, cols] = shape(id);
+      switch (op) {
+        case NodeType::GEMM:
+          {
+            RT_ASSERT(args.size() == 2, "Expected two dependencies, but got " << args.size());
+            const auto inner = shape(args[0]).cols;
+            flops += static_cast<size_t>(2 * rows * cols * inner);
+          }
+          break;
+        case NodeType::SOLVE:
+          {
+            // LU decomposition of the (n x n) matrix and forward and backward substitution
+            RT_ASSERT(args.size() == 2, "Expected two dependencies, but got " << args.size());
+            const auto n = shape(args[0]).rows;
+            flops += static_cast<size_t>(2 * n * n * n / 3 + 2 * n * n * cols);
+          }
+          break;
+        case NodeType::SUM:
+        case NodeType::DOT:
+          // DOT has 2n arguments and needs n multiplications and n - 1 additions
+          flops += static_cast<size_t>(rows * cols) * (args.size() - 1ul);
+          break;
+        default:
+          flops += static_cast<size_t>(rows * cols);
+      }
+    });
+    return flops;
+  }
+
   // -----------------------------------------------------------------------------------------------
   // TODO: Use GraphToDotOptions
   void to_dot(const std::string& file_name,
@@ -89,8 +237,17 @@ class Graph {
               "`m_operations` and `m_values` must have same size, but sizes are size(m_operations)="
                   << m_operations.size() << " and size(m_values)=" << m_values.size());
     for (size_t id = 0ul; id < m_operations.size(); ++id) {
-      out << "  node_" << id << " [label=\"node_" << id << " (" << m_operations[id] << ", "
-          << m_values[id] << ")\"];\n";
+      out << "  node_" << id << " [label=\"node_" << id << " (" << m_operations[id];
+      if (m_operations[id] == NodeType::CMP) {
+        out << ' ' << to_string(static_cast<ComparisonType>(attribute(static_cast<int64_t>(id))));
+      }
+      if (m_operations[id] == NodeType::CUSTOM) {
+        out << ' ' << CustomOpRegistry<PassiveType>::get(attribute(static_cast<int64_t>(id))).name;
+      }
+      if constexpr (is_matrix_type_v<PassiveType>) {
+        out << ", " << m_shapes[id].rows << 'x' << m_shapes[id].cols;
+      }
+      out << ", " << m_values[id] << ")\"];\n";
     }
 
     for (auto it = std::crbegin(m_dependencies); it != std::crend(m_dependencies);) {
@@ -142,6 +299,22 @@ class Graph {
     return m_values;
   }
 
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto inputs() const noexcept -> const std::vector<int64_t>& {
+    return m_inputs;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto iteration_state() const noexcept -> const std::vector<int64_t>& {
+    return m_iteration_state;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto attributes() const noexcept
+      -> const std::unordered_map<int64_t, int64_t>& {
+    return m_attributes;
+  }
+
   // -----------------------------------------------------------------------------------------------
   constexpr void dump_data(std::ostream& out) const noexcept {
     out << "dependencies: ";
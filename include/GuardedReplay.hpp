@@ -0,0 +1,224 @@
+#ifndef RT_GUARDED_REPLAY_HPP_
+#define RT_GUARDED_REPLAY_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "RecordType.hpp"
+#include "Tape.hpp"
+
+namespace RT {
+
+// - Replay with automatic re-recording on control flow divergence ---------------------------------
+// Evaluates `function` for new inputs by replaying a recorded trace. The guards recorded by the
+// comparison operators of `RecordType` are checked during the replay; the replay stops at the first
+// violated guard. All traces that took the same branches up to this guard share the nodes before
+// it, so the replay continues with a cached trace that took the other branch and only the
+// divergent part after the guard is evaluated. If no cached trace took this branch, `function` is
+// recorded again for the current inputs and the new trace is added to the cache. Workloads where
+// the branches rarely change are replayed most of the time.
+//
+// The cache holds at most `max_traces` traces, the least recently used trace is dropped first.
+template <typename PassiveType>
+class GuardedReplay {
+  static_assert(!is_matrix_type_v<PassiveType>, "Guarded replay requires a scalar type.");
+
+ public:
+  using Function = std::function<std::vector<RecordType<PassiveType>>(
+      const std::vector<RecordType<PassiveType>>& inputs)>;
+
+ private:
+  struct Trace {
+    Tape<PassiveType> tape;
+    std::vector<int64_t> output_ids{};
+    std::vector<int64_t> guard_ids{};  // In the order of recording
+    std::vector<PassiveType> values{};
+  };
+
+  Function m_function;
+  size_t m_max_traces;
+  std::vector<std::unique_ptr<Trace>> m_traces{};  // The most recently used trace first
+  std::vector<PassiveType> m_outputs{};
+
+  size_t m_num_replays  = 0;
+  size_t m_num_switches = 0;
+  size_t m_num_records  = 0;
+
+  // Evaluates the nodes starting at `begin`, `first_guard` is the index of the first guard of the
+  // trace after `begin`. Returns the index of the first violated guard or the number of guards.
+  [[nodiscard]] static auto replay(Trace& trace, int64_t begin, size_t first_guard) -> size_t {
+    const auto& tape = trace.tape;
+    auto& values     = trace.values;
+    auto guard       = first_guard;
+    for (int64_t id = begin; id < static_cast<int64_t>(tape.num_nodes()); ++id) {
+      const auto args = tape.args(id);
+      if (args.empty()) {
+        continue;
+      }
+
+      const auto op  = tape.op(id);
+      const auto idx = static_cast<size_t>(id);
+      values[idx]    = detail::apply_operation<PassiveType>(
+          op, tape.attribute(id), args.size(), [&](size_t i) -> const PassiveType& {
+            return values[static_cast<size_t>(args[i])];
+          });
+
+      if (op == NodeType::GUARD) {
+        if (static_cast<int64_t>(values[idx] != static_cast<PassiveType>(0)) !=
+            tape.attribute(id)) {
+          return guard;
+        }
+        ++guard;
+      }
+    }
+    return guard;
+  }
+
+  // Cached trace that took the same branches as `trace` before its guard `guard` and the other
+  // branch at `guard`
+  [[nodiscard]] auto find_divergent_trace(const Trace& trace, size_t guard) const -> size_t {
+    const auto branch_taken = [](const Trace& t, size_t g) {
+      return t.tape.attribute(t.guard_ids[g]);
+    };
+    for (size_t t = 0; t < m_traces.size(); ++t) {
+      const auto& other = *m_traces[t];
+      if (&other == &trace || other.guard_ids.size() <= guard ||
+          other.guard_ids[guard] != trace.guard_ids[guard] ||
+          branch_taken(other, guard) == branch_taken(trace, guard)) {
+        continue;
+      }
+      bool same_prefix = true;
+      for (size_t g = 0; g < guard && same_prefix; ++g) {
+        same_prefix = branch_taken(other, g) == branch_taken(trace, g);
+      }
+      if (same_prefix) {
+        return t;
+      }
+    }
+    return m_traces.size();
+  }
+
+  // Record `m_function` for `inputs` and add the trace to the front of the cache
+  void record(std::span<const PassiveType> inputs) {
+    auto graph = std::make_shared<Graph<PassiveType>>();
+    std::vector<RecordType<PassiveType>> x(std::cbegin(inputs), std::cend(inputs));
+    register_variable(x, graph);
+    const auto y = m_function(x);
+
+    auto trace    = std::make_unique<Trace>(Trace{.tape = Tape<PassiveType>(*graph)});
+    trace->values = trace->tape.values();
+    for (int64_t id = 0; id < static_cast<int64_t>(trace->tape.num_nodes()); ++id) {
+      if (trace->tape.op(id) == NodeType::GUARD) {
+        trace->guard_ids.push_back(id);
+      }
+    }
+    m_outputs.resize(y.size());
+    for (size_t i = 0; i < y.size(); ++i) {
+      RT_ASSERT(y[i].id() != UNREGISTERED, "Output " << i << " does not depend on the inputs.");
+      trace->output_ids.push_back(y[i].id());
+      m_outputs[i] = y[i].value();
+    }
+
+    if (m_traces.size() == m_max_traces) {
+      m_traces.pop_back();
+    }
+    m_traces.insert(std::begin(m_traces), std::move(trace));
+    ++m_num_records;
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  explicit GuardedReplay(Function function, size_t max_traces = 16ul)
+      : m_function(std::move(function)),
+        m_max_traces(max_traces) {
+    RT_ASSERT(m_max_traces > 0, "At least one trace has to be cached.");
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Outputs of `function` for `inputs`, replays a cached trace if possible
+  auto evaluate(std::span<const PassiveType> inputs) -> const std::vector<PassiveType>& {
+    if (m_traces.empty()) {
+      record(inputs);
+      return m_outputs;
+    }
+
+    size_t t = 0;
+    {
+      auto& trace           = *m_traces.front();
+      const auto& input_ids = trace.tape.inputs();
+      RT_ASSERT(inputs.size() == input_ids.size(),
+                "Expected " << input_ids.size() << " inputs, but got " << inputs.size());
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        trace.values[static_cast<size_t>(input_ids[i])] = inputs[i];
+      }
+    }
+
+    int64_t begin      = 0;
+    size_t first_guard = 0;
+    while (true) {
+      auto& trace      = *m_traces[t];
+      const auto guard = replay(trace, begin, first_guard);
+      if (guard == trace.guard_ids.size()) {
+        break;
+      }
+
+      // The nodes up to the violated guard are the same in the trace that took the other branch
+      const auto other = find_divergent_trace(trace, guard);
+      if (other == m_traces.size()) {
+        record(inputs);
+        return m_outputs;
+      }
+      const auto end = static_cast<size_t>(trace.guard_ids[guard]) + 1ul;
+      std::copy_n(std::cbegin(trace.values), end, std::begin(m_traces[other]->values));
+      t           = other;
+      begin       = static_cast<int64_t>(end);
+      first_guard = guard + 1ul;
+      ++m_num_switches;
+    }
+
+    const auto& trace = *m_traces[t];
+    m_outputs.resize(trace.output_ids.size());
+    for (size_t i = 0; i < trace.output_ids.size(); ++i) {
+      m_outputs[i] = trace.values[static_cast<size_t>(trace.output_ids[i])];
+    }
+    std::rotate(std::begin(m_traces),
+                std::next(std::begin(m_traces), static_cast<std::ptrdiff_t>(t)),
+                std::next(std::begin(m_traces), static_cast<std::ptrdiff_t>(t + 1)));
+    ++m_num_replays;
+    return m_outputs;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto outputs() const noexcept -> const std::vector<PassiveType>& {
+    return m_outputs;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_traces() const noexcept -> size_t { return m_traces.size(); }
+
+  // -----------------------------------------------------------------------------------------------
+  // Number of evaluations served by replaying cached traces
+  [[nodiscard]] constexpr auto num_replays() const noexcept -> size_t { return m_num_replays; }
+
+  // -----------------------------------------------------------------------------------------------
+  // Number of times the replay continued with another cached trace after a violated guard
+  [[nodiscard]] constexpr auto num_switches() const noexcept -> size_t { return m_num_switches; }
+
+  // -----------------------------------------------------------------------------------------------
+  // Number of times `function` was recorded
+  [[nodiscard]] constexpr auto num_records() const noexcept -> size_t { return m_num_records; }
+};
+
+}  // namespace RT
+
+#endif  // RT_GUARDED_REPLAY_HPP_
@@ -0,0 +1,215 @@
+#ifndef RT_INCREMENTAL_EVALUATOR_HPP_
+#define RT_INCREMENTAL_EVALUATOR_HPP_
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+namespace RT {
+
+// - Replay only the nodes affected by changed inputs ----------------------------------------------
+// Changed inputs are marked dirty, `update` recomputes the consumers of dirty nodes in topological
+// order, i.e. by increasing node id using a min-heap. If the recomputed value of a node does not
+// change its consumers are not recomputed, so the work is bounded by the size of the dirty cone.
+template <typename PassiveType>
+class IncrementalEvaluator {
+  Tape<PassiveType> m_tape;
+  std::vector<PassiveType> m_values{};
+
+  // Consumers of node `id` are `m_consumers[m_consumer_offsets[id]]` to
+  // `m_consumers[m_consumer_offsets[id + 1] - 1]`
+  std::vector<size_t> m_consumer_offsets{};
+  std::vector<int64_t> m_consumers{};
+
+  std::priority_queue<int64_t, std::vector<int64_t>, std::greater<>> m_dirty{};
+  std::vector<bool> m_queued{};
+  size_t m_num_touched = 0;
+
+  std::vector<bool> m_guard_violated{};
+  size_t m_num_violated_guards = 0;
+
+  // Queue all consumers of `id` for recomputation
+  void mark_consumers(int64_t id) {
+    const auto idx = static_cast<size_t>(id);
+    for (auto k = m_consumer_offsets[idx]; k < m_consumer_offsets[idx + 1]; ++k) {
+      const auto consumer = m_consumers[k];
+      if (!m_queued[static_cast<size_t>(consumer)]) {
+        m_queued[static_cast<size_t>(consumer)] = true;
+        m_dirty.push(consumer);
+      }
+    }
+  }
+
+  // +0 and -0 compare equal but are distinguished by e.g. division, so the sign bit is compared too
+  template <typename T>
+  [[nodiscard]] static constexpr auto scalar_changed(const T& old_value,
+                                                     const T& new_value) noexcept -> bool {
+    if constexpr (std::is_floating_point_v<T>) {
+      return old_value != new_value || std::signbit(old_value) != std::signbit(new_value);
+    } else {
+      return old_value != new_value;
+    }
+  }
+
+  [[nodiscard]] static constexpr auto changed(const PassiveType& old_value,
+                                              const PassiveType& new_value) noexcept -> bool {
+    if constexpr (is_matrix_type_v<PassiveType>) {
+      if (old_value.rows() != new_value.rows() || old_value.cols() != new_value.cols()) {
+        return true;
+      }
+      for (decltype(old_value.size()) i = 0; i < old_value.size(); ++i) {
+        if (scalar_changed(old_value(i), new_value(i))) {
+          return true;
+        }
+      }
+      return false;
+    } else {
+      return scalar_changed(old_value, new_value);
+    }
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  explicit IncrementalEvaluator(const Graph<PassiveType>& graph)
+      : m_tape(graph),
+        m_values(m_tape.values()),
+        m_queued(m_tape.num_nodes(), false),
+        m_guard_violated(m_tape.num_nodes(), false) {
+    const auto num_nodes = m_tape.num_nodes();
+    m_consumer_offsets.resize(num_nodes + 1ul, 0ul);
+    for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+      for (auto arg : m_tape.args(id)) {
+        ++m_consumer_offsets[static_cast<size_t>(arg) + 1ul];
+      }
+    }
+    for (size_t i = 0; i < num_nodes; ++i) {
+      m_consumer_offsets[i + 1] += m_consumer_offsets[i];
+    }
+
+    auto next = m_consumer_offsets;
+    m_consumers.resize(m_consumer_offsets.back());
+    for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+      for (auto arg : m_tape.args(id)) {
+        m_consumers[next[static_cast<size_t>(arg)]++] = id;
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Change the value of input `input_idx`, consumers are recomputed by the next `update`
+  void set_input(size_t input_idx, const PassiveType& value) {
+    RT_ASSERT(input_idx < m_tape.inputs().size(),
+              "Input " << input_idx << " does not exist, the graph has "
+                       << m_tape.inputs().size() << " inputs.");
+    const auto id   = m_tape.inputs()[input_idx];
+    auto& old_value = m_values[static_cast<size_t>(id)];
+    if (changed(old_value, value)) {
+      old_value = value;
+      mark_consumers(id);
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Recompute all nodes that depend on changed inputs, returns the number of recomputed nodes
+  auto update() -> size_t {
+    m_num_touched = 0;
+    while (!m_dirty.empty()) {
+      const auto id = m_dirty.top();
+      m_dirty.pop();
+
+      const auto idx = static_cast<size_t>(id);
+      m_queued[idx]  = false;
+      ++m_num_touched;
+
+      const auto op   = m_tape.op(id);
+      const auto args = m_tape.args(id);
+      auto new_value  = detail::apply_operation<PassiveType>(
+          op, m_tape.attribute(id), args.size(), [&](size_t i) -> const PassiveType& {
+            return m_values[static_cast<size_t>(args[i])];
+          });
+
+      if constexpr (!is_matrix_type_v<PassiveType>) {
+        if (op == NodeType::GUARD) {
+          const bool violated = static_cast<int64_t>(new_value != static_cast<PassiveType>(0)) !=
+                                m_tape.attribute(id);
+          if (violated != m_guard_violated[idx]) {
+            m_guard_violated[idx] = violated;
+            if (violated) {
+              ++m_num_violated_guards;
+            } else {
+              --m_num_violated_guards;
+            }
+          }
+        }
+      }
+
+      if (changed(m_values[idx], new_value)) {
+        m_values[idx] = std::move(new_value);
+        mark_consumers(id);
+      }
+    }
+    return m_num_touched;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Set all inputs and recompute the affected nodes
+  auto evaluate(std::span<const PassiveType> inputs) -> size_t {
+    RT_ASSERT(inputs.size() == m_tape.inputs().size(),
+              "Expected " << m_tape.inputs().size() << " inputs, but got " << inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      set_input(i, inputs[i]);
+    }
+    return update();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto value(int64_t id) const noexcept -> const PassiveType& {
+    RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_values.size(),
+              "Node with id " << id << " is not part of the graph.");
+    return m_values[static_cast<size_t>(id)];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto values() const noexcept -> const std::vector<PassiveType>& {
+    return m_values;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Number of nodes recomputed by the last `update`
+  [[nodiscard]] constexpr auto num_touched() const noexcept -> size_t { return m_num_touched; }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto guards_hold() const noexcept -> bool {
+    return m_num_violated_guards == 0;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] auto violated_guards() const -> std::vector<int64_t> {
+    std::vector<int64_t> guards{};
+    guards.reserve(m_num_violated_guards);
+    for (size_t idx = 0; idx < m_guard_violated.size(); ++idx) {
+      if (m_guard_violated[idx]) {
+        guards.push_back(static_cast<int64_t>(idx));
+      }
+    }
+    return guards;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto tape() const noexcept -> const Tape<PassiveType>& { return m_tape; }
+};
+
+}  // namespace RT
+
+#endif  // RT_INCREMENTAL_EVALUATOR_HPP_
@@ -0,0 +1,187 @@
+#ifndef RT_MIXED_PRECISION_EVALUATOR_HPP_
+#define RT_MIXED_PRECISION_EVALUATOR_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "CustomOp.hpp"
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+namespace RT {
+
+// - Error of a replay against reference values ----------------------------------------------------
+struct ErrorStatistics {
+  std::vector<double> absolute_errors{};  // Per node
+  std::vector<double> relative_errors{};  // Per node, the absolute error if the reference is zero
+  double max_absolute_error  = 0.0;
+  double max_relative_error  = 0.0;
+  double mean_relative_error = 0.0;
+  int64_t worst_node         = -1;  // Node with the largest relative error
+};
+
+// - Replay a graph in a different precision -------------------------------------------------------
+// Replays a graph recorded with `PassiveType` using `ReplayType` for all values, e.g. record in
+// double and replay in float, long double or `DoubleDouble`. Recorded constants and inputs are
+// converted to `ReplayType`. `ReplayType` has to support the arithmetic operators and comparisons,
+// `sqrt`, `sin` and `cos` are found by argument dependent lookup or in `std`. Custom operations
+// only have a kernel for `PassiveType` and are evaluated in the recorded precision.
+template <typename ReplayType, typename PassiveType>
+class MixedPrecisionEvaluator {
+  static_assert(std::is_floating_point_v<PassiveType>,
+                "Mixed precision replay requires a floating point type as `PassiveType`.");
+  static_assert(!is_matrix_type_v<ReplayType>, "`ReplayType` must be a scalar type.");
+
+  Tape<PassiveType> m_tape;
+  std::vector<ReplayType> m_values{};
+  std::vector<int64_t> m_violated_guards{};
+
+  // -----------------------------------------------------------------------------------------------
+  template <typename ArgFunc>
+  [[nodiscard]] auto apply(int64_t id, size_t num_args, const ArgFunc& arg) const -> ReplayType {
+    if (m_tape.op(id) == NodeType::CUSTOM) {
+      std::vector<PassiveType> arg_values(num_args);
+      for (size_t i = 0; i < num_args; ++i) {
+        arg_values[i] = static_cast<PassiveType>(arg(i));
+      }
+      return static_cast<ReplayType>(
+          CustomOpRegistry<PassiveType>::get(m_tape.attribute(id)).forward(arg_values));
+    }
+    return detail::apply_operation<ReplayType>(m_tape.op(id), m_tape.attribute(id), num_args, arg);
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  explicit MixedPrecisionEvaluator(const Graph<PassiveType>& graph)
+      : m_tape(graph) {
+    m_values.reserve(m_tape.num_nodes());
+    for (const auto& value : m_tape.values()) {
+      m_values.push_back(static_cast<ReplayType>(value));
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Replay with the recorded inputs, the values can be compared with the recorded values
+  void evaluate() {
+    std::vector<PassiveType> inputs{};
+    inputs.reserve(m_tape.inputs().size());
+    for (auto id : m_tape.inputs()) {
+      inputs.push_back(m_tape.values()[static_cast<size_t>(id)]);
+    }
+    evaluate(inputs);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  void evaluate(std::span<const PassiveType> inputs) {
+    const auto& input_ids = m_tape.inputs();
+    RT_ASSERT(inputs.size() == input_ids.size(),
+              "Expected " << input_ids.size() << " inputs, but got " << inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      m_values[static_cast<size_t>(input_ids[i])] = static_cast<ReplayType>(inputs[i]);
+    }
+
+    m_violated_guards.clear();
+    for (int64_t id = 0; id < static_cast<int64_t>(m_tape.num_nodes()); ++id) {
+      const auto args = m_tape.args(id);
+      if (args.empty()) {
+        continue;
+      }
+
+      const auto idx = static_cast<size_t>(id);
+      m_values[idx]  = apply(id, args.size(), [&](size_t i) -> const ReplayType& {
+        return m_values[static_cast<size_t>(args[i])];
+      });
+
+      // A lower precision can change the outcome of a comparison
+      if (m_tape.op(id) == NodeType::GUARD &&
+          static_cast<int64_t>(m_values[idx] != static_cast<ReplayType>(0)) !=
+              m_tape.attribute(id)) {
+        m_violated_guards.push_back(id);
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Error of the current values against `reference`, one value per node, e.g. the values of a
+  // replay in higher precision
+  template <typename ReferenceType>
+  [[nodiscard]] auto error_statistics(const std::vector<ReferenceType>& reference) const
+      -> ErrorStatistics {
+    RT_ASSERT(reference.size() == m_values.size(),
+              "Expected " << m_values.size() << " reference values, but got " << reference.size());
+
+    ErrorStatistics stats{.absolute_errors = std::vector<double>(m_values.size(), 0.0),
+                          .relative_errors = std::vector<double>(m_values.size(), 0.0)};
+    double sum_relative_error = 0.0;
+    for (size_t idx = 0; idx < m_values.size(); ++idx) {
+      const auto value = static_cast<long double>(m_values[idx]);
+      const auto ref   = static_cast<long double>(reference[idx]);
+
+      double abs_error = 0.0;
+      if (std::isnan(value) || std::isnan(ref)) {
+        abs_error = std::isnan(value) && std::isnan(ref) ? 0.0
+                                                         : std::numeric_limits<double>::infinity();
+      } else if (value != ref) {
+        abs_error = static_cast<double>(std::abs(value - ref));
+      }
+      const double rel_error =
+          ref != 0.0L && std::isfinite(ref) ? abs_error / static_cast<double>(std::abs(ref))
+                                            : abs_error;
+
+      stats.absolute_errors[idx] = abs_error;
+      stats.relative_errors[idx] = rel_error;
+      stats.max_absolute_error   = std::max(stats.max_absolute_error, abs_error);
+      if (stats.worst_node < 0 || rel_error > stats.max_relative_error) {
+        stats.max_relative_error = rel_error;
+        stats.worst_node         = static_cast<int64_t>(idx);
+      }
+      sum_relative_error += rel_error;
+    }
+    stats.mean_relative_error =
+        m_values.empty() ? 0.0 : sum_relative_error / static_cast<double>(m_values.size());
+    return stats;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Error of the current values against the recorded values
+  [[nodiscard]] auto error_statistics() const -> ErrorStatistics {
+    return error_statistics(m_tape.values());
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto value(int64_t id) const noexcept -> const ReplayType& {
+    RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_values.size(),
+              "Node with id " << id << " is not part of the graph.");
+    return m_values[static_cast<size_t>(id)];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto values() const noexcept -> const std::vector<ReplayType>& {
+    return m_values;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto guards_hold() const noexcept -> bool {
+    return m_violated_guards.empty();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto violated_guards() const noexcept -> const std::vector<int64_t>& {
+    return m_violated_guards;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto tape() const noexcept -> const Tape<PassiveType>& { return m_tape; }
+};
+
+}  // namespace RT
+
+#endif  // RT_MIXED_PRECISION_EVALUATOR_HPP_
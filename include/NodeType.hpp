@@ -18,21 +18,48 @@ enum class NodeType {
   SQRT,
   SIN,
   COS,
+  CMP,
+  SELECT,
+  GUARD,
+  GEMM,
+  TRANSPOSE,
+  SOLVE,
+  CWISE_MUL,
+  CUSTOM,
+  SUB,
+  DIV,
+  MOD,
+  SUM,
+  DOT,
   NODE_TYPE_COUNT,
 };
 
+// -------------------------------------------------------------------------------------------------
+enum class ComparisonType {
+  LT,
+  LE,
+  GT,
+  GE,
+  EQ,
+  NE,
+};
+
 // -------------------------------------------------------------------------------------------------
 [[nodiscard]] constexpr auto is_op(NodeType node_type) noexcept -> bool {
   // TODO: Are NodeType::INV and NodeType::NEG operations that we want to count?
-  static_assert(static_cast<int>(NodeType::NODE_TYPE_COUNT) == 9,
+  static_assert(static_cast<int>(NodeType::NODE_TYPE_COUNT) == 22,
                 "Number of node types changed, are the new ones operations?");
   return node_type == NodeType::ADD || node_type == NodeType::MUL || node_type == NodeType::SQRT ||
-         node_type == NodeType::SIN || node_type == NodeType::COS;
+         node_type == NodeType::SIN || node_type == NodeType::COS || node_type == NodeType::CMP ||
+         node_type == NodeType::GEMM || node_type == NodeType::SOLVE ||
+         node_type == NodeType::CWISE_MUL || node_type == NodeType::CUSTOM ||
+         node_type == NodeType::SUB || node_type == NodeType::DIV || node_type == NodeType::MOD ||
+         node_type == NodeType::SUM || node_type == NodeType::DOT;
 }
 
 // -------------------------------------------------------------------------------------------------
 constexpr auto to_string(NodeType node_type) noexcept -> std::string {
-  static_assert(static_cast<int>(NodeType::NODE_TYPE_COUNT) == 9,
+  static_assert(static_cast<int>(NodeType::NODE_TYPE_COUNT) == 22,
                 "Number of node types changed, add name to switch statement.");
   using namespace std::string_literals;
 
@@ -55,11 +82,82 @@ constexpr auto to_string(NodeType node_type) noexcept -> std::string {
       return "SIN"s;
     case NodeType::COS:
       return "COS"s;
+    case NodeType::CMP:
+      return "CMP"s;
+    case NodeType::SELECT:
+      return "SELECT"s;
+    case NodeType::GUARD:
+      return "GUARD"s;
+    case NodeType::GEMM:
+      return "GEMM"s;
+    case NodeType::TRANSPOSE:
+      return "TRANSPOSE"s;
+    case NodeType::SOLVE:
+      return "SOLVE"s;
+    case NodeType::CWISE_MUL:
+      return "CWISE_MUL"s;
+    case NodeType::CUSTOM:
+      return "CUSTOM"s;
+    case NodeType::SUB:
+      return "SUB"s;
+    case NodeType::DIV:
+      return "DIV"s;
+    case NodeType::MOD:
+      return "MOD"s;
+    case NodeType::SUM:
+      return "SUM"s;
+    case NodeType::DOT:
+      return "DOT"s;
     default:
       RT_PANIC("Unknown NodeType: `" << static_cast<int>(node_type) << "`.");
   }
 }
 
+// -------------------------------------------------------------------------------------------------
+constexpr auto to_string(ComparisonType cmp) noexcept -> std::string {
+  using namespace std::string_literals;
+
+  switch (cmp) {
+    case ComparisonType::LT:
+      return "<"s;
+    case ComparisonType::LE:
+      return "<="s;
+    case ComparisonType::GT:
+      return ">"s;
+    case ComparisonType::GE:
+      return ">="s;
+    case ComparisonType::EQ:
+      return "=="s;
+    case ComparisonType::NE:
+      return "!="s;
+    default:
+      RT_PANIC("Unknown ComparisonType: `" << static_cast<int>(cmp) << "`.");
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+template <typename T>
+[[nodiscard]] constexpr auto evaluate_comparison(const T& lhs,
+                                                 const T& rhs,
+                                                 ComparisonType cmp) noexcept -> bool {
+  switch (cmp) {
+    case ComparisonType::LT:
+      return lhs < rhs;
+    case ComparisonType::LE:
+      return lhs <= rhs;
+    case ComparisonType::GT:
+      return lhs > rhs;
+    case ComparisonType::GE:
+      return lhs >= rhs;
+    case ComparisonType::EQ:
+      return lhs == rhs;
+    case ComparisonType::NE:
+      return lhs != rhs;
+    default:
+      RT_PANIC("Unknown ComparisonType: `" << static_cast<int>(cmp) << "`.");
+  }
+}
+
 // -------------------------------------------------------------------------------------------------
 auto operator<<(std::ostream& out, NodeType node_type) noexcept -> std::ostream& {
   out << to_string(node_type);
@@ -0,0 +1,262 @@
+#ifndef RT_PARALLEL_EVALUATOR_HPP_
+#define RT_PARALLEL_EVALUATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+namespace RT {
+
+// - Replay a recorded graph using multiple threads ------------------------------------------------
+// Nodes are grouped into topological levels, all nodes of a level only depend on nodes of previous
+// levels and can be evaluated concurrently. The values are stored level by level and every level
+// starts at a new cache line, each thread evaluates chunks of whole cache lines such that no two
+// threads write to the same cache line.
+//
+// The calling thread and `num_threads - 1` worker threads owned by the evaluator evaluate the
+// levels, the workers are started once in the constructor and reused for every evaluation.
+template <typename PassiveType>
+class ParallelEvaluator {
+  static_assert(!is_matrix_type_v<PassiveType>, "Parallel replay requires a scalar type.");
+
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+  static constexpr size_t VALUES_PER_LINE = std::max(CACHE_LINE_SIZE / sizeof(PassiveType), 1ul);
+  static constexpr size_t LINES_PER_CHUNK = 32;
+  static constexpr size_t CHUNK_SIZE      = VALUES_PER_LINE * LINES_PER_CHUNK;
+  static constexpr int64_t PADDING        = -1;
+
+  struct alignas(CACHE_LINE_SIZE) CacheLine {
+    std::array<PassiveType, VALUES_PER_LINE> v;
+  };
+
+  size_t m_num_threads;
+
+  // All data is stored in slot order; slots are sorted by level, padding slots have no node
+  std::vector<CacheLine> m_values{};
+  std::vector<int64_t> m_node_ids{};
+  std::vector<NodeType> m_ops{};
+  std::vector<int64_t> m_attributes{};
+  std::vector<size_t> m_arg_offsets{};
+  std::vector<size_t> m_args{};  // Slots of the arguments
+  std::vector<size_t> m_level_offsets{};
+
+  std::vector<size_t> m_slots{};  // Slot of every node
+  std::vector<size_t> m_input_slots{};
+  std::vector<int64_t> m_violated_guards{};
+
+  // State of the worker threads; a new evaluation is started by incrementing `m_generation`
+  std::mutex m_mutex;
+  std::condition_variable_any m_start_cv;
+  size_t m_generation = 0;
+  std::barrier<> m_barrier;
+  std::vector<std::vector<int64_t>> m_thread_violated_guards{};
+
+  std::vector<std::jthread> m_workers{};
+
+  [[nodiscard]] constexpr auto slot_value(size_t slot) noexcept -> PassiveType& {
+    return m_values[slot / VALUES_PER_LINE].v[slot % VALUES_PER_LINE];
+  }
+
+  [[nodiscard]] constexpr auto slot_value(size_t slot) const noexcept -> const PassiveType& {
+    return m_values[slot / VALUES_PER_LINE].v[slot % VALUES_PER_LINE];
+  }
+
+  // Evaluate the nodes in slots [begin, end), violated guards are appended to `violated_guards`
+  void evaluate_slots(size_t begin, size_t end, std::vector<int64_t>& violated_guards) {
+    for (size_t slot = begin; slot < end; ++slot) {
+      if (m_node_ids[slot] == PADDING) {
+        continue;
+      }
+
+      const auto args  = std::span<const size_t>(m_args).subspan(
+          m_arg_offsets[slot], m_arg_offsets[slot + 1] - m_arg_offsets[slot]);
+      const auto op    = m_ops[slot];
+      slot_value(slot) = detail::apply_operation<PassiveType>(
+          op, m_attributes[slot], args.size(), [&](size_t i) -> const PassiveType& {
+            return slot_value(args[i]);
+          });
+
+      if (op == NodeType::GUARD &&
+          static_cast<int64_t>(slot_value(slot) != static_cast<PassiveType>(0)) !=
+              m_attributes[slot]) {
+        violated_guards.push_back(m_node_ids[slot]);
+      }
+    }
+  }
+
+  // Evaluate all levels with `thread_idx` being one of `m_num_threads` threads
+  void evaluate_levels(size_t thread_idx) {
+    auto& violated_guards = m_thread_violated_guards[thread_idx];
+    // Level 0 only contains inputs and constants
+    for (size_t level = 1; level + 1 < m_level_offsets.size(); ++level) {
+      const auto begin = m_level_offsets[level];
+      const auto end   = m_level_offsets[level + 1];
+      for (auto chunk_begin = begin + thread_idx * CHUNK_SIZE; chunk_begin < end;
+           chunk_begin += m_num_threads * CHUNK_SIZE) {
+        evaluate_slots(chunk_begin, std::min(chunk_begin + CHUNK_SIZE, end), violated_guards);
+      }
+      m_barrier.arrive_and_wait();
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  void worker(const std::stop_token& stop_token, size_t thread_idx) {
+    size_t generation = 0;
+    while (true) {
+      {
+        std::unique_lock lock(m_mutex);
+        if (!m_start_cv.wait(lock, stop_token, [&] { return m_generation != generation; })) {
+          return;
+        }
+        generation = m_generation;
+      }
+      evaluate_levels(thread_idx);
+    }
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  explicit ParallelEvaluator(const Graph<PassiveType>& graph,
+                             size_t num_threads = std::thread::hardware_concurrency())
+      : m_num_threads(std::max(num_threads, 1ul)),
+        m_barrier(static_cast<std::ptrdiff_t>(m_num_threads)),
+        m_thread_violated_guards(m_num_threads) {
+    const Tape<PassiveType> tape(graph);
+    const auto num_nodes = tape.num_nodes();
+
+    // Topological level of every node
+    std::vector<size_t> levels(num_nodes, 0ul);
+    size_t num_levels = 1ul;
+    for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+      auto& level = levels[static_cast<size_t>(id)];
+      for (auto arg : tape.args(id)) {
+        level = std::max(level, levels[static_cast<size_t>(arg)] + 1ul);
+      }
+      num_levels = std::max(num_levels, level + 1ul);
+    }
+
+    // Every level starts at a new cache line
+    std::vector<size_t> level_sizes(num_levels, 0ul);
+    for (auto level : levels) {
+      ++level_sizes[level];
+    }
+    m_level_offsets.resize(num_levels + 1ul, 0ul);
+    for (size_t level = 0; level < num_levels; ++level) {
+      const auto num_lines       = (level_sizes[level] + VALUES_PER_LINE - 1ul) / VALUES_PER_LINE;
+      m_level_offsets[level + 1] = m_level_offsets[level] + num_lines * VALUES_PER_LINE;
+    }
+    const auto num_slots = m_level_offsets.back();
+
+    auto next_slot = m_level_offsets;
+    m_slots.resize(num_nodes);
+    m_node_ids.resize(num_slots, PADDING);
+    for (size_t id = 0; id < num_nodes; ++id) {
+      m_slots[id]             = next_slot[levels[id]]++;
+      m_node_ids[m_slots[id]] = static_cast<int64_t>(id);
+    }
+
+    m_values.resize(num_slots / VALUES_PER_LINE);
+    m_ops.resize(num_slots, NodeType::VAR);
+    m_attributes.resize(num_slots, 0);
+    m_arg_offsets.reserve(num_slots + 1ul);
+    m_arg_offsets.push_back(0ul);
+    for (size_t slot = 0; slot < num_slots; ++slot) {
+      const auto id = m_node_ids[slot];
+      if (id != PADDING) {
+        m_ops[slot]        = tape.op(id);
+        m_attributes[slot] = tape.attribute(id);
+        slot_value(slot)   = tape.values()[static_cast<size_t>(id)];
+        for (auto arg : tape.args(id)) {
+          m_args.push_back(m_slots[static_cast<size_t>(arg)]);
+        }
+      }
+      m_arg_offsets.push_back(m_args.size());
+    }
+
+    m_input_slots.reserve(tape.inputs().size());
+    for (auto id : tape.inputs()) {
+      m_input_slots.push_back(m_slots[static_cast<size_t>(id)]);
+    }
+
+    m_workers.reserve(m_num_threads - 1ul);
+    for (size_t thread_idx = 1; thread_idx < m_num_threads; ++thread_idx) {
+      m_workers.emplace_back(
+          [this, thread_idx](const std::stop_token& stop_token) { worker(stop_token, thread_idx); });
+    }
+  }
+
+  ParallelEvaluator(const ParallelEvaluator&)                    = delete;
+  ParallelEvaluator(ParallelEvaluator&&)                         = delete;
+  auto operator=(const ParallelEvaluator&) -> ParallelEvaluator& = delete;
+  auto operator=(ParallelEvaluator&&) -> ParallelEvaluator&      = delete;
+  ~ParallelEvaluator() noexcept                                  = default;
+
+  // -----------------------------------------------------------------------------------------------
+  void evaluate(std::span<const PassiveType> inputs) {
+    RT_ASSERT(inputs.size() == m_input_slots.size(),
+              "Expected " << m_input_slots.size() << " inputs, but got " << inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      slot_value(m_input_slots[i]) = inputs[i];
+    }
+
+    // The workers are idle, they finished the last level of the previous evaluation
+    for (auto& guards : m_thread_violated_guards) {
+      guards.clear();
+    }
+    {
+      const std::lock_guard lock(m_mutex);
+      ++m_generation;
+    }
+    m_start_cv.notify_all();
+    // The barrier after the last level guarantees that all workers are finished
+    evaluate_levels(0ul);
+
+    m_violated_guards.clear();
+    for (const auto& guards : m_thread_violated_guards) {
+      m_violated_guards.insert(std::end(m_violated_guards), std::cbegin(guards), std::cend(guards));
+    }
+    std::sort(std::begin(m_violated_guards), std::end(m_violated_guards));
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto value(int64_t id) const noexcept -> const PassiveType& {
+    RT_ASSERT(id >= 0 && static_cast<size_t>(id) < m_slots.size(),
+              "Node with id " << id << " is not part of the graph.");
+    return slot_value(m_slots[static_cast<size_t>(id)]);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto guards_hold() const noexcept -> bool {
+    return m_violated_guards.empty();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto violated_guards() const noexcept -> const std::vector<int64_t>& {
+    return m_violated_guards;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_levels() const noexcept -> size_t {
+    return m_level_offsets.size() - 1ul;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_threads() const noexcept -> size_t { return m_num_threads; }
+};
+
+}  // namespace RT
+
+#endif  // RT_PARALLEL_EVALUATOR_HPP_
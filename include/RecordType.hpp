@@ -2,14 +2,19 @@
 #define RT_RECORD_TYPE_HPP_
 
 #include <algorithm>
+#include <array>
+#include <concepts>
 #include <cstdint>
 #include <iosfwd>
 #include <memory>
+#include <span>
 #include <utility>
+#include <vector>
 #ifndef RT_ONLY_FUNDAMENTAL
 #include <cmath>
 #endif  // RT_ONLY_FUNDAMENTAL
 
+#include "CustomOp.hpp"
 #include "Graph.hpp"
 #include "Helper.hpp"
 #include "Macros.hpp"
@@ -118,7 +123,7 @@ class RecordType {
   // Set graph
   constexpr void register_graph(std::shared_ptr<Graph<PassiveType>> graph) const noexcept {
     m_graph = graph;
-    m_id    = m_graph->add_operation(m_node_type, m_value);
+    m_id    = m_graph->add_input(m_node_type, m_value);
   }
 
   [[nodiscard]] constexpr auto value() const noexcept -> const PassiveType& { return m_value; }
@@ -146,14 +151,167 @@ class RecordType {
     return lhs.m_graph;
   }
 
+  // Common graph of all arguments; nullptr if no argument has a graph or if they are part of
+  // different graphs
+  template <std::same_as<RecordType<PassiveType>>... Args>
+  [[nodiscard]] static constexpr auto get_common_graph(const Args&... args) noexcept
+      -> std::shared_ptr<Graph<PassiveType>> {
+    std::shared_ptr<Graph<PassiveType>> graph = nullptr;
+    bool different_graphs                     = false;
+    (
+        [&] {
+          if (args.m_graph) {
+            if (!graph) {
+              graph = args.m_graph;
+            } else if (graph != args.m_graph) {
+              different_graphs = true;
+            }
+          }
+        }(),
+        ...);
+    return different_graphs ? nullptr : graph;
+  }
+
+  // Create the result of an operation of type `node_type` with arguments `args`, unregistered
+  // arguments are added to the graph
+  template <std::same_as<RecordType<PassiveType>>... Args>
+  [[nodiscard]] static constexpr auto
+  record_operation(NodeType node_type, PassiveType value, const Args&... args) noexcept
+      -> RecordType<PassiveType> {
+    RecordType<PassiveType> res(std::move(value), node_type);
+
+    auto graph = get_common_graph(args...);
+    if (graph) {
+      (
+          [&] {
+            if (args.id() == UNREGISTERED) {
+              args.m_id = graph->add_operation(args.node_type(), args.value());
+            }
+          }(),
+          ...);
+
+      graph->add_dependencies(args.id()...);
+      res.m_id    = graph->add_operation(res.node_type(), res.value());
+      res.m_graph = graph;
+    }
+    return res;
+  }
+
+  // Same as above, but for a number of arguments only known at runtime
+  [[nodiscard]] static auto
+  record_operation(NodeType node_type,
+                   PassiveType value,
+                   std::span<const RecordType<PassiveType>* const> args) noexcept
+      -> RecordType<PassiveType> {
+    RecordType<PassiveType> res(std::move(value), node_type);
+
+    std::shared_ptr<Graph<PassiveType>> graph = nullptr;
+    for (const auto* arg : args) {
+      if (arg->m_graph) {
+        if (!graph) {
+          graph = arg->m_graph;
+        } else if (graph != arg->m_graph) {
+          return res;
+        }
+      }
+    }
+
+    if (graph) {
+      std::vector<int64_t> ids(args.size());
+      std::transform(std::cbegin(args), std::cend(args), std::begin(ids), [&](const auto* arg) {
+        if (arg->id() == UNREGISTERED) {
+          arg->m_id = graph->add_operation(arg->node_type(), arg->value());
+        }
+        return arg->id();
+      });
+
+      graph->add_dependencies(std::span<const int64_t>(ids));
+      res.m_id    = graph->add_operation(res.node_type(), res.value());
+      res.m_graph = graph;
+    }
+    return res;
+  }
+
+  // Compare `lhs` and `rhs`, records the comparison and a guard for its outcome
+  [[nodiscard]] static constexpr auto record_guarded_comparison(const RecordType<PassiveType>& lhs,
+                                                                const RecordType<PassiveType>& rhs,
+                                                                ComparisonType cmp) noexcept
+      -> bool {
+    const bool outcome = evaluate_comparison(lhs.value(), rhs.value(), cmp);
+    if (get_common_graph(lhs, rhs)) {
+      const auto cond = compare(lhs, rhs, cmp);
+      [[maybe_unused]] const auto guard =
+          record_operation(NodeType::GUARD, static_cast<PassiveType>(outcome), cond);
+    }
+    return outcome;
+  }
+
  public:
-  [[nodiscard]] constexpr auto operator==(const RecordType<PassiveType>& other) const noexcept
+  // - Comparison ----------------------------------------------------------------------------------
+  // Comparison with a recorded result, value is 1 if the comparison holds and 0 otherwise; does
+  // not record a guard, use together with `select` for branch free code
+  [[nodiscard]] friend constexpr auto compare(const RecordType<PassiveType>& lhs,
+                                              const RecordType<PassiveType>& rhs,
+                                              ComparisonType cmp) noexcept
+      -> RecordType<PassiveType> {
+    const bool outcome = evaluate_comparison(lhs.value(), rhs.value(), cmp);
+
+    auto res = record_operation(NodeType::CMP, static_cast<PassiveType>(outcome), lhs, rhs);
+    if (res.m_graph) {
+      res.m_graph->set_attribute(res.id(), static_cast<int64_t>(cmp));
+    }
+    return res;
+  }
+
+  // Choose `if_true` if `cond` is not zero and `if_false` otherwise
+  [[nodiscard]] friend constexpr auto select(const RecordType<PassiveType>& cond,
+                                             const RecordType<PassiveType>& if_true,
+                                             const RecordType<PassiveType>& if_false) noexcept
+      -> RecordType<PassiveType> {
+    return record_operation(NodeType::SELECT,
+                            cond.value() != static_cast<PassiveType>(0) ? if_true.value()
+                                                                        : if_false.value(),
+                            cond,
+                            if_true,
+                            if_false);
+  }
+
+  // The comparison operators are used for control flow, therefore a guard is recorded that holds
+  // the outcome of the comparison. A replay of the graph is only valid as long as all guards hold.
+  [[nodiscard]] friend constexpr auto operator==(const RecordType<PassiveType>& lhs,
+                                                 const RecordType<PassiveType>& rhs) noexcept
       -> bool {
-    return m_value == other.m_value;
+    return record_guarded_comparison(lhs, rhs, ComparisonType::EQ);
   }
 
-  [[nodiscard]] constexpr auto operator<=>(const RecordType<PassiveType>& other) const noexcept {
-    return m_value <=> other.m_value;
+  [[nodiscard]] friend constexpr auto operator!=(const RecordType<PassiveType>& lhs,
+                                                 const RecordType<PassiveType>& rhs) noexcept
+      -> bool {
+    return record_guarded_comparison(lhs, rhs, ComparisonType::NE);
+  }
+
+  [[nodiscard]] friend constexpr auto operator<(const RecordType<PassiveType>& lhs,
+                                                const RecordType<PassiveType>& rhs) noexcept
+      -> bool {
+    return record_guarded_comparison(lhs, rhs, ComparisonType::LT);
+  }
+
+  [[nodiscard]] friend constexpr auto operator<=(const RecordType<PassiveType>& lhs,
+                                                 const RecordType<PassiveType>& rhs) noexcept
+      -> bool {
+    return record_guarded_comparison(lhs, rhs, ComparisonType::LE);
+  }
+
+  [[nodiscard]] friend constexpr auto operator>(const RecordType<PassiveType>& lhs,
+                                                const RecordType<PassiveType>& rhs) noexcept
+      -> bool {
+    return record_guarded_comparison(lhs, rhs, ComparisonType::GT);
+  }
+
+  [[nodiscard]] friend constexpr auto operator>=(const RecordType<PassiveType>& lhs,
+                                                 const RecordType<PassiveType>& rhs) noexcept
+      -> bool {
+    return record_guarded_comparison(lhs, rhs, ComparisonType::GE);
   }
 
   constexpr auto operator+=(const RecordType<PassiveType>& to_add) noexcept
@@ -180,10 +338,19 @@ class RecordType {
     return *this;
   }
 
+  constexpr auto operator%=(const RecordType<PassiveType>& to_mod) noexcept
+      -> RecordType<PassiveType>&
+  requires std::is_integral_v<PassiveType>
+  {
+    *this = *this % to_mod;
+    return *this;
+  }
+
   [[nodiscard]] friend constexpr auto operator+(const RecordType<PassiveType>& lhs,
                                                 const RecordType<PassiveType>& rhs) noexcept
       -> RecordType<PassiveType> {
-    RecordType<PassiveType> res(lhs.value() + rhs.value(), NodeType::ADD);
+    RecordType<PassiveType> res(static_cast<PassiveType>(lhs.value() + rhs.value()),
+                                NodeType::ADD);
 
     auto graph = get_graph(lhs, rhs);
     if (graph) {
@@ -201,10 +368,12 @@ class RecordType {
     return res;
   }
 
+  // For matrix types this is a matrix product
   [[nodiscard]] friend constexpr auto operator*(const RecordType<PassiveType>& lhs,
                                                 const RecordType<PassiveType>& rhs) noexcept
       -> RecordType<PassiveType> {
-    RecordType<PassiveType> res(lhs.value() * rhs.value(), NodeType::MUL);
+    RecordType<PassiveType> res(static_cast<PassiveType>(lhs.value() * rhs.value()),
+                                is_matrix_type_v<PassiveType> ? NodeType::GEMM : NodeType::MUL);
 
     auto graph = get_graph(lhs, rhs);
     if (graph) {
@@ -222,7 +391,6 @@ class RecordType {
     return res;
   }
 
-  // TODO: This does not work for integer types
   [[nodiscard]] constexpr auto invert() const noexcept -> RecordType<PassiveType> {
     static_assert(std::is_floating_point_v<PassiveType>,
                   "`PassiveType` has to be a floating point type, otherwise the result would not "
@@ -236,19 +404,32 @@ class RecordType {
     return res;
   }
 
-  // TODO: This does not work for integer types because of `invert`
+  // Integer division truncates, therefore it cannot be expressed using `invert`
   [[nodiscard]] friend constexpr auto operator/(const RecordType<PassiveType>& lhs,
                                                 const RecordType<PassiveType>& rhs) noexcept
       -> RecordType<PassiveType> {
-    return lhs * rhs.invert();
+    if constexpr (std::is_integral_v<PassiveType>) {
+      RT_ASSERT(rhs.value() != static_cast<PassiveType>(0), "Division by zero.");
+      return record_operation(
+          NodeType::DIV, static_cast<PassiveType>(lhs.value() / rhs.value()), lhs, rhs);
+    } else {
+      return lhs * rhs.invert();
+    }
+  }
+
+  [[nodiscard]] friend constexpr auto operator%(const RecordType<PassiveType>& lhs,
+                                                const RecordType<PassiveType>& rhs) noexcept
+      -> RecordType<PassiveType>
+  requires std::is_integral_v<PassiveType>
+  {
+    RT_ASSERT(rhs.value() != static_cast<PassiveType>(0), "Division by zero.");
+    return record_operation(
+        NodeType::MOD, static_cast<PassiveType>(lhs.value() % rhs.value()), lhs, rhs);
   }
 
-  // TODO: This does not work for unsigned integer types
+  // For unsigned integer types the negation wraps around, same as for `PassiveType`
   [[nodiscard]] constexpr auto operator-() const noexcept -> RecordType<PassiveType> {
-    static_assert(std::is_signed_v<PassiveType>,
-                  "`PassiveType` has to be signed, otherwise the result would not be the same as "
-                  "if we would be using just `PassiveType`");
-    RecordType<PassiveType> res(-m_value, NodeType::NEG);
+    RecordType<PassiveType> res(static_cast<PassiveType>(-m_value), NodeType::NEG);
     if (m_graph) {
       m_graph->add_dependencies(id());
       res.m_id    = m_graph->add_operation(res.node_type(), res.value());
@@ -257,11 +438,111 @@ class RecordType {
     return res;
   }
 
-  // TODO: This does not work for unsigned integer types
+  // Integer subtraction is recorded as a single operation instead of an addition and a negation
   [[nodiscard]] friend constexpr auto operator-(const RecordType<PassiveType>& lhs,
                                                 const RecordType<PassiveType>& rhs) noexcept
       -> RecordType<PassiveType> {
-    return lhs + -rhs;
+    if constexpr (std::is_integral_v<PassiveType>) {
+      return record_operation(
+          NodeType::SUB, static_cast<PassiveType>(lhs.value() - rhs.value()), lhs, rhs);
+    } else {
+      return lhs + -rhs;
+    }
+  }
+
+  // - User defined operations ---------------------------------------------------------------------
+  // Apply operation `op_id` registered with `register_custom_op`, records a single node
+  template <std::same_as<RecordType<PassiveType>>... Args>
+  [[nodiscard]] friend auto custom_op(int64_t op_id, const Args&... args) noexcept
+      -> RecordType<PassiveType> {
+    const auto& op = CustomOpRegistry<PassiveType>::get(op_id);
+    RT_ASSERT(op.arity == sizeof...(args),
+              "Custom operation `" << op.name << "` expects " << op.arity << " arguments, but got "
+                                   << sizeof...(args));
+
+    const std::array<PassiveType, sizeof...(args)> arg_values{args.value()...};
+    auto res = record_operation(NodeType::CUSTOM, op.forward(arg_values), args...);
+    if (res.m_graph) {
+      res.m_graph->set_attribute(res.id(), op_id);
+    }
+    return res;
+  }
+
+  [[nodiscard]] friend auto custom_op(int64_t op_id,
+                                      std::span<const RecordType<PassiveType>> args) noexcept
+      -> RecordType<PassiveType> {
+    const auto& op = CustomOpRegistry<PassiveType>::get(op_id);
+    RT_ASSERT(op.arity == args.size(),
+              "Custom operation `" << op.name << "` expects " << op.arity << " arguments, but got "
+                                   << args.size());
+
+    std::vector<PassiveType> arg_values(args.size());
+    std::vector<const RecordType<PassiveType>*> arg_ptrs(args.size());
+    for (size_t i = 0; i < args.size(); ++i) {
+      arg_values[i] = args[i].value();
+      arg_ptrs[i]   = &args[i];
+    }
+    auto res = record_operation(NodeType::CUSTOM, op.forward(arg_values), arg_ptrs);
+    if (res.m_graph) {
+      res.m_graph->set_attribute(res.id(), op_id);
+    }
+    return res;
+  }
+
+  // - Reductions ----------------------------------------------------------------------------------
+  // Sum of all `summands`, recorded as single operation
+  [[nodiscard]] friend auto sum(std::span<const RecordType<PassiveType>* const> summands) noexcept
+      -> RecordType<PassiveType> {
+    RT_ASSERT(!summands.empty(), "Sum requires at least one summand.");
+    PassiveType value = summands[0]->value();
+    for (size_t i = 1; i < summands.size(); ++i) {
+      value = static_cast<PassiveType>(value + summands[i]->value());
+    }
+    return record_operation(NodeType::SUM, std::move(value), summands);
+  }
+
+  // Dot product of `lhs` and `rhs`, recorded as single operation with the entries of `lhs`
+  // followed by the entries of `rhs` as dependencies
+  [[nodiscard]] friend auto dot(std::span<const RecordType<PassiveType>* const> lhs,
+                                std::span<const RecordType<PassiveType>* const> rhs) noexcept
+      -> RecordType<PassiveType> {
+    RT_ASSERT(!lhs.empty() && lhs.size() == rhs.size(),
+              "Dot product requires two non-empty vectors of the same size, but sizes are "
+                  << lhs.size() << " and " << rhs.size());
+    PassiveType value = static_cast<PassiveType>(lhs[0]->value() * rhs[0]->value());
+    for (size_t i = 1; i < lhs.size(); ++i) {
+      value = static_cast<PassiveType>(value + lhs[i]->value() * rhs[i]->value());
+    }
+
+    std::vector<const RecordType<PassiveType>*> args(std::cbegin(lhs), std::cend(lhs));
+    args.insert(std::end(args), std::cbegin(rhs), std::cend(rhs));
+    return record_operation(NodeType::DOT, std::move(value), args);
+  }
+
+  // - Matrix operations ---------------------------------------------------------------------------
+  [[nodiscard]] friend constexpr auto transpose(const RecordType<PassiveType>& x) noexcept
+      -> RecordType<PassiveType>
+  requires is_matrix_type_v<PassiveType>
+  {
+    return record_operation(NodeType::TRANSPOSE, x.value().transpose(), x);
+  }
+
+  // Elementwise product
+  [[nodiscard]] friend constexpr auto cwise_product(const RecordType<PassiveType>& lhs,
+                                                    const RecordType<PassiveType>& rhs) noexcept
+      -> RecordType<PassiveType>
+  requires is_matrix_type_v<PassiveType>
+  {
+    return record_operation(NodeType::CWISE_MUL, lhs.value().cwiseProduct(rhs.value()), lhs, rhs);
+  }
+
+  // Solve the linear system `A * X = B` using a LU decomposition with partial pivoting
+  [[nodiscard]] friend constexpr auto solve(const RecordType<PassiveType>& A,
+                                            const RecordType<PassiveType>& B) noexcept
+      -> RecordType<PassiveType>
+  requires is_matrix_type_v<PassiveType>
+  {
+    return record_operation(NodeType::SOLVE, A.value().partialPivLu().solve(B.value()), A, B);
   }
 
 #ifndef RT_ONLY_FUNDAMENTAL
@@ -337,6 +618,19 @@ constexpr void register_variable(const CT& container,
   });
 }
 
+// - Mark iteration boundary -----------------------------------------------------------------------
+template <FwdContainerType CT, typename PassiveType>
+constexpr void mark_iteration_boundary(const CT& state,
+                                       std::shared_ptr<Graph<PassiveType>> graph) noexcept {
+  std::vector<int64_t> ids{};
+  std::for_each(std::cbegin(state), std::cend(state), [&](const auto& rt) {
+    RT_ASSERT(rt.id() != UNREGISTERED,
+              "State must be part of the graph, but " << rt << " is not registered.");
+    ids.push_back(rt.id());
+  });
+  graph->mark_iteration_boundary(ids);
+}
+
 }  // namespace RT
 
 // NOLINTBEGIN(cert-dcl58-cpp)
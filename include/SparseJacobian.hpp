@@ -0,0 +1,171 @@
+#ifndef RT_SPARSE_JACOBIAN_HPP_
+#define RT_SPARSE_JACOBIAN_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "Derivatives.hpp"
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+
+namespace RT {
+
+// - Sparse matrix in CSR format -------------------------------------------------------------------
+// The entries of row `r` are `values[row_offsets[r]]` to `values[row_offsets[r + 1] - 1]` with
+// column indices `col_indices[...]`; the pattern only (without values) is a sparsity pattern
+template <typename PassiveType>
+struct SparseMatrix {
+  size_t num_rows = 0;
+  size_t num_cols = 0;
+  std::vector<size_t> row_offsets{0ul};
+  std::vector<size_t> col_indices{};
+  std::vector<PassiveType> values{};
+
+  [[nodiscard]] constexpr auto num_nonzeros() const noexcept -> size_t {
+    return col_indices.size();
+  }
+
+  // Row index of every entry, together with `col_indices` and `values` this is the COO format
+  [[nodiscard]] constexpr auto row_indices() const -> std::vector<size_t> {
+    std::vector<size_t> rows(num_nonzeros());
+    for (size_t r = 0; r < num_rows; ++r) {
+      std::fill(std::next(std::begin(rows), static_cast<std::ptrdiff_t>(row_offsets[r])),
+                std::next(std::begin(rows), static_cast<std::ptrdiff_t>(row_offsets[r + 1])),
+                r);
+    }
+    return rows;
+  }
+};
+
+// - Sparsity pattern of the Jacobian --------------------------------------------------------------
+// Propagates the set of inputs every node depends on, the index sets are sorted vectors. Arguments
+// with a derivative that is always zero (comparisons, guards and the condition of a select) are
+// ignored.
+template <typename PassiveType>
+[[nodiscard]] auto jacobian_sparsity(const Tape<PassiveType>& tape,
+                                     std::span<const int64_t> outputs) -> SparseMatrix<bool> {
+  std::vector<std::vector<size_t>> index_sets(tape.num_nodes());
+  for (size_t i = 0; i < tape.inputs().size(); ++i) {
+    index_sets[static_cast<size_t>(tape.inputs()[i])] = {i};
+  }
+
+  std::vector<size_t> merged{};
+  for (int64_t id = 0; id < static_cast<int64_t>(tape.num_nodes()); ++id) {
+    const auto op = tape.op(id);
+    if (op == NodeType::CMP || op == NodeType::GUARD) {
+      continue;
+    }
+
+    auto& set       = index_sets[static_cast<size_t>(id)];
+    const auto args = tape.args(id);
+    for (size_t i = (op == NodeType::SELECT ? 1ul : 0ul); i < args.size(); ++i) {
+      const auto& arg_set = index_sets[static_cast<size_t>(args[i])];
+      merged.clear();
+      std::set_union(std::cbegin(set),
+                     std::cend(set),
+                     std::cbegin(arg_set),
+                     std::cend(arg_set),
+                     std::back_inserter(merged));
+      set.swap(merged);
+    }
+  }
+
+  SparseMatrix<bool> pattern{.num_rows = outputs.size(), .num_cols = tape.inputs().size()};
+  for (auto out : outputs) {
+    RT_ASSERT(out >= 0 && static_cast<size_t>(out) < tape.num_nodes(),
+              "Node with id " << out << " is not part of the graph.");
+    const auto& set = index_sets[static_cast<size_t>(out)];
+    pattern.col_indices.insert(std::end(pattern.col_indices), std::cbegin(set), std::cend(set));
+    pattern.row_offsets.push_back(pattern.col_indices.size());
+  }
+  pattern.values.assign(pattern.num_nonzeros(), true);
+  return pattern;
+}
+
+// - Column coloring -------------------------------------------------------------------------------
+// Greedy distance-2 coloring of the columns: two columns get different colors if they have a
+// nonzero in the same row, such that columns of the same color can be computed in one direction.
+// Returns the color of every column.
+[[nodiscard]] inline auto color_columns(const SparseMatrix<bool>& pattern) -> std::vector<size_t> {
+  // Rows of every column
+  std::vector<std::vector<size_t>> col_rows(pattern.num_cols);
+  for (size_t r = 0; r < pattern.num_rows; ++r) {
+    for (auto k = pattern.row_offsets[r]; k < pattern.row_offsets[r + 1]; ++k) {
+      col_rows[pattern.col_indices[k]].push_back(r);
+    }
+  }
+
+  constexpr auto NO_COLOR = static_cast<size_t>(-1);
+  std::vector<size_t> colors(pattern.num_cols, NO_COLOR);
+  std::vector<size_t> forbidden_by(pattern.num_cols, NO_COLOR);  // Column that forbids a color
+  for (size_t col = 0; col < pattern.num_cols; ++col) {
+    for (auto r : col_rows[col]) {
+      for (auto k = pattern.row_offsets[r]; k < pattern.row_offsets[r + 1]; ++k) {
+        const auto neighbor_color = colors[pattern.col_indices[k]];
+        if (neighbor_color != NO_COLOR) {
+          forbidden_by[neighbor_color] = col;
+        }
+      }
+    }
+
+    size_t color = 0;
+    while (forbidden_by[color] == col) {
+      ++color;
+    }
+    colors[col] = color;
+  }
+  return colors;
+}
+
+// - Sparse Jacobian using compressed forward sweeps -----------------------------------------------
+// Columns of the same color do not share a row, therefore all of them are computed with a single
+// direction of the tangent sweep. The cost scales with the number of colors instead of the number
+// of inputs.
+template <typename PassiveType>
+[[nodiscard]] auto sparse_jacobian(const Tape<PassiveType>& tape,
+                                   std::span<const PassiveType> values,
+                                   std::span<const int64_t> outputs) -> SparseMatrix<PassiveType> {
+  const auto pattern = jacobian_sparsity(tape, outputs);
+  const auto colors  = color_columns(pattern);
+  const auto num_colors =
+      colors.empty() ? 0ul : *std::max_element(std::cbegin(colors), std::cend(colors)) + 1ul;
+
+  // Seed matrix, input major
+  std::vector<PassiveType> directions(pattern.num_cols * num_colors, static_cast<PassiveType>(0));
+  for (size_t col = 0; col < pattern.num_cols; ++col) {
+    directions[col * num_colors + colors[col]] = static_cast<PassiveType>(1);
+  }
+  const auto compressed =
+      jacobian_matrix_product<PassiveType>(tape, values, outputs, directions, num_colors);
+
+  SparseMatrix<PassiveType> jac{
+      .num_rows    = pattern.num_rows,
+      .num_cols    = pattern.num_cols,
+      .row_offsets = pattern.row_offsets,
+      .col_indices = pattern.col_indices,
+      .values      = std::vector<PassiveType>(pattern.num_nonzeros()),
+  };
+  for (size_t r = 0; r < jac.num_rows; ++r) {
+    for (auto k = jac.row_offsets[r]; k < jac.row_offsets[r + 1]; ++k) {
+      jac.values[k] = compressed[r * num_colors + colors[jac.col_indices[k]]];
+    }
+  }
+  return jac;
+}
+
+// Same as above, uses the recorded values
+template <typename PassiveType>
+[[nodiscard]] auto sparse_jacobian(const Graph<PassiveType>& graph,
+                                   std::span<const int64_t> outputs) -> SparseMatrix<PassiveType> {
+  const Tape<PassiveType> tape(graph);
+  return sparse_jacobian<PassiveType>(tape, tape.values(), outputs);
+}
+
+}  // namespace RT
+
+#endif  // RT_SPARSE_JACOBIAN_HPP_
@@ -0,0 +1,304 @@
+#ifndef RT_STATIC_GRAPH_HPP_
+#define RT_STATIC_GRAPH_HPP_
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "Macros.hpp"
+#include "NodeType.hpp"
+
+namespace RT {
+
+// - Node of a graph that is recorded at compile time ----------------------------------------------
+// `VAR` nodes load the input `lhs`, `LITERAL` nodes hold `value`, all other nodes apply `op` to the
+// nodes `lhs` and `rhs` (unary operations only use `lhs`).
+template <typename PassiveType>
+struct StaticNode {
+  NodeType op{};
+  uint32_t lhs{};
+  uint32_t rhs{};
+  PassiveType value{};
+};
+
+// - Graph with a fixed capacity that can be used as a template argument ---------------------------
+template <typename PassiveType, size_t NumInputs, size_t NumOutputs, size_t Capacity>
+struct StaticGraph {
+  using passive_type                    = PassiveType;
+  static constexpr size_t num_inputs    = NumInputs;
+  static constexpr size_t num_outputs   = NumOutputs;
+  static constexpr size_t node_capacity = Capacity;
+
+  std::array<StaticNode<PassiveType>, Capacity> nodes{};
+  std::array<uint32_t, NumOutputs> outputs{};
+  size_t num_nodes = 0;
+};
+
+namespace detail {
+
+template <typename PassiveType, size_t Capacity>
+struct StaticTape {
+  std::array<StaticNode<PassiveType>, Capacity> nodes{};
+  size_t num_nodes = 0;
+
+  [[nodiscard]] constexpr auto add(NodeType op, uint32_t lhs, uint32_t rhs, PassiveType value)
+      -> uint32_t {
+    RT_ASSERT(num_nodes < Capacity,
+              "Static graph exceeds its capacity of " << Capacity << " nodes.");
+    nodes[num_nodes] = StaticNode<PassiveType>{.op = op, .lhs = lhs, .rhs = rhs, .value = value};
+    return static_cast<uint32_t>(num_nodes++);
+  }
+};
+
+}  // namespace detail
+
+// - Type used to record a function at compile time ------------------------------------------------
+// Values that do not depend on an input are folded into constants instead of being recorded.
+// Comparisons are not available because the control flow of the recorded function is fixed.
+template <typename PassiveType, size_t Capacity>
+class StaticRecordType {
+  using Tape = detail::StaticTape<PassiveType, Capacity>;
+
+  Tape* m_tape = nullptr;
+  uint32_t m_id{};
+  PassiveType m_value{};
+
+  // Id of `x` on `tape`, constants are recorded on first use
+  [[nodiscard]] static constexpr auto node_on(const StaticRecordType& x, Tape* tape) -> uint32_t {
+    return x.m_tape ? x.m_id : tape->add(NodeType::LITERAL, 0, 0, x.m_value);
+  }
+
+  [[nodiscard]] static constexpr auto record_binary(NodeType op,
+                                                    const StaticRecordType& lhs,
+                                                    const StaticRecordType& rhs)
+      -> StaticRecordType {
+    Tape* tape = lhs.m_tape ? lhs.m_tape : rhs.m_tape;
+    if (tape == nullptr) {
+      switch (op) {
+        case NodeType::ADD:
+          return StaticRecordType(lhs.m_value + rhs.m_value);
+        case NodeType::SUB:
+          return StaticRecordType(lhs.m_value - rhs.m_value);
+        case NodeType::MUL:
+          return StaticRecordType(lhs.m_value * rhs.m_value);
+        default:
+          return StaticRecordType(lhs.m_value / rhs.m_value);
+      }
+    }
+    RT_ASSERT(lhs.m_tape == nullptr || rhs.m_tape == nullptr || lhs.m_tape == rhs.m_tape,
+              "Operands are recorded on different static graphs.");
+    const auto l = node_on(lhs, tape);
+    const auto r = node_on(rhs, tape);
+    return StaticRecordType(tape, tape->add(op, l, r, PassiveType{}));
+  }
+
+  [[nodiscard]] static constexpr auto record_unary(NodeType op,
+                                                   const StaticRecordType& x,
+                                                   PassiveType folded) -> StaticRecordType {
+    if (x.m_tape == nullptr) {
+      return StaticRecordType(folded);
+    }
+    return StaticRecordType(x.m_tape, x.m_tape->add(op, x.m_id, 0, PassiveType{}));
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  constexpr StaticRecordType() noexcept = default;
+
+  // -----------------------------------------------------------------------------------------------
+  constexpr StaticRecordType(PassiveType value) noexcept
+      : m_value(value) {}
+
+  // -----------------------------------------------------------------------------------------------
+  // Node `id` on `tape`, used by `record_static`
+  constexpr StaticRecordType(Tape* tape, uint32_t id) noexcept
+      : m_tape(tape),
+        m_id(id) {}
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto is_constant() const noexcept -> bool { return m_tape == nullptr; }
+
+  // -----------------------------------------------------------------------------------------------
+  // Node of the value on `tape`, records a constant if necessary
+  [[nodiscard]] constexpr auto id_on(Tape* tape) const -> uint32_t { return node_on(*this, tape); }
+
+  // -----------------------------------------------------------------------------------------------
+  constexpr auto operator+=(const StaticRecordType& other) -> StaticRecordType& {
+    *this = *this + other;
+    return *this;
+  }
+
+  constexpr auto operator-=(const StaticRecordType& other) -> StaticRecordType& {
+    *this = *this - other;
+    return *this;
+  }
+
+  constexpr auto operator*=(const StaticRecordType& other) -> StaticRecordType& {
+    *this = *this * other;
+    return *this;
+  }
+
+  constexpr auto operator/=(const StaticRecordType& other) -> StaticRecordType& {
+    *this = *this / other;
+    return *this;
+  }
+
+  // Subtraction and division are recorded as single operations so that the replay rounds exactly
+  // like the recorded function
+  [[nodiscard]] friend constexpr auto operator+(const StaticRecordType& lhs,
+                                                const StaticRecordType& rhs) -> StaticRecordType {
+    return record_binary(NodeType::ADD, lhs, rhs);
+  }
+
+  [[nodiscard]] friend constexpr auto operator-(const StaticRecordType& lhs,
+                                                const StaticRecordType& rhs) -> StaticRecordType {
+    return record_binary(NodeType::SUB, lhs, rhs);
+  }
+
+  [[nodiscard]] friend constexpr auto operator*(const StaticRecordType& lhs,
+                                                const StaticRecordType& rhs) -> StaticRecordType {
+    return record_binary(NodeType::MUL, lhs, rhs);
+  }
+
+  [[nodiscard]] friend constexpr auto operator/(const StaticRecordType& lhs,
+                                                const StaticRecordType& rhs) -> StaticRecordType {
+    return record_binary(NodeType::DIV, lhs, rhs);
+  }
+
+  [[nodiscard]] constexpr auto operator-() const -> StaticRecordType {
+    return record_unary(NodeType::NEG, *this, -m_value);
+  }
+
+  // Constants are folded with the standard functions, which GCC evaluates at compile time
+  [[nodiscard]] friend constexpr auto sqrt(const StaticRecordType& x) -> StaticRecordType {
+    return record_unary(NodeType::SQRT, x, x.is_constant() ? std::sqrt(x.m_value) : PassiveType{});
+  }
+
+  [[nodiscard]] friend constexpr auto sin(const StaticRecordType& x) -> StaticRecordType {
+    return record_unary(NodeType::SIN, x, x.is_constant() ? std::sin(x.m_value) : PassiveType{});
+  }
+
+  [[nodiscard]] friend constexpr auto cos(const StaticRecordType& x) -> StaticRecordType {
+    return record_unary(NodeType::COS, x, x.is_constant() ? std::cos(x.m_value) : PassiveType{});
+  }
+};
+
+// - Record a function into a static graph ---------------------------------------------------------
+// `f` is called with a `std::array` of `NumInputs` record types and returns either a single record
+// type or a `std::array` of them. Meant to be evaluated at compile time, e.g.
+//   constexpr auto g = RT::record_static<double, 2>([](const auto& x) { return f(x[0], x[1]); });
+template <typename PassiveType, size_t NumInputs, size_t Capacity = 64, typename Function>
+[[nodiscard]] constexpr auto record_static(Function f) {
+  using RType = StaticRecordType<PassiveType, Capacity>;
+
+  detail::StaticTape<PassiveType, Capacity> tape{};
+  std::array<RType, NumInputs> inputs{};
+  for (size_t i = 0; i < NumInputs; ++i) {
+    inputs[i] = RType(&tape, tape.add(NodeType::VAR, static_cast<uint32_t>(i), 0, PassiveType{}));
+  }
+
+  const auto result = f(std::as_const(inputs));
+  if constexpr (std::is_same_v<std::remove_cvref_t<decltype(result)>, RType>) {
+    StaticGraph<PassiveType, NumInputs, 1, Capacity> graph{};
+    graph.outputs[0] = result.id_on(&tape);
+    graph.nodes      = tape.nodes;
+    graph.num_nodes  = tape.num_nodes;
+    return graph;
+  } else {
+    StaticGraph<PassiveType, NumInputs, std::tuple_size_v<decltype(result)>, Capacity> graph{};
+    for (size_t o = 0; o < result.size(); ++o) {
+      graph.outputs[o] = result[o].id_on(&tape);
+    }
+    graph.nodes     = tape.nodes;
+    graph.num_nodes = tape.num_nodes;
+    return graph;
+  }
+}
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool always_false_v = false;
+
+template <auto Graph, size_t Idx, typename PassiveType, size_t NumValues, size_t NumInputs>
+constexpr void static_node(std::array<PassiveType, NumValues>& values,
+                           const std::array<PassiveType, NumInputs>& inputs) {
+  constexpr auto node = Graph.nodes[Idx];
+  if constexpr (node.op == NodeType::VAR) {
+    values[Idx] = inputs[node.lhs];
+  } else if constexpr (node.op == NodeType::LITERAL) {
+    values[Idx] = node.value;
+  } else if constexpr (node.op == NodeType::ADD) {
+    values[Idx] = values[node.lhs] + values[node.rhs];
+  } else if constexpr (node.op == NodeType::SUB) {
+    values[Idx] = values[node.lhs] - values[node.rhs];
+  } else if constexpr (node.op == NodeType::MUL) {
+    values[Idx] = values[node.lhs] * values[node.rhs];
+  } else if constexpr (node.op == NodeType::DIV) {
+    values[Idx] = values[node.lhs] / values[node.rhs];
+  } else if constexpr (node.op == NodeType::NEG) {
+    values[Idx] = -values[node.lhs];
+  } else if constexpr (node.op == NodeType::SQRT) {
+    values[Idx] = std::sqrt(values[node.lhs]);
+  } else if constexpr (node.op == NodeType::SIN) {
+    values[Idx] = std::sin(values[node.lhs]);
+  } else if constexpr (node.op == NodeType::COS) {
+    values[Idx] = std::cos(values[node.lhs]);
+  } else {
+    static_assert(always_false_v<PassiveType>, "Operation is not supported by static graphs.");
+  }
+}
+
+}  // namespace detail
+
+// - Evaluate a static graph -----------------------------------------------------------------------
+// The evaluation is unrolled over the nodes at compile time, there is no dispatch on the operations
+// at runtime. Unused nodes are removed by the compiler.
+template <auto Graph>
+[[nodiscard]] constexpr auto static_evaluate(
+    const std::array<typename decltype(Graph)::passive_type, decltype(Graph)::num_inputs>& inputs)
+    -> std::array<typename decltype(Graph)::passive_type, decltype(Graph)::num_outputs> {
+  using GraphType   = decltype(Graph);
+  using PassiveType = typename GraphType::passive_type;
+
+  std::array<PassiveType, Graph.num_nodes> values{};
+  [&]<size_t... Idx>(std::index_sequence<Idx...>) {
+    (detail::static_node<Graph, Idx>(values, inputs), ...);
+  }(std::make_index_sequence<Graph.num_nodes>{});
+
+  std::array<PassiveType, GraphType::num_outputs> outputs{};
+  for (size_t o = 0; o < outputs.size(); ++o) {
+    outputs[o] = values[Graph.outputs[o]];
+  }
+  return outputs;
+}
+
+}  // namespace RT
+
+// NOLINTBEGIN(cert-dcl58-cpp)
+namespace std {
+
+template <typename PassiveType, size_t Capacity>
+[[nodiscard]] constexpr auto sqrt(const RT::StaticRecordType<PassiveType, Capacity>& x)
+    -> RT::StaticRecordType<PassiveType, Capacity> {
+  return sqrt(x);
+}
+
+template <typename PassiveType, size_t Capacity>
+[[nodiscard]] constexpr auto sin(const RT::StaticRecordType<PassiveType, Capacity>& x)
+    -> RT::StaticRecordType<PassiveType, Capacity> {
+  return sin(x);
+}
+
+template <typename PassiveType, size_t Capacity>
+[[nodiscard]] constexpr auto cos(const RT::StaticRecordType<PassiveType, Capacity>& x)
+    -> RT::StaticRecordType<PassiveType, Capacity> {
+  return cos(x);
+}
+
+}  // namespace std
+// NOLINTEND(cert-dcl58-cpp)
+
+#endif  // RT_STATIC_GRAPH_HPP_
@@ -0,0 +1,389 @@
+#ifndef RT_STREAMING_EVALUATOR_HPP_
+#define RT_STREAMING_EVALUATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Bytecode.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+namespace RT {
+
+// - Part of the bytecode that is resident during a streaming replay -------------------------------
+// Operand offsets and constant indices of the instructions are relative to the chunk.
+template <typename PassiveType>
+struct BytecodeChunk {
+  std::vector<Instruction> code{};
+  std::vector<uint32_t> operands{};
+  std::vector<PassiveType> constants{};
+  std::vector<int64_t> node_ids{};
+
+  [[nodiscard]] constexpr auto size_bytes() const noexcept -> size_t {
+    return code.size() * sizeof(Instruction) + operands.size() * sizeof(uint32_t) +
+           constants.size() * sizeof(PassiveType) + node_ids.size() * sizeof(int64_t);
+  }
+};
+
+namespace detail {
+
+inline constexpr std::array<char, 4> BYTECODE_MAGIC{'R', 'T', 'B', 'C'};
+inline constexpr uint32_t BYTECODE_VERSION = 1;
+
+struct BytecodeFileHeader {
+  std::array<char, 4> magic;
+  uint32_t version;
+  uint64_t value_size;
+  uint64_t num_inputs;
+  uint64_t num_registers;
+  uint64_t num_outputs;
+  uint64_t num_chunks;
+};
+
+struct BytecodeChunkHeader {
+  uint64_t num_instructions;
+  uint64_t num_operands;
+  uint64_t num_constants;
+};
+
+template <typename T, size_t Extent>
+void write_binary(std::ofstream& out, std::span<T, Extent> data) {
+  out.write(reinterpret_cast<const char*>(data.data()),
+            static_cast<std::streamsize>(data.size_bytes()));
+}
+
+template <typename T, size_t Extent>
+void read_binary(std::ifstream& in, std::span<T, Extent> data) {
+  in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size_bytes()));
+}
+
+template <typename PassiveType>
+[[nodiscard]] auto read_chunk(std::ifstream& in, const std::filesystem::path& file)
+    -> BytecodeChunk<PassiveType> {
+  using namespace std::literals;
+
+  BytecodeChunkHeader header{};
+  read_binary(in, std::span{&header, 1});
+  BytecodeChunk<PassiveType> chunk{};
+  if (in) {
+    chunk.code.resize(header.num_instructions);
+    chunk.operands.resize(header.num_operands);
+    chunk.constants.resize(header.num_constants);
+    chunk.node_ids.resize(header.num_instructions);
+    read_binary(in, std::span{chunk.code});
+    read_binary(in, std::span{chunk.operands});
+    read_binary(in, std::span{chunk.constants});
+    read_binary(in, std::span{chunk.node_ids});
+  }
+  if (!in) {
+    throw std::runtime_error(RT_ERROR_LOC() + ": Could not read chunk from `"s + file.string() +
+                             "`, the file is truncated."s);
+  }
+  return chunk;
+}
+
+// - Minimal generator coroutine -------------------------------------------------------------------
+// Yields references to values that live in the coroutine frame until it is resumed again.
+template <typename T>
+class Generator {
+ public:
+  struct promise_type {
+    T* value = nullptr;
+    std::exception_ptr exception{};
+
+    [[nodiscard]] auto get_return_object() -> Generator {
+      return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    [[nodiscard]] auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+    [[nodiscard]] auto final_suspend() noexcept -> std::suspend_always { return {}; }
+    auto yield_value(T& v) noexcept -> std::suspend_always {
+      value = &v;
+      return {};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+  };
+
+ private:
+  std::coroutine_handle<promise_type> m_handle;
+
+  explicit Generator(std::coroutine_handle<promise_type> handle) noexcept
+      : m_handle(handle) {}
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  Generator(const Generator&)                    = delete;
+  auto operator=(const Generator&) -> Generator& = delete;
+  Generator(Generator&& other) noexcept
+      : m_handle(std::exchange(other.m_handle, nullptr)) {}
+  auto operator=(Generator&& other) noexcept -> Generator& {
+    std::swap(m_handle, other.m_handle);
+    return *this;
+  }
+  ~Generator() noexcept {
+    if (m_handle) {
+      m_handle.destroy();
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Next value or `nullptr` if the coroutine is done, rethrows exceptions of the coroutine
+  [[nodiscard]] auto next() -> T* {
+    if (m_handle.done()) {
+      return nullptr;
+    }
+    m_handle.resume();
+    if (m_handle.done()) {
+      if (m_handle.promise().exception) {
+        std::rethrow_exception(m_handle.promise().exception);
+      }
+      return nullptr;
+    }
+    return m_handle.promise().value;
+  }
+};
+
+// - Read the chunks of a bytecode file one after the other ----------------------------------------
+// The next chunk is read asynchronously while the consumer works on the current one, so at most two
+// chunks are resident at any time.
+template <typename PassiveType>
+[[nodiscard]] auto stream_chunks(std::filesystem::path file,
+                                 std::streamoff offset,
+                                 size_t num_chunks) -> Generator<BytecodeChunk<PassiveType>> {
+  using namespace std::literals;
+
+  std::ifstream in(file, std::ios::binary);
+  in.seekg(offset);
+  if (!in) {
+    throw std::runtime_error(RT_ERROR_LOC() + ": Could not open file `"s + file.string() +
+                             "`: "s + std::strerror(errno));
+  }
+
+  const auto read_next = [&in, &file]() { return read_chunk<PassiveType>(in, file); };
+  std::future<BytecodeChunk<PassiveType>> prefetch{};
+  if (num_chunks > 0) {
+    prefetch = std::async(std::launch::async, read_next);
+  }
+  for (size_t k = 0; k < num_chunks; ++k) {
+    auto chunk = prefetch.get();
+    if (k + 1 < num_chunks) {
+      prefetch = std::async(std::launch::async, read_next);
+    }
+    co_yield chunk;
+  }
+}
+
+}  // namespace detail
+
+// - Write bytecode to a file in chunks of `chunk_size` instructions -------------------------------
+// Every chunk carries the operands, constants and node ids of its instructions, so it can be
+// replayed without the rest of the bytecode.
+template <typename PassiveType>
+void save_bytecode(const Bytecode<PassiveType>& bytecode,
+                   const std::filesystem::path& file,
+                   size_t chunk_size = 1ul << 16ul) {
+  static_assert(std::is_trivially_copyable_v<PassiveType> && !is_matrix_type_v<PassiveType>,
+                "Only scalar passive types can be streamed.");
+  using namespace std::literals;
+  RT_ASSERT(chunk_size > 0, "Chunk size must be positive.");
+
+  std::ofstream out(file, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error(RT_ERROR_LOC() + ": Could not open file `"s + file.string() +
+                             "`: "s + std::strerror(errno));
+  }
+
+  const auto num_instructions = bytecode.code.size();
+  const detail::BytecodeFileHeader header{
+      .magic         = detail::BYTECODE_MAGIC,
+      .version       = detail::BYTECODE_VERSION,
+      .value_size    = sizeof(PassiveType),
+      .num_inputs    = bytecode.num_inputs,
+      .num_registers = bytecode.num_registers,
+      .num_outputs   = bytecode.output_registers.size(),
+      .num_chunks    = (num_instructions + chunk_size - 1) / chunk_size,
+  };
+  detail::write_binary(out, std::span{&header, 1});
+  detail::write_binary(out, std::span{bytecode.output_registers});
+
+  BytecodeChunk<PassiveType> chunk{};
+  for (size_t begin = 0; begin < num_instructions; begin += chunk_size) {
+    const auto end = std::min(begin + chunk_size, num_instructions);
+    chunk.code.clear();
+    chunk.operands.clear();
+    chunk.constants.clear();
+    chunk.node_ids.assign(std::next(bytecode.node_ids.begin(), static_cast<std::ptrdiff_t>(begin)),
+                          std::next(bytecode.node_ids.begin(), static_cast<std::ptrdiff_t>(end)));
+
+    for (size_t pc = begin; pc < end; ++pc) {
+      auto ins = bytecode.code[pc];
+      if (ins.num_args == 0 && ins.op == NodeType::LITERAL) {
+        chunk.constants.push_back(bytecode.constants[ins.args]);
+        ins.args = static_cast<uint32_t>(chunk.constants.size() - 1);
+      } else if (ins.num_args > 0) {
+        const auto args = std::span{bytecode.operands}.subspan(ins.args, ins.num_args);
+        ins.args        = static_cast<uint32_t>(chunk.operands.size());
+        chunk.operands.insert(chunk.operands.end(), args.begin(), args.end());
+      }
+      chunk.code.push_back(ins);
+    }
+
+    const detail::BytecodeChunkHeader chunk_header{.num_instructions = chunk.code.size(),
+                                                   .num_operands     = chunk.operands.size(),
+                                                   .num_constants    = chunk.constants.size()};
+    detail::write_binary(out, std::span{&chunk_header, 1});
+    detail::write_binary(out, std::span{chunk.code});
+    detail::write_binary(out, std::span{chunk.operands});
+    detail::write_binary(out, std::span{chunk.constants});
+    detail::write_binary(out, std::span{chunk.node_ids});
+  }
+
+  if (!out) {
+    throw std::runtime_error(RT_ERROR_LOC() + ": Could not write file `"s + file.string() +
+                             "`: "s + std::strerror(errno));
+  }
+}
+
+// - Replay bytecode that is streamed from a file --------------------------------------------------
+// Only the register file, i.e. the values that are live at the same time, and two chunks of the
+// bytecode are resident during a replay: the chunk that is evaluated and the next one, which is
+// read in the background.
+template <typename PassiveType>
+class StreamingEvaluator {
+  static_assert(std::is_trivially_copyable_v<PassiveType> && !is_matrix_type_v<PassiveType>,
+                "Only scalar passive types can be streamed.");
+
+  std::filesystem::path m_file;
+  std::streamoff m_chunks_offset = 0;
+  size_t m_num_inputs            = 0;
+  size_t m_num_chunks            = 0;
+  std::vector<uint32_t> m_output_registers{};
+  std::vector<PassiveType> m_registers{};
+  std::vector<int64_t> m_violated_guards{};
+  size_t m_max_chunk_size = 0;
+
+  void evaluate_chunk(const BytecodeChunk<PassiveType>& chunk,
+                      std::span<const PassiveType> inputs) {
+    const auto* operands = chunk.operands.data();
+    for (size_t pc = 0; pc < chunk.code.size(); ++pc) {
+      const auto& ins = chunk.code[pc];
+      if (ins.num_args == 0) {
+        m_registers[ins.dst] =
+            ins.op == NodeType::VAR ? inputs[ins.args] : chunk.constants[ins.args];
+        continue;
+      }
+
+      const auto* args     = operands + ins.args;
+      m_registers[ins.dst] = detail::apply_operation<PassiveType>(
+          ins.op, ins.attribute, ins.num_args, [&](size_t i) -> const PassiveType& {
+            return m_registers[args[i]];
+          });
+
+      if (ins.op == NodeType::GUARD &&
+          static_cast<int64_t>(m_registers[ins.dst] != static_cast<PassiveType>(0)) !=
+              ins.attribute) {
+        m_violated_guards.push_back(chunk.node_ids[pc]);
+      }
+    }
+  }
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  // Reads the header of a file written by `save_bytecode`, the bytecode is read by `evaluate`
+  explicit StreamingEvaluator(std::filesystem::path file)
+      : m_file(std::move(file)) {
+    using namespace std::literals;
+
+    std::ifstream in(m_file, std::ios::binary);
+    if (!in) {
+      throw std::runtime_error(RT_ERROR_LOC() + ": Could not open file `"s + m_file.string() +
+                               "`: "s + std::strerror(errno));
+    }
+
+    detail::BytecodeFileHeader header{};
+    detail::read_binary(in, std::span{&header, 1});
+    if (!in || header.magic != detail::BYTECODE_MAGIC ||
+        header.version != detail::BYTECODE_VERSION) {
+      throw std::runtime_error(RT_ERROR_LOC() + ": `"s + m_file.string() +
+                               "` is not a bytecode file."s);
+    }
+    if (header.value_size != sizeof(PassiveType)) {
+      throw std::runtime_error(RT_ERROR_LOC() + ": `"s + m_file.string() +
+                               "` was written for a passive type of size "s +
+                               std::to_string(header.value_size) + ", expected "s +
+                               std::to_string(sizeof(PassiveType)) + "."s);
+    }
+
+    m_num_inputs = header.num_inputs;
+    m_num_chunks = header.num_chunks;
+    m_output_registers.resize(header.num_outputs);
+    detail::read_binary(in, std::span{m_output_registers});
+    if (!in) {
+      throw std::runtime_error(RT_ERROR_LOC() + ": Could not read outputs from `"s +
+                               m_file.string() + "`, the file is truncated."s);
+    }
+    m_chunks_offset = in.tellg();
+    m_registers.resize(header.num_registers);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  void evaluate(std::span<const PassiveType> inputs) {
+    RT_ASSERT(inputs.size() == m_num_inputs,
+              "Expected " << m_num_inputs << " inputs, but got " << inputs.size());
+
+    m_violated_guards.clear();
+    auto chunks = detail::stream_chunks<PassiveType>(m_file, m_chunks_offset, m_num_chunks);
+    while (const auto* chunk = chunks.next()) {
+      m_max_chunk_size = std::max(m_max_chunk_size, chunk->size_bytes());
+      evaluate_chunk(*chunk, inputs);
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Value of the `idx`-th output passed to `compile`
+  [[nodiscard]] constexpr auto output(size_t idx) const noexcept -> const PassiveType& {
+    RT_ASSERT(idx < m_output_registers.size(),
+              "Output " << idx << " does not exist, there are " << m_output_registers.size()
+                        << " outputs.");
+    return m_registers[m_output_registers[idx]];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto guards_hold() const noexcept -> bool {
+    return m_violated_guards.empty();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto violated_guards() const noexcept -> const std::vector<int64_t>& {
+    return m_violated_guards;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_chunks() const noexcept -> size_t { return m_num_chunks; }
+
+  // -----------------------------------------------------------------------------------------------
+  // Upper bound of the bytes that were resident during the last replay, without the inputs
+  [[nodiscard]] constexpr auto resident_size() const noexcept -> size_t {
+    return m_registers.size() * sizeof(PassiveType) + 2 * m_max_chunk_size;
+  }
+};
+
+}  // namespace RT
+
+#endif  // RT_STREAMING_EVALUATOR_HPP_
@@ -0,0 +1,205 @@
+#ifndef RT_TAPE_HPP_
+#define RT_TAPE_HPP_
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#ifndef RT_ONLY_FUNDAMENTAL
+#include <cmath>
+#endif  // RT_ONLY_FUNDAMENTAL
+
+#include "CustomOp.hpp"
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "TypeTraits.hpp"
+
+namespace RT {
+
+// - Flat representation of a recorded graph -------------------------------------------------------
+// The arguments of all nodes are stored contiguously (CSR format), the arguments of node `id` are
+// `m_args[m_arg_offsets[id]]` to `m_args[m_arg_offsets[id + 1] - 1]`. Nodes without arguments are
+// either inputs or constants.
+template <typename PassiveType>
+class Tape {
+  std::vector<NodeType> m_ops{};
+  std::vector<size_t> m_arg_offsets{};
+  std::vector<int64_t> m_args{};
+  std::vector<int64_t> m_attributes{};  // ComparisonType, custom op id or the outcome of a guard
+  std::vector<int64_t> m_inputs{};
+  std::vector<PassiveType> m_values{};  // Recorded values, constants keep their value
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  explicit Tape(const Graph<PassiveType>& graph)
+      : m_ops(graph.operations()),
+        m_attributes(graph.operations().size(), 0),
+        m_inputs(graph.inputs()),
+        m_values(graph.values()) {
+    m_arg_offsets.reserve(m_ops.size() + 1ul);
+    m_args.reserve(graph.dependencies().size() - m_ops.size());
+    m_arg_offsets.push_back(0ul);
+
+    graph.for_each_node([&](int64_t id, NodeType op, std::span<const int64_t> args) {
+      m_args.insert(std::end(m_args), std::cbegin(args), std::cend(args));
+      m_arg_offsets.push_back(m_args.size());
+
+      const auto idx = static_cast<size_t>(id);
+      switch (op) {
+        case NodeType::CMP:
+        case NodeType::CUSTOM:
+          m_attributes[idx] = graph.attribute(id);
+          break;
+        case NodeType::GUARD:
+          if constexpr (!is_matrix_type_v<PassiveType>) {
+            m_attributes[idx] = static_cast<int64_t>(m_values[idx] != static_cast<PassiveType>(0));
+          }
+          break;
+        default:
+          break;
+      }
+    });
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_nodes() const noexcept -> size_t { return m_ops.size(); }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto op(int64_t id) const noexcept -> NodeType {
+    return m_ops[static_cast<size_t>(id)];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto args(int64_t id) const noexcept -> std::span<const int64_t> {
+    const auto idx = static_cast<size_t>(id);
+    return std::span<const int64_t>(m_args).subspan(m_arg_offsets[idx],
+                                                    m_arg_offsets[idx + 1] - m_arg_offsets[idx]);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto attribute(int64_t id) const noexcept -> int64_t {
+    return m_attributes[static_cast<size_t>(id)];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto inputs() const noexcept -> const std::vector<int64_t>& {
+    return m_inputs;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto values() const noexcept -> const std::vector<PassiveType>& {
+    return m_values;
+  }
+};
+
+namespace detail {
+
+// - Evaluate a single operation -------------------------------------------------------------------
+// `arg(i)` returns the value of the i-th argument. Computes the value exactly like `RecordType`,
+// such that a replay with the recorded inputs reproduces the recorded values.
+template <typename PassiveType, typename ArgFunc>
+[[nodiscard]] auto
+apply_operation(NodeType op, int64_t attribute, size_t num_args, const ArgFunc& arg)
+    -> PassiveType {
+  switch (op) {
+    case NodeType::LITERAL:
+    case NodeType::VAR:
+      RT_ASSERT(num_args == 1, "Expected one dependency, but got " << num_args);
+      return arg(0);
+    case NodeType::ADD:
+      return static_cast<PassiveType>(arg(0) + arg(1));
+    case NodeType::NEG:
+      return static_cast<PassiveType>(-arg(0));
+    default:
+      break;
+  }
+
+  if constexpr (is_matrix_type_v<PassiveType>) {
+    switch (op) {
+      case NodeType::GEMM:
+        return static_cast<PassiveType>(arg(0) * arg(1));
+      case NodeType::TRANSPOSE:
+        return arg(0).transpose();
+      case NodeType::SOLVE:
+        return arg(0).partialPivLu().solve(arg(1));
+      case NodeType::CWISE_MUL:
+        return arg(0).cwiseProduct(arg(1));
+      default:
+        RT_PANIC("Operation " << op << " is not supported for matrix types.");
+    }
+  } else {
+#ifndef RT_ONLY_FUNDAMENTAL
+    // Found by argument dependent lookup for user defined scalar types, e.g. `DoubleDouble`
+    using std::cos;
+    using std::sin;
+    using std::sqrt;
+#endif  // RT_ONLY_FUNDAMENTAL
+
+    switch (op) {
+      case NodeType::MUL:
+        return static_cast<PassiveType>(arg(0) * arg(1));
+      case NodeType::INV:
+        return static_cast<PassiveType>(static_cast<PassiveType>(1) / arg(0));
+      case NodeType::SUB:
+        return static_cast<PassiveType>(arg(0) - arg(1));
+      case NodeType::DIV:
+        RT_ASSERT(arg(1) != static_cast<PassiveType>(0), "Division by zero.");
+        return static_cast<PassiveType>(arg(0) / arg(1));
+      case NodeType::MOD:
+        if constexpr (std::is_integral_v<PassiveType>) {
+          RT_ASSERT(arg(1) != static_cast<PassiveType>(0), "Division by zero.");
+          return static_cast<PassiveType>(arg(0) % arg(1));
+        } else {
+          RT_PANIC("Operation MOD requires an integral type.");
+        }
+#ifndef RT_ONLY_FUNDAMENTAL
+      case NodeType::SQRT:
+        return static_cast<PassiveType>(sqrt(arg(0)));
+      case NodeType::SIN:
+        return static_cast<PassiveType>(sin(arg(0)));
+      case NodeType::COS:
+        return static_cast<PassiveType>(cos(arg(0)));
+#endif  // RT_ONLY_FUNDAMENTAL
+      case NodeType::CMP:
+        return static_cast<PassiveType>(
+            evaluate_comparison(arg(0), arg(1), static_cast<ComparisonType>(attribute)));
+      case NodeType::SELECT:
+        return arg(0) != static_cast<PassiveType>(0) ? arg(1) : arg(2);
+      case NodeType::GUARD:
+        return arg(0);
+      case NodeType::SUM:
+        {
+          PassiveType value = arg(0);
+          for (size_t i = 1; i < num_args; ++i) {
+            value = static_cast<PassiveType>(value + arg(i));
+          }
+          return value;
+        }
+      case NodeType::DOT:
+        {
+          const auto n      = num_args / 2;
+          PassiveType value = static_cast<PassiveType>(arg(0) * arg(n));
+          for (size_t i = 1; i < n; ++i) {
+            value = static_cast<PassiveType>(value + arg(i) * arg(n + i));
+          }
+          return value;
+        }
+      case NodeType::CUSTOM:
+        {
+          std::vector<PassiveType> arg_values(num_args);
+          for (size_t i = 0; i < num_args; ++i) {
+            arg_values[i] = arg(i);
+          }
+          return CustomOpRegistry<PassiveType>::get(attribute).forward(arg_values);
+        }
+      default:
+        RT_PANIC("Operation " << op << " is not supported for scalar types.");
+    }
+  }
+}
+
+}  // namespace detail
+
+}  // namespace RT
+
+#endif  // RT_TAPE_HPP_
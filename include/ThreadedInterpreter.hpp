@@ -0,0 +1,471 @@
+#ifndef RT_THREADED_INTERPRETER_HPP_
+#define RT_THREADED_INTERPRETER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <utility>
+#include <vector>
+#ifndef RT_ONLY_FUNDAMENTAL
+#include <cmath>
+#endif  // RT_ONLY_FUNDAMENTAL
+
+#include "Bytecode.hpp"
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+// Computed goto (`&&label`, `goto *ptr`) is a GNU extension, other compilers use switch dispatch
+#if defined(__GNUC__) && !defined(RT_NO_COMPUTED_GOTO)
+#define RT_HAS_COMPUTED_GOTO 1
+#else
+#define RT_HAS_COMPUTED_GOTO 0
+#endif
+
+namespace RT {
+
+struct ThreadedInterpreterOptions {
+  bool superinstructions = true;  // Fuse MUL followed by ADD and INV followed by MUL
+  bool computed_goto     = true;  // Direct threading, falls back to switch dispatch if unsupported
+};
+
+// - Frequency of dependent op pairs ---------------------------------------------------------------
+// Number of times an instruction of type `first` is directly followed by an instruction of type
+// `second` that reads its result, i.e. the candidates for superinstructions
+struct OpPairCount {
+  NodeType first;
+  NodeType second;
+  size_t count;
+};
+
+template <typename PassiveType>
+[[nodiscard]] auto profile_op_pairs(const Bytecode<PassiveType>& bytecode)
+    -> std::vector<OpPairCount> {
+  std::map<std::pair<NodeType, NodeType>, size_t> counts{};
+  for (size_t pc = 0; pc + 1 < bytecode.code.size(); ++pc) {
+    const auto& first  = bytecode.code[pc];
+    const auto& second = bytecode.code[pc + 1];
+    if (first.num_args == 0 || second.num_args == 0) {
+      continue;
+    }
+
+    const auto args = std::span<const uint32_t>(bytecode.operands).subspan(second.args,
+                                                                           second.num_args);
+    if (std::find(std::cbegin(args), std::cend(args), first.dst) != std::cend(args)) {
+      ++counts[{first.op, second.op}];
+    }
+  }
+
+  std::vector<OpPairCount> pairs{};
+  pairs.reserve(counts.size());
+  for (const auto& [ops, count] : counts) {
+    pairs.push_back(OpPairCount{.first = ops.first, .second = ops.second, .count = count});
+  }
+  std::stable_sort(std::begin(pairs), std::end(pairs), [](const auto& lhs, const auto& rhs) {
+    return lhs.count > rhs.count;
+  });
+  return pairs;
+}
+
+// - Direct-threaded bytecode interpreter ----------------------------------------------------------
+// The bytecode is pre-decoded into handler addresses, every handler jumps directly to the handler
+// of the next instruction instead of returning to a central switch. This replicates the indirect
+// branch for every handler, such that the branch predictor can learn the op sequences of the tape.
+// Frequent pairs of dependent instructions are fused into superinstructions, saving one dispatch.
+// Operations without a dedicated handler use `detail::apply_operation`.
+template <typename PassiveType>
+class ThreadedInterpreter {
+  static_assert(!is_matrix_type_v<PassiveType>, "Threaded interpreter requires a scalar type.");
+
+  enum class Opcode : uint32_t {
+    LOAD_INPUT,
+    LOAD_CONSTANT,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    INV,
+    NEG,
+    SQRT,
+    SIN,
+    COS,
+    SELECT,
+    GUARD,
+    MUL_ADD,
+    INV_MUL,
+    GENERIC,
+    END,
+    OPCODE_COUNT,
+  };
+
+  // `a`, `b` and `c` are argument registers; `extra` is the destination of the second instruction
+  // of a superinstruction or the index of the bytecode instruction for guards and generic ops
+  struct DecodedInstruction {
+    const void* handler;
+    Opcode opcode;
+    uint32_t dst;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint32_t extra;
+  };
+
+  Bytecode<PassiveType> m_bytecode;
+  ThreadedInterpreterOptions m_options;
+  std::vector<DecodedInstruction> m_program{};
+  std::vector<PassiveType> m_registers{};
+  std::vector<int64_t> m_violated_guards{};
+  size_t m_num_superinstructions = 0;
+
+  [[nodiscard]] constexpr auto arg(const Instruction& ins, size_t i) const noexcept -> uint32_t {
+    return m_bytecode.operands[ins.args + i];
+  }
+
+  // Does `ins` read the result of `prev`
+  [[nodiscard]] constexpr auto reads(const Instruction& ins, const Instruction& prev) const noexcept
+      -> bool {
+    return arg(ins, 0) == prev.dst || arg(ins, 1) == prev.dst;
+  }
+
+  // Other argument of the binary `ins` that reads the result of `prev`
+  [[nodiscard]] constexpr auto other_arg(const Instruction& ins, const Instruction& prev) const
+      noexcept -> uint32_t {
+    return arg(ins, 0) == prev.dst ? arg(ins, 1) : arg(ins, 0);
+  }
+
+  void decode() {
+    const auto& code = m_bytecode.code;
+    for (size_t pc = 0; pc < code.size(); ++pc) {
+      const auto& ins = code[pc];
+      DecodedInstruction decoded{.handler = nullptr,
+                                 .opcode  = Opcode::GENERIC,
+                                 .dst     = ins.dst,
+                                 .a       = 0,
+                                 .b       = 0,
+                                 .c       = 0,
+                                 .extra   = static_cast<uint32_t>(pc)};
+
+      if (ins.num_args == 0) {
+        decoded.opcode = ins.op == NodeType::VAR ? Opcode::LOAD_INPUT : Opcode::LOAD_CONSTANT;
+        decoded.a      = ins.args;
+        m_program.push_back(decoded);
+        continue;
+      }
+
+      decoded.a = arg(ins, 0);
+      decoded.b = ins.num_args > 1 ? arg(ins, 1) : 0;
+      decoded.c = ins.num_args > 2 ? arg(ins, 2) : 0;
+
+      // Superinstructions
+      if (m_options.superinstructions && pc + 1 < code.size()) {
+        const auto& next = code[pc + 1];
+        const bool fuse_mul_add =
+            ins.op == NodeType::MUL && next.op == NodeType::ADD && next.num_args == 2;
+        const bool fuse_inv_mul =
+            ins.op == NodeType::INV && next.op == NodeType::MUL && next.num_args == 2;
+        if ((fuse_mul_add || fuse_inv_mul) && reads(next, ins)) {
+          decoded.opcode = fuse_mul_add ? Opcode::MUL_ADD : Opcode::INV_MUL;
+          decoded.c      = other_arg(next, ins);
+          decoded.extra  = next.dst;
+          m_program.push_back(decoded);
+          ++m_num_superinstructions;
+          ++pc;
+          continue;
+        }
+      }
+
+      switch (ins.op) {
+        case NodeType::ADD:
+          decoded.opcode = Opcode::ADD;
+          break;
+        case NodeType::SUB:
+          decoded.opcode = Opcode::SUB;
+          break;
+        case NodeType::MUL:
+          decoded.opcode = Opcode::MUL;
+          break;
+        case NodeType::DIV:
+          decoded.opcode = Opcode::DIV;
+          break;
+        case NodeType::INV:
+          decoded.opcode = Opcode::INV;
+          break;
+        case NodeType::NEG:
+          decoded.opcode = Opcode::NEG;
+          break;
+#ifndef RT_ONLY_FUNDAMENTAL
+        case NodeType::SQRT:
+          decoded.opcode = Opcode::SQRT;
+          break;
+        case NodeType::SIN:
+          decoded.opcode = Opcode::SIN;
+          break;
+        case NodeType::COS:
+          decoded.opcode = Opcode::COS;
+          break;
+#endif  // RT_ONLY_FUNDAMENTAL
+        case NodeType::SELECT:
+          decoded.opcode = Opcode::SELECT;
+          break;
+        case NodeType::GUARD:
+          decoded.opcode = Opcode::GUARD;
+          decoded.b      = static_cast<uint32_t>(ins.attribute);
+          break;
+        default:
+          break;
+      }
+      m_program.push_back(decoded);
+    }
+
+    m_program.push_back(DecodedInstruction{.handler = nullptr,
+                                           .opcode  = Opcode::END,
+                                           .dst     = 0,
+                                           .a       = 0,
+                                           .b       = 0,
+                                           .c       = 0,
+                                           .extra   = 0});
+
+#if RT_HAS_COMPUTED_GOTO
+    if (m_options.computed_goto) {
+      const auto* handlers = run<true>({}, true);
+      for (auto& decoded : m_program) {
+        decoded.handler = handlers[static_cast<size_t>(decoded.opcode)];
+      }
+    }
+#endif  // RT_HAS_COMPUTED_GOTO
+  }
+
+#if RT_HAS_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif  // RT_HAS_COMPUTED_GOTO
+  // Executes the program, with `THREADED` every handler jumps to the next handler, otherwise all
+  // handlers return to the switch. With `get_handlers` only the handler addresses are returned.
+  template <bool THREADED>
+  auto run(std::span<const PassiveType> inputs, bool get_handlers = false) -> const void* const* {
+#if RT_HAS_COMPUTED_GOTO
+    static const std::array<const void*, static_cast<size_t>(Opcode::OPCODE_COUNT)> handlers{
+        &&LOAD_INPUT,
+        &&LOAD_CONSTANT,
+        &&ADD,
+        &&SUB,
+        &&MUL,
+        &&DIV,
+        &&INV,
+        &&NEG,
+        &&SQRT,
+        &&SIN,
+        &&COS,
+        &&SELECT,
+        &&GUARD,
+        &&MUL_ADD,
+        &&INV_MUL,
+        &&GENERIC,
+        &&END,
+    };
+    if (get_handlers) {
+      return handlers.data();
+    }
+#define RT_DISPATCH()                                                                              \
+  if (THREADED) {                                                                                  \
+    goto*(++ip)->handler;                                                                          \
+  } else {                                                                                         \
+    ++ip;                                                                                          \
+    goto dispatch;                                                                                 \
+  }
+#else
+    RT_ASSERT(!get_handlers, "Computed goto is not supported.");
+#define RT_DISPATCH()                                                                              \
+  ++ip;                                                                                            \
+  goto dispatch
+#endif  // RT_HAS_COMPUTED_GOTO
+
+    auto* reg                    = m_registers.data();
+    const auto* constants        = m_bytecode.constants.data();
+    const DecodedInstruction* ip = m_program.data();
+
+    // The first instruction is always dispatched via the switch
+  dispatch:
+    switch (ip->opcode) {
+      case Opcode::LOAD_INPUT:
+        goto LOAD_INPUT;
+      case Opcode::LOAD_CONSTANT:
+        goto LOAD_CONSTANT;
+      case Opcode::ADD:
+        goto ADD;
+      case Opcode::SUB:
+        goto SUB;
+      case Opcode::MUL:
+        goto MUL;
+      case Opcode::DIV:
+        goto DIV;
+      case Opcode::INV:
+        goto INV;
+      case Opcode::NEG:
+        goto NEG;
+      case Opcode::SQRT:
+        goto SQRT;
+      case Opcode::SIN:
+        goto SIN;
+      case Opcode::COS:
+        goto COS;
+      case Opcode::SELECT:
+        goto SELECT;
+      case Opcode::GUARD:
+        goto GUARD;
+      case Opcode::MUL_ADD:
+        goto MUL_ADD;
+      case Opcode::INV_MUL:
+        goto INV_MUL;
+      case Opcode::GENERIC:
+        goto GENERIC;
+      default:
+        goto END;
+    }
+
+  LOAD_INPUT:
+    reg[ip->dst] = inputs[ip->a];
+    RT_DISPATCH();
+  LOAD_CONSTANT:
+    reg[ip->dst] = constants[ip->a];
+    RT_DISPATCH();
+  ADD:
+    reg[ip->dst] = static_cast<PassiveType>(reg[ip->a] + reg[ip->b]);
+    RT_DISPATCH();
+  SUB:
+    reg[ip->dst] = static_cast<PassiveType>(reg[ip->a] - reg[ip->b]);
+    RT_DISPATCH();
+  MUL:
+    reg[ip->dst] = static_cast<PassiveType>(reg[ip->a] * reg[ip->b]);
+    RT_DISPATCH();
+  DIV:
+    RT_ASSERT(reg[ip->b] != static_cast<PassiveType>(0), "Division by zero.");
+    reg[ip->dst] = static_cast<PassiveType>(reg[ip->a] / reg[ip->b]);
+    RT_DISPATCH();
+  INV:
+    reg[ip->dst] = static_cast<PassiveType>(static_cast<PassiveType>(1) / reg[ip->a]);
+    RT_DISPATCH();
+  NEG:
+    reg[ip->dst] = static_cast<PassiveType>(-reg[ip->a]);
+    RT_DISPATCH();
+  SQRT:
+#ifndef RT_ONLY_FUNDAMENTAL
+    reg[ip->dst] = static_cast<PassiveType>(std::sqrt(reg[ip->a]));
+#endif  // RT_ONLY_FUNDAMENTAL
+    RT_DISPATCH();
+  SIN:
+#ifndef RT_ONLY_FUNDAMENTAL
+    reg[ip->dst] = static_cast<PassiveType>(std::sin(reg[ip->a]));
+#endif  // RT_ONLY_FUNDAMENTAL
+    RT_DISPATCH();
+  COS:
+#ifndef RT_ONLY_FUNDAMENTAL
+    reg[ip->dst] = static_cast<PassiveType>(std::cos(reg[ip->a]));
+#endif  // RT_ONLY_FUNDAMENTAL
+    RT_DISPATCH();
+  SELECT:
+    reg[ip->dst] = reg[ip->a] != static_cast<PassiveType>(0) ? reg[ip->b] : reg[ip->c];
+    RT_DISPATCH();
+  GUARD:
+    reg[ip->dst] = reg[ip->a];
+    if (static_cast<uint32_t>(reg[ip->dst] != static_cast<PassiveType>(0)) != ip->b) {
+      m_violated_guards.push_back(m_bytecode.node_ids[ip->extra]);
+    }
+    RT_DISPATCH();
+  MUL_ADD:
+    reg[ip->dst]   = static_cast<PassiveType>(reg[ip->a] * reg[ip->b]);
+    reg[ip->extra] = static_cast<PassiveType>(reg[ip->dst] + reg[ip->c]);
+    RT_DISPATCH();
+  INV_MUL:
+    reg[ip->dst]   = static_cast<PassiveType>(static_cast<PassiveType>(1) / reg[ip->a]);
+    reg[ip->extra] = static_cast<PassiveType>(reg[ip->dst] * reg[ip->c]);
+    RT_DISPATCH();
+  GENERIC:
+    {
+      const auto& ins = m_bytecode.code[ip->extra];
+      const auto* arg = m_bytecode.operands.data() + ins.args;
+      reg[ins.dst]    = detail::apply_operation<PassiveType>(
+          ins.op, ins.attribute, ins.num_args, [&](size_t i) -> const PassiveType& {
+            return reg[arg[i]];
+          });
+    }
+    RT_DISPATCH();
+  END:
+    return nullptr;
+#undef RT_DISPATCH
+  }
+#if RT_HAS_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif  // RT_HAS_COMPUTED_GOTO
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  explicit ThreadedInterpreter(Bytecode<PassiveType> bytecode,
+                               ThreadedInterpreterOptions options = {})
+      : m_bytecode(std::move(bytecode)),
+        m_options(options),
+        m_registers(m_bytecode.num_registers) {
+    m_options.computed_goto = m_options.computed_goto && RT_HAS_COMPUTED_GOTO;
+    decode();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  ThreadedInterpreter(const Graph<PassiveType>& graph,
+                      std::span<const int64_t> outputs,
+                      ThreadedInterpreterOptions options = {})
+      : ThreadedInterpreter(compile(graph, outputs), options) {}
+
+  // -----------------------------------------------------------------------------------------------
+  void evaluate(std::span<const PassiveType> inputs) {
+    RT_ASSERT(inputs.size() == m_bytecode.num_inputs,
+              "Expected " << m_bytecode.num_inputs << " inputs, but got " << inputs.size());
+    m_violated_guards.clear();
+    if (m_options.computed_goto) {
+      run<true>(inputs);
+    } else {
+      run<false>(inputs);
+    }
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Value of the `idx`-th output passed to `compile`
+  [[nodiscard]] constexpr auto output(size_t idx) const noexcept -> const PassiveType& {
+    RT_ASSERT(idx < m_bytecode.output_registers.size(),
+              "Output " << idx << " does not exist, there are "
+                        << m_bytecode.output_registers.size() << " outputs.");
+    return m_registers[m_bytecode.output_registers[idx]];
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto guards_hold() const noexcept -> bool {
+    return m_violated_guards.empty();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto violated_guards() const noexcept -> const std::vector<int64_t>& {
+    return m_violated_guards;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_superinstructions() const noexcept -> size_t {
+    return m_num_superinstructions;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto uses_computed_goto() const noexcept -> bool {
+    return m_options.computed_goto;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto bytecode() const noexcept -> const Bytecode<PassiveType>& {
+    return m_bytecode;
+  }
+};
+
+}  // namespace RT
+
+#endif  // RT_THREADED_INTERPRETER_HPP_
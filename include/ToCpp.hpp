@@ -0,0 +1,555 @@
+#ifndef RT_TO_CPP_HPP_
+#define RT_TO_CPP_HPP_
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AdjointCode.hpp"
+#include "CustomOp.hpp"
+#include "Graph.hpp"
+#include "Macros.hpp"
+#include "NodeType.hpp"
+#include "Tape.hpp"
+#include "TypeTraits.hpp"
+
+// Loading the generated code at runtime requires `dlopen`
+#if __has_include(<dlfcn.h>) && __has_include(<unistd.h>)
+#include <dlfcn.h>
+#include <unistd.h>
+#define RT_HAS_DLOPEN 1
+#else
+#define RT_HAS_DLOPEN 0
+#endif
+
+namespace RT {
+
+namespace detail {
+
+// - Name of a fundamental type in generated code --------------------------------------------------
+template <typename PassiveType>
+[[nodiscard]] auto cpp_type_name() -> std::string {
+  using namespace std::string_literals;
+  if constexpr (std::is_same_v<PassiveType, float>) {
+    return "float"s;
+  } else if constexpr (std::is_same_v<PassiveType, double>) {
+    return "double"s;
+  } else if constexpr (std::is_same_v<PassiveType, long double>) {
+    return "long double"s;
+  } else {
+    static_assert(std::is_integral_v<PassiveType>, "Expected a floating point or integral type.");
+    return (std::is_signed_v<PassiveType> ? "std::int"s : "std::uint"s) +
+           std::to_string(8 * sizeof(PassiveType)) + "_t"s;
+  }
+}
+
+// - Exact literal of a constant in generated code -------------------------------------------------
+// Floating point constants are written in hexadecimal, such that they are not rounded.
+template <typename PassiveType>
+[[nodiscard]] auto cpp_literal(PassiveType value) -> std::string {
+  using namespace std::string_literals;
+  std::ostringstream out;
+  if constexpr (std::is_floating_point_v<PassiveType>) {
+    if (std::isnan(value)) {
+      return "std::numeric_limits<T>::quiet_NaN()"s;
+    }
+    if (std::isinf(value)) {
+      return (value < 0 ? "-"s : ""s) + "std::numeric_limits<T>::infinity()"s;
+    }
+    out << std::hexfloat << value;
+    if constexpr (std::is_same_v<PassiveType, float>) {
+      out << 'f';
+    } else if constexpr (std::is_same_v<PassiveType, long double>) {
+      out << 'L';
+    }
+  } else {
+    if (std::is_signed_v<PassiveType> && value == std::numeric_limits<PassiveType>::min()) {
+      return "std::numeric_limits<T>::min()"s;
+    }
+    out << "static_cast<T>(" << +value << (std::is_signed_v<PassiveType> ? "ll)" : "ull)");
+  }
+  return out.str();
+}
+
+}  // namespace detail
+
+// - Generate C++ code for a recorded graph --------------------------------------------------------
+// Writes a self-contained translation unit that defines
+//
+//   extern "C" std::int64_t <function_name>(const T* inputs, T* outputs, std::int64_t num_lanes);
+//
+// which replays the graph for `num_lanes` independent sets of inputs and returns the number of
+// violated guards, summed over all lanes. Input `i` of lane `l` is read from
+// `inputs[i * num_lanes + l]` and output `o` is written to `outputs[o * num_lanes + l]`, the same
+// layout as `BatchEvaluator`, so the loop over the lanes is straight-line code that the compiler
+// can vectorize. Only nodes that contribute to `outputs` or to a guard are emitted and copies are
+// replaced by the node they copy. If `outputs` is empty, all nodes that are neither read by another
+// node nor a guard are outputs, like in `to_python`. Custom operations are declared and must be
+// implemented by the user.
+//
+// With `adjoint`, the translation unit also defines the reverse mode derivative
+//
+//   extern "C" std::int64_t <function_name>_adjoint(const T* inputs, const T* output_adjoints,
+//                                                    T* outputs, T* input_adjoints,
+//                                                    std::int64_t num_lanes);
+//
+// which evaluates the outputs and the input adjoints
+// `sum_o output_adjoints[o] * d output_o / d input` with the same layout, i.e. `gradient` as
+// straight-line code. Custom operations additionally
+// require `T <name>_derivative(std::size_t arg_idx, T args...)`.
+template <typename PassiveType>
+void to_cpp(const Graph<PassiveType>* graph,
+            const std::string& filename,
+            std::span<const int64_t> outputs  = {},
+            const std::string& function_name = "f",
+            bool adjoint                     = false) {
+  static_assert(std::is_arithmetic_v<PassiveType> && !std::is_same_v<PassiveType, bool>,
+                "Code generation is only implemented for fundamental arithmetic types.");
+
+  // - Setup -------------------------------------------------------------------
+  using namespace std::string_literals;
+  constexpr auto single_indent = "  ";
+  constexpr auto double_indent = "    ";
+
+  const Tape<PassiveType> tape(*graph);
+  const auto num_nodes = tape.num_nodes();
+
+  // Copies are represented by the node they copy
+  std::vector<size_t> representative(num_nodes);
+  const auto rep = [&](int64_t id) { return representative[static_cast<size_t>(id)]; };
+  for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+    const auto op   = tape.op(id);
+    const auto args = tape.args(id);
+    representative[static_cast<size_t>(id)] =
+        (op == NodeType::VAR || op == NodeType::LITERAL) && args.size() == 1
+            ? rep(args[0])
+            : static_cast<size_t>(id);
+  }
+  const auto make_var = [&](int64_t id) { return "v"s + std::to_string(rep(id)); };
+
+  std::vector<int64_t> output_ids(std::begin(outputs), std::end(outputs));
+  if (output_ids.empty()) {
+    std::vector<bool> used(num_nodes, false);
+    for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+      for (auto arg : tape.args(id)) {
+        used[static_cast<size_t>(arg)] = true;
+      }
+    }
+    for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+      if (!used[static_cast<size_t>(id)] && !tape.args(id).empty() &&
+          tape.op(id) != NodeType::GUARD) {
+        output_ids.push_back(id);
+      }
+    }
+  }
+
+  // Nodes contributing to the outputs or to a guard
+  std::vector<bool> live(num_nodes, false);
+  for (auto out : output_ids) {
+    RT_ASSERT(out >= 0 && static_cast<size_t>(out) < num_nodes,
+              "Node with id " << out << " is not part of the graph.");
+    live[static_cast<size_t>(out)] = true;
+  }
+  for (auto id = static_cast<int64_t>(num_nodes) - 1; id >= 0; --id) {
+    const auto idx = static_cast<size_t>(id);
+    live[idx]      = live[idx] || tape.op(id) == NodeType::GUARD;
+    if (live[idx]) {
+      for (auto arg : tape.args(id)) {
+        live[static_cast<size_t>(arg)] = true;
+      }
+    }
+  }
+
+  std::vector<int64_t> input_index(num_nodes, -1);
+  for (size_t i = 0; i < tape.inputs().size(); ++i) {
+    input_index[static_cast<size_t>(tape.inputs()[i])] = static_cast<int64_t>(i);
+  }
+  // - Setup -------------------------------------------------------------------
+
+  // - Generate statements -----------------------------------------------------
+  std::vector<std::string> statements{};
+  std::set<int64_t> used_custom_ops{};
+  for (int64_t id = 0; id < static_cast<int64_t>(num_nodes); ++id) {
+    const auto idx = static_cast<size_t>(id);
+    if (!live[idx] || representative[idx] != idx) {
+      continue;
+    }
+
+    const auto op   = tape.op(id);
+    const auto args = tape.args(id);
+    const auto arg  = [&](size_t i) { return make_var(args[i]); };
+    std::string expr{};
+    if (args.empty()) {
+      expr = input_index[idx] >= 0 ? "inputs["s + std::to_string(input_index[idx]) +
+                                         " * num_lanes + l]"s
+                                   : detail::cpp_literal(tape.values()[idx]);
+    } else {
+      switch (op) {
+        case NodeType::ADD:
+          expr = "static_cast<T>("s + arg(0) + " + "s + arg(1) + ")"s;
+          break;
+        case NodeType::NEG:
+          expr = "static_cast<T>(-"s + arg(0) + ")"s;
+          break;
+        case NodeType::MUL:
+          expr = "static_cast<T>("s + arg(0) + " * "s + arg(1) + ")"s;
+          break;
+        case NodeType::INV:
+          expr = "static_cast<T>(static_cast<T>(1) / "s + arg(0) + ")"s;
+          break;
+        case NodeType::SUB:
+          expr = "static_cast<T>("s + arg(0) + " - "s + arg(1) + ")"s;
+          break;
+        case NodeType::DIV:
+          expr = "static_cast<T>("s + arg(0) + " / "s + arg(1) + ")"s;
+          break;
+        case NodeType::MOD:
+          RT_ASSERT(std::is_integral_v<PassiveType>, "Operation MOD requires an integral type.");
+          expr = "static_cast<T>("s + arg(0) + " % "s + arg(1) + ")"s;
+          break;
+        case NodeType::SQRT:
+        case NodeType::SIN:
+        case NodeType::COS:
+          expr = "static_cast<T>(std::"s +
+                 (op == NodeType::SQRT ? "sqrt("s : op == NodeType::SIN ? "sin("s : "cos("s) +
+                 arg(0) + "))"s;
+          break;
+        case NodeType::CMP:
+          expr = "static_cast<T>("s + arg(0) + " "s +
+                 to_string(static_cast<ComparisonType>(tape.attribute(id))) + " "s + arg(1) +
+                 ")"s;
+          break;
+        case NodeType::SELECT:
+          expr = arg(0) + " != static_cast<T>(0) ? "s + arg(1) + " : "s + arg(2);
+          break;
+        case NodeType::GUARD:
+          expr = arg(0) + ";\n"s + double_indent +
+                 "violated_guards += static_cast<std::int64_t>("s + make_var(id) +
+                 (tape.attribute(id) != 0 ? " == "s : " != "s) + "static_cast<T>(0));"s;
+          break;
+        case NodeType::SUM:
+          expr = arg(0);
+          for (size_t i = 1; i < args.size(); ++i) {
+            expr = "static_cast<T>("s + expr + " + "s + arg(i) + ")"s;
+          }
+          break;
+        case NodeType::DOT:
+          {
+            RT_ASSERT(args.size() % 2 == 0, "Expected even number of dependencies for DOT.");
+            const size_t n = args.size() / 2;
+            expr           = "static_cast<T>("s + arg(0) + " * "s + arg(n) + ")"s;
+            for (size_t i = 1; i < n; ++i) {
+              expr = "static_cast<T>("s + expr + " + "s + arg(i) + " * "s + arg(n + i) + ")"s;
+            }
+          }
+          break;
+        case NodeType::CUSTOM:
+          {
+            const auto op_id = tape.attribute(id);
+            used_custom_ops.insert(op_id);
+            expr = CustomOpRegistry<PassiveType>::get(op_id).name + "("s;
+            for (size_t i = 0; i < args.size(); ++i) {
+              expr += (i > 0 ? ", "s : ""s) + arg(i);
+            }
+            expr += ")"s;
+          }
+          break;
+        default:
+          RT_TODO("Operation `" << op << "` not implemented yet.");
+      }
+    }
+
+    // Guards append the check to the expression
+    const auto semicolon = op == NodeType::GUARD ? ""s : ";"s;
+    statements.push_back("const T "s + make_var(id) + " = "s + expr + semicolon);
+  }
+
+  // Reverse sweep, seeded with the output adjoints
+  detail::AdjointCode adjoint_code{};
+  if (adjoint) {
+    if constexpr (std::is_floating_point_v<PassiveType>) {
+      std::vector<std::pair<int64_t, std::string>> seeds{};
+      for (size_t i = 0; i < output_ids.size(); ++i) {
+        seeds.emplace_back(output_ids[i],
+                           "output_adjoints["s + std::to_string(i) + " * num_lanes + l]"s);
+      }
+      adjoint_code = detail::adjoint_code<PassiveType>(
+          tape, live, representative, seeds, detail::CodeLanguage::CPP);
+    } else {
+      RT_PANIC("Derivatives require a floating point type as `PassiveType`.");
+    }
+  }
+  // - Generate statements -----------------------------------------------------
+
+  // - Write code --------------------------------------------------------------
+  std::ofstream out(filename);
+  if (!out) {
+    throw std::runtime_error(RT_ERROR_LOC() + ": Could not open file `"s + filename + "`: "s +
+                             std::strerror(errno));
+  }
+
+  out << "// Generated by RecordType: " << tape.inputs().size() << " inputs, " << output_ids.size()
+      << " outputs, " << statements.size() << " statements\n";
+  out << "#include <cmath>\n";
+  out << "#include <cstddef>\n";
+  out << "#include <cstdint>\n";
+  out << "#include <limits>\n\n";
+  out << "using T = " << detail::cpp_type_name<PassiveType>() << ";\n\n";
+
+  // User defined operations have to be implemented by the user
+  for (int64_t op_id : used_custom_ops) {
+    const auto& custom_op = CustomOpRegistry<PassiveType>::get(op_id);
+    out << "// Custom operation, must be implemented by the user\n";
+    out << "T " << custom_op.name << '(';
+    for (size_t i = 0; i < custom_op.arity; ++i) {
+      out << (i > 0 ? ", " : "") << 'T';
+    }
+    out << ");\n\n";
+  }
+  for (int64_t op_id : adjoint_code.used_custom_ops) {
+    const auto& custom_op = CustomOpRegistry<PassiveType>::get(op_id);
+    out << "// Partial derivative of a custom operation, must be implemented by the user\n";
+    out << "T " << custom_op.name << "_derivative(std::size_t arg_idx";
+    for (size_t i = 0; i < custom_op.arity; ++i) {
+      out << ", T";
+    }
+    out << ");\n\n";
+  }
+
+  const auto write_primal = [&] {
+    out << single_indent << "std::int64_t violated_guards = 0;\n";
+    out << single_indent << "for (std::int64_t l = 0; l < num_lanes; ++l) {\n";
+    for (const auto& statement : statements) {
+      out << double_indent << statement << '\n';
+    }
+    for (size_t i = 0; i < output_ids.size(); ++i) {
+      out << double_indent << "outputs[" << i << " * num_lanes + l] = " << make_var(output_ids[i])
+          << ";\n";
+    }
+  };
+
+  out << "extern \"C\" std::int64_t " << function_name
+      << "(const T* __restrict inputs, T* __restrict outputs, std::int64_t num_lanes) {\n";
+  write_primal();
+  out << single_indent << "}\n";
+  out << single_indent << "return violated_guards;\n";
+  out << "}\n";
+
+  if (adjoint) {
+    out << "\nextern \"C\" std::int64_t " << function_name
+        << "_adjoint(const T* __restrict inputs, const T* __restrict output_adjoints, "
+           "T* __restrict outputs, T* __restrict input_adjoints, std::int64_t num_lanes) {\n";
+    write_primal();
+    for (const auto& statement : adjoint_code.statements) {
+      out << double_indent << statement << '\n';
+    }
+    for (size_t i = 0; i < tape.inputs().size(); ++i) {
+      const auto idx = static_cast<size_t>(tape.inputs()[i]);
+      out << double_indent << "input_adjoints[" << i << " * num_lanes + l] = "
+          << (adjoint_code.has_adjoint[idx] ? "a"s + std::to_string(idx) : "static_cast<T>(0)"s)
+          << ";\n";
+    }
+    out << single_indent << "}\n";
+    out << single_indent << "return violated_guards;\n";
+    out << "}\n";
+  }
+  // - Write code --------------------------------------------------------------
+}
+
+#if RT_HAS_DLOPEN
+
+namespace detail {
+
+// -------------------------------------------------------------------------------------------------
+[[nodiscard]] inline auto default_compiler() -> std::string {
+  const char* cxx = std::getenv("CXX");
+  return cxx != nullptr && *cxx != '\0' ? std::string(cxx) : std::string("c++");
+}
+
+}  // namespace detail
+
+struct CompileOptions {
+  std::string compiler            = detail::default_compiler();  // `$CXX` or `c++`
+  std::string flags               = "-O3 -march=native";
+  std::filesystem::path directory = std::filesystem::temp_directory_path();
+  bool keep_files                 = false;  // Keep the generated source and shared library
+  bool adjoint                    = false;  // Also compile the reverse mode derivative
+};
+
+// - Natively compiled replay of a recorded graph --------------------------------------------------
+// Generates the code with `to_cpp`, compiles it into a shared library with the system compiler
+// and loads it with `dlopen`. Floating point contraction is disabled, such that the compiled code
+// reproduces the values of the interpreters. Throws `std::runtime_error` if compiling or loading
+// fails, e.g. if a custom operation is not implemented.
+template <typename PassiveType>
+class CompiledFunction {
+  using Function = std::int64_t (*)(const PassiveType*, PassiveType*, std::int64_t);
+  using AdjointFunction = std::int64_t (*)(
+      const PassiveType*, const PassiveType*, PassiveType*, PassiveType*, std::int64_t);
+
+  void* m_handle                     = nullptr;
+  Function m_function                = nullptr;
+  AdjointFunction m_adjoint_function = nullptr;
+  size_t m_num_inputs                = 0;
+  size_t m_num_outputs               = 0;
+  std::string m_source{};
+
+ public:
+  // -----------------------------------------------------------------------------------------------
+  CompiledFunction(const Graph<PassiveType>& graph,
+                   std::span<const int64_t> outputs,
+                   const CompileOptions& options = {})
+      : m_num_inputs(graph.inputs().size()),
+        m_num_outputs(outputs.size()) {
+    using namespace std::string_literals;
+    RT_ASSERT(!outputs.empty(), "Compiled functions require at least one output.");
+
+    static std::atomic<uint64_t> counter{0};
+    const auto stem =
+        "rt_kernel_"s + std::to_string(::getpid()) + "_"s + std::to_string(counter++);
+    const auto source  = options.directory / (stem + ".cpp");
+    const auto library = options.directory / (stem + ".so");
+    const auto log     = options.directory / (stem + ".log");
+
+    to_cpp(&graph, source.string(), outputs, "rt_kernel", options.adjoint);
+    const auto command = options.compiler + " "s + options.flags +
+                         " -std=c++17 -shared -fPIC -ffp-contract=off -o '"s + library.string() +
+                         "' '"s + source.string() + "' > '"s + log.string() + "' 2>&1"s;
+    const int status = std::system(command.c_str());
+
+    const auto remove_files = [&] {
+      std::error_code ec;
+      std::filesystem::remove(log, ec);
+      if (!options.keep_files) {
+        std::filesystem::remove(source, ec);
+        std::filesystem::remove(library, ec);
+      }
+    };
+
+    if (status != 0) {
+      std::ifstream log_file(log);
+      const std::string message{std::istreambuf_iterator<char>(log_file),
+                                std::istreambuf_iterator<char>()};
+      remove_files();
+      throw std::runtime_error(RT_ERROR_LOC() + ": Compiling the generated code failed:\n"s +
+                               command + "\n"s + message);
+    }
+
+    m_handle = ::dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (m_handle == nullptr) {
+      const std::string message = ::dlerror();
+      remove_files();
+      throw std::runtime_error(RT_ERROR_LOC() + ": Could not load `"s + library.string() +
+                               "`: "s + message);
+    }
+    m_function = reinterpret_cast<Function>(::dlsym(m_handle, "rt_kernel"));
+    if (options.adjoint) {
+      m_adjoint_function =
+          reinterpret_cast<AdjointFunction>(::dlsym(m_handle, "rt_kernel_adjoint"));
+      RT_ASSERT(m_adjoint_function != nullptr,
+                "Generated library does not define `rt_kernel_adjoint`.");
+    }
+    if (options.keep_files) {
+      m_source = source.string();
+    }
+    remove_files();
+    RT_ASSERT(m_function != nullptr, "Generated library does not define `rt_kernel`.");
+  }
+
+  CompiledFunction(const CompiledFunction&)                    = delete;
+  auto operator=(const CompiledFunction&) -> CompiledFunction& = delete;
+
+  // -----------------------------------------------------------------------------------------------
+  CompiledFunction(CompiledFunction&& other) noexcept
+      : m_handle(std::exchange(other.m_handle, nullptr)),
+        m_function(std::exchange(other.m_function, nullptr)),
+        m_adjoint_function(std::exchange(other.m_adjoint_function, nullptr)),
+        m_num_inputs(other.m_num_inputs),
+        m_num_outputs(other.m_num_outputs),
+        m_source(std::move(other.m_source)) {}
+
+  // -----------------------------------------------------------------------------------------------
+  auto operator=(CompiledFunction&& other) noexcept -> CompiledFunction& {
+    std::swap(m_handle, other.m_handle);
+    std::swap(m_function, other.m_function);
+    std::swap(m_adjoint_function, other.m_adjoint_function);
+    std::swap(m_num_inputs, other.m_num_inputs);
+    std::swap(m_num_outputs, other.m_num_outputs);
+    std::swap(m_source, other.m_source);
+    return *this;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  ~CompiledFunction() noexcept {
+    if (m_handle != nullptr) {
+      ::dlclose(m_handle);
+    }
+  }
+
+  // - Replay for `num_lanes` sets of inputs, returns the number of violated guards ----------------
+  // Uses the layout of `BatchEvaluator`: input `i` of lane `l` is `inputs[i * num_lanes + l]`
+  auto evaluate(std::span<const PassiveType> inputs,
+                std::span<PassiveType> outputs,
+                size_t num_lanes = 1) const -> int64_t {
+    RT_ASSERT(inputs.size() == m_num_inputs * num_lanes,
+              "Expected " << m_num_inputs * num_lanes << " inputs, but got " << inputs.size());
+    RT_ASSERT(outputs.size() == m_num_outputs * num_lanes,
+              "Expected " << m_num_outputs * num_lanes << " outputs, but got " << outputs.size());
+    return m_function(inputs.data(), outputs.data(), static_cast<std::int64_t>(num_lanes));
+  }
+
+  // - Replay and reverse mode derivative, requires `CompileOptions::adjoint` ----------------------
+  // `input_adjoints = sum_o output_adjoints[o] * d output_o / d input` for every lane, same layout
+  auto evaluate_adjoint(std::span<const PassiveType> inputs,
+                        std::span<const PassiveType> output_adjoints,
+                        std::span<PassiveType> outputs,
+                        std::span<PassiveType> input_adjoints,
+                        size_t num_lanes = 1) const -> int64_t {
+    RT_ASSERT(m_adjoint_function != nullptr,
+              "The adjoint was not compiled, set `CompileOptions::adjoint`.");
+    RT_ASSERT(inputs.size() == m_num_inputs * num_lanes &&
+                  input_adjoints.size() == m_num_inputs * num_lanes,
+              "Expected " << m_num_inputs * num_lanes << " inputs and input adjoints, but got "
+                          << inputs.size() << " and " << input_adjoints.size());
+    RT_ASSERT(outputs.size() == m_num_outputs * num_lanes &&
+                  output_adjoints.size() == m_num_outputs * num_lanes,
+              "Expected " << m_num_outputs * num_lanes << " outputs and output adjoints, but got "
+                          << outputs.size() << " and " << output_adjoints.size());
+    return m_adjoint_function(inputs.data(),
+                              output_adjoints.data(),
+                              outputs.data(),
+                              input_adjoints.data(),
+                              static_cast<std::int64_t>(num_lanes));
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_inputs() const noexcept -> size_t { return m_num_inputs; }
+
+  // -----------------------------------------------------------------------------------------------
+  [[nodiscard]] constexpr auto num_outputs() const noexcept -> size_t { return m_num_outputs; }
+
+  // - Path of the generated source, only set if the files are kept --------------------------------
+  [[nodiscard]] constexpr auto source() const noexcept -> const std::string& { return m_source; }
+};
+
+#endif  // RT_HAS_DLOPEN
+
+}  // namespace RT
+
+#endif  // RT_TO_CPP_HPP_
@@ -2,21 +2,32 @@
 #define RT_TO_PYTHON_HPP_
 
 #include <fstream>
+#include <numeric>
+#include <set>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "AdjointCode.hpp"
 #include "Graph.hpp"
 #include "IteratorReverser.hpp"
 #include "Macros.hpp"
+#include "Tape.hpp"
 
 namespace RT {
 
 // TODO: 1) Handle output variable properly, a variable might be an output variable but still be
 //          used in a calculation
 //       2) Test `to_python`
+//
+// With `adjoint`, also writes `f_adjoint`, which takes the arguments of `f` followed by one seed
+// per output of `f` and returns the adjoints of all arguments of `f`, i.e. the reverse mode
+// derivative as straight-line code. Custom operations additionally require
+// `<name>_derivative(arg_idx, *args)`.
 template <typename PassiveType>
-void to_python(const Graph<PassiveType>* graph, const std::string& filename) {
+void to_python(const Graph<PassiveType>* graph, const std::string& filename, bool adjoint = false) {
   // - Setup -------------------------------------------------------------------
   using namespace std::string_literals;
   constexpr auto single_indent = "    ";
@@ -34,6 +45,8 @@ void to_python(const Graph<PassiveType>* graph, const std::string& filename) {
   std::vector<std::string> expressions{};
   std::vector<int64_t> possible_output_variables{};
   std::unordered_set<int64_t> used_variables{};
+  std::set<int64_t> used_custom_ops{};
+  bool uses_integer_division = false;
 
   auto op_it   = std::crbegin(ops);
   auto vals_it = std::crbegin(vals);
@@ -60,19 +73,26 @@ void to_python(const Graph<PassiveType>* graph, const std::string& filename) {
       RT_ASSERT(vals_it != std::crend(vals),
                 "`vals_it` should not have reached the end of the array");
       input_values.push_back(*vals_it++);
+      // Inputs and constants have an operation as well, e.g. constants recorded between operations
+      ++op_it;
       continue;
     }
 
     RT_ASSERT(vals_it != std::crend(vals),
               "`vals_it` should not have reached the end of the array");
-    ++vals_it;
-    possible_output_variables.push_back(to_id);
+    const auto& value = *vals_it++;
 
-    std::string expr = make_var(to_id) + " = "s;
+    const auto assign_prefix = make_var(to_id) + " = "s;
+    std::string expr         = assign_prefix;
 
     RT_ASSERT(op_it != std::crend(ops), "`op_it` should not have reached the end of the array");
     const auto op = *op_it++;
 
+    // Guards only check the control flow, they are never an output
+    if (op != NodeType::GUARD) {
+      possible_output_variables.push_back(to_id);
+    }
+
     switch (op) {
       case NodeType::VAR:
         {
@@ -150,14 +170,208 @@ void to_python(const Graph<PassiveType>* graph, const std::string& filename) {
         }
         break;
 
+      case NodeType::CMP:
+        {
+          RT_ASSERT(num_deps == -2, "Expected two dependencies, but got " << -num_deps);
+          // Dependencies are read in reverse order
+          const auto rhs = *(dep_it++);
+          used_variables.insert(rhs);
+          const auto lhs = *(dep_it++);
+          used_variables.insert(lhs);
+          const auto cmp = static_cast<ComparisonType>(graph->attribute(to_id));
+          expr += "float("s + make_var(lhs) + " "s + to_string(cmp) + " "s + make_var(rhs) + ")"s;
+        }
+        break;
+
+      case NodeType::SELECT:
+        {
+          RT_ASSERT(num_deps == -3, "Expected three dependencies, but got " << -num_deps);
+          // Dependencies are read in reverse order
+          const auto if_false = *(dep_it++);
+          used_variables.insert(if_false);
+          const auto if_true = *(dep_it++);
+          used_variables.insert(if_true);
+          const auto cond = *(dep_it++);
+          used_variables.insert(cond);
+          expr +=
+              make_var(if_true) + " if "s + make_var(cond) + " != 0 else "s + make_var(if_false);
+        }
+        break;
+
+      case NodeType::GUARD:
+        {
+          RT_ASSERT(num_deps == -1, "Expected one dependency, but got " << -num_deps);
+          const auto dep = *(dep_it++);
+          used_variables.insert(dep);
+          expr += make_var(dep) + "; assert "s + make_var(to_id) +
+                  (value != static_cast<PassiveType>(0) ? " != 0"s : " == 0"s) +
+                  ", \"Guard `"s + make_var(to_id) + "` does not hold.\""s;
+        }
+        break;
+
+      case NodeType::GEMM:
+        {
+          RT_ASSERT(num_deps == -2, "Expected two dependencies, but got " << -num_deps);
+          // Dependencies are read in reverse order
+          const auto rhs = *(dep_it++);
+          used_variables.insert(rhs);
+          const auto lhs = *(dep_it++);
+          used_variables.insert(lhs);
+          expr += make_var(lhs) + " @ "s + make_var(rhs);
+        }
+        break;
+
+      case NodeType::TRANSPOSE:
+        {
+          RT_ASSERT(num_deps == -1, "Expected one dependency, but got " << -num_deps);
+          const auto dep = *(dep_it++);
+          used_variables.insert(dep);
+          expr += make_var(dep) + ".T"s;
+        }
+        break;
+
+      case NodeType::SOLVE:
+        {
+          RT_ASSERT(num_deps == -2, "Expected two dependencies, but got " << -num_deps);
+          // Dependencies are read in reverse order
+          const auto rhs = *(dep_it++);
+          used_variables.insert(rhs);
+          const auto mat = *(dep_it++);
+          used_variables.insert(mat);
+          expr += "np.linalg.solve("s + make_var(mat) + ", "s + make_var(rhs) + ")"s;
+        }
+        break;
+
+      case NodeType::CWISE_MUL:
+        {
+          RT_ASSERT(num_deps == -2, "Expected two dependencies, but got " << -num_deps);
+          const auto dep1 = *(dep_it++);
+          used_variables.insert(dep1);
+          const auto dep2 = *(dep_it++);
+          used_variables.insert(dep2);
+          expr += make_var(dep1) + " * " + make_var(dep2);
+        }
+        break;
+
+      case NodeType::SUB:
+        {
+          RT_ASSERT(num_deps == -2, "Expected two dependencies, but got " << -num_deps);
+          // Dependencies are read in reverse order
+          const auto rhs = *(dep_it++);
+          used_variables.insert(rhs);
+          const auto lhs = *(dep_it++);
+          used_variables.insert(lhs);
+          expr += make_var(lhs) + " - "s + make_var(rhs);
+        }
+        break;
+
+      case NodeType::DIV:
+      case NodeType::MOD:
+        {
+          RT_ASSERT(num_deps == -2, "Expected two dependencies, but got " << -num_deps);
+          // Dependencies are read in reverse order
+          const auto rhs = *(dep_it++);
+          used_variables.insert(rhs);
+          const auto lhs = *(dep_it++);
+          used_variables.insert(lhs);
+          uses_integer_division = true;
+          expr += (op == NodeType::DIV ? "trunc_div("s : "trunc_mod("s) + make_var(lhs) + ", "s +
+                  make_var(rhs) + ")"s;
+        }
+        break;
+
+      case NodeType::SUM:
+      case NodeType::DOT:
+        {
+          // Dependencies are read in reverse order
+          std::vector<int64_t> args(static_cast<size_t>(-num_deps));
+          for (auto& arg : IteratorReverser(args)) {
+            arg = *(dep_it++);
+            used_variables.insert(arg);
+          }
+
+          expr += "("s;
+          if (op == NodeType::SUM) {
+            for (size_t i = 0; i < args.size(); ++i) {
+              expr += (i > 0 ? " + "s : ""s) + make_var(args[i]);
+            }
+          } else {
+            RT_ASSERT(args.size() % 2 == 0, "Expected even number of dependencies for DOT.");
+            const size_t n = args.size() / 2;
+            for (size_t i = 0; i < n; ++i) {
+              expr += (i > 0 ? " + "s : ""s) + make_var(args[i]) + " * "s + make_var(args[n + i]);
+            }
+          }
+          expr += ")"s;
+        }
+        break;
+
+      case NodeType::CUSTOM:
+        {
+          const auto op_id = graph->attribute(to_id);
+          used_custom_ops.insert(op_id);
+
+          // Dependencies are read in reverse order
+          std::vector<int64_t> args(static_cast<size_t>(-num_deps));
+          for (auto& arg : IteratorReverser(args)) {
+            arg = *(dep_it++);
+            used_variables.insert(arg);
+          }
+
+          expr += CustomOpRegistry<PassiveType>::get(op_id).name + "("s;
+          for (int64_t arg : args) {
+            expr += make_var(arg) + ", "s;
+          }
+          expr += ")"s;
+        }
+        break;
+
       default:
         RT_TODO("Operation `" << op << "` not implemented yet.");
     }
 
+    // Python integers are unbounded, unsigned arithmetic in C++ wraps around modulo 2^N
+    if constexpr (std::is_unsigned_v<PassiveType>) {
+      if (op == NodeType::NEG || op == NodeType::ADD || op == NodeType::SUB ||
+          op == NodeType::MUL || op == NodeType::SUM || op == NodeType::DOT) {
+        expr = assign_prefix + "("s + expr.substr(assign_prefix.size()) + ") % 2**"s +
+               std::to_string(8 * sizeof(PassiveType));
+      }
+    }
+
     expressions.push_back(std::move(expr));
   }
+
+  std::vector<int64_t> output_variables{};
+  for (int64_t id : IteratorReverser(possible_output_variables)) {
+    if (!used_variables.contains(id)) {
+      output_variables.push_back(id);
+    }
+  }
   // - Generate expressions ----------------------------------------------------
 
+  // - Generate adjoint --------------------------------------------------------
+  detail::AdjointCode adjoint_code{};
+  if (adjoint) {
+    if constexpr (std::is_floating_point_v<PassiveType>) {
+      // Variables are not coalesced, every node is its own representative
+      const Tape<PassiveType> tape(*graph);
+      std::vector<size_t> representative(tape.num_nodes());
+      std::iota(std::begin(representative), std::end(representative), size_t{0});
+      const std::vector<bool> live(tape.num_nodes(), true);
+
+      std::vector<std::pair<int64_t, std::string>> seeds{};
+      for (int64_t id : output_variables) {
+        seeds.emplace_back(id, "s"s + std::to_string(id));
+      }
+      adjoint_code = detail::adjoint_code<PassiveType>(
+          tape, live, representative, seeds, detail::CodeLanguage::PYTHON);
+    } else {
+      RT_PANIC("Derivatives require a floating point type as `PassiveType`.");
+    }
+  }
+  // - Generate adjoint --------------------------------------------------------
+
   // - Write code --------------------------------------------------------------
   std::ofstream out(filename);
   if (!out) {
@@ -165,7 +379,29 @@ void to_python(const Graph<PassiveType>* graph, const std::string& filename) {
                              std::strerror(errno));
   }
 
-  out << "import math\n\n\n";
+  out << "import math\n";
+  if constexpr (is_matrix_type_v<PassiveType>) {
+    out << "import numpy as np\n";
+  }
+  out << "\n\n";
+
+  // Python rounds integer division towards negative infinity, C++ truncates towards zero
+  if (uses_integer_division) {
+    out << "def trunc_div(a, b):\n";
+    out << single_indent << "q = abs(a) // abs(b)\n";
+    out << single_indent << "return q if (a < 0) == (b < 0) else -q\n\n\n";
+    out << "def trunc_mod(a, b):\n";
+    out << single_indent << "return a - b * trunc_div(a, b)\n\n\n";
+  }
+
+  // User defined operations have to be implemented by the user
+  for (int64_t op_id : used_custom_ops) {
+    const auto& custom_op = CustomOpRegistry<PassiveType>::get(op_id);
+    out << "def " << custom_op.name << "(*args):\n";
+    out << single_indent << "assert len(args) == " << custom_op.arity << '\n';
+    out << single_indent << "raise NotImplementedError(\"Custom operation `" << custom_op.name
+        << "` must be implemented by the user.\")\n\n\n";
+  }
 
   out << "def f(";
   for (int64_t id : IteratorReverser(input_variables)) {
@@ -177,19 +413,78 @@ void to_python(const Graph<PassiveType>* graph, const std::string& filename) {
     out << single_indent << expr << '\n';
   }
   out << '\n' << single_indent << "return ";
-  for (int64_t id : IteratorReverser(possible_output_variables)) {
-    if (!used_variables.contains(id)) {
-      out << make_var(id) << ", ";
-    }
+  for (int64_t id : output_variables) {
+    out << make_var(id) << ", ";
   }
   out << "\n\n\n";
 
+  if (adjoint) {
+    for (int64_t op_id : adjoint_code.used_custom_ops) {
+      const auto& custom_op = CustomOpRegistry<PassiveType>::get(op_id);
+      out << "def " << custom_op.name << "_derivative(arg_idx, *args):\n";
+      out << single_indent << "assert len(args) == " << custom_op.arity << '\n';
+      out << single_indent << "raise NotImplementedError(\"Derivative of custom operation `"
+          << custom_op.name << "` must be implemented by the user.\")\n\n\n";
+    }
+
+    out << "def f_adjoint(";
+    for (int64_t id : IteratorReverser(input_variables)) {
+      out << make_var(id) << ',';
+    }
+    for (int64_t id : output_variables) {
+      out << 's' << id << ',';
+    }
+    out << "):\n";
+    for (const auto& expr : IteratorReverser(expressions)) {
+      out << single_indent << expr << '\n';
+    }
+    out << '\n';
+    for (const auto& statement : adjoint_code.statements) {
+      out << single_indent << statement << '\n';
+    }
+    out << '\n' << single_indent << "return ";
+    for (int64_t id : IteratorReverser(input_variables)) {
+      out << (adjoint_code.has_adjoint[static_cast<size_t>(id)] ? "a"s + std::to_string(id)
+                                                                 : "0.0"s)
+          << ", ";
+    }
+    out << "\n\n\n";
+  }
+
+  const auto write_values = [&] {
+    for (const auto& val : IteratorReverser(input_values)) {
+      if constexpr (is_matrix_type_v<PassiveType>) {
+        out << "np.array([";
+        for (decltype(val.rows()) row = 0; row < val.rows(); ++row) {
+          out << '[';
+          for (decltype(val.cols()) col = 0; col < val.cols(); ++col) {
+            out << val(row, col) << ',';
+          }
+          out << "],";
+        }
+        out << "]),";
+      } else if constexpr (std::is_integral_v<PassiveType>) {
+        // Promote such that 8 bit types are not written as characters
+        out << +val << ',';
+      } else {
+        out << val << ',';
+      }
+    }
+  };
+
   out << "def main():\n";
   out << single_indent << "print(f\"{f(";
-  for (const auto& val : IteratorReverser(input_values)) {
-    out << val << ',';
+  write_values();
+  out << ") = }\")\n";
+  if (adjoint) {
+    out << single_indent << "print(f\"{f_adjoint(";
+    write_values();
+    for (size_t i = 0; i < output_variables.size(); ++i) {
+      out << "1.0,";
+    }
+    out << ") = }\")\n";
   }
-  out << ") = }\")\n\n\n";
+  out << "\n\n";
 
   out << "if __name__ == \"__main__\":\n";
   out << single_indent << "main()\n";
@@ -27,6 +27,17 @@ constexpr bool is_record_type_v = is_record_type<T>::value;
 template <typename T>
 using decay_record_type_t = typename is_record_type<T>::underlying_type;
 
+// - Check for matrix types, e.g. `Eigen::Matrix` --------------------------------------------------
+template <typename T>
+concept MatrixType = requires(const T& t) {
+  typename T::Scalar;
+  t.rows();
+  t.cols();
+};
+
+template <typename T>
+constexpr bool is_matrix_type_v = MatrixType<T>;
+
 // - Container concept -----------------------------------------------------------------------------
 template <typename Container>
 concept FwdContainerType = requires(Container c) {
@@ -0,0 +1,15 @@
+#ifndef RT_TEST_KERNEL_HPP_
+#define RT_TEST_KERNEL_HPP_
+
+#include <cmath>
+
+// - Scalar kernel shared by the replay tests ------------------------------------------------------
+// Uses every elementary operation and a constant; works for `double`, `RecordType` and the static
+// graph types.
+template <typename T>
+[[nodiscard]] constexpr auto f(const T& x, const T& y) -> T {
+  const T c = 0.1;
+  return sin(x) * y + sqrt(x) - x / y + c * cos(y);
+}
+
+#endif  // RT_TEST_KERNEL_HPP_
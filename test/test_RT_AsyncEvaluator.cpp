@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "AsyncEvaluator.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+#include "TestKernel.hpp"
+
+TEST(test_RT_AsyncEvaluator, IndependentOutputs) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  // Four independent blocks
+  std::array<RType, 8> x{1.5, 2.5, 0.7, 3.1, 4.0, 0.5, 2.0, 2.0};
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(x, g);
+  std::vector<int64_t> outputs{};
+  for (size_t i = 0; i < x.size(); i += 2) {
+    outputs.push_back(f(x[i], f(x[i + 1], x[i])).id());
+  }
+
+  RT::AsyncEvaluator<PT> async_eval(*g, outputs, 1ul, 3ul);
+  EXPECT_EQ(async_eval.num_threads(), 3ul);
+  // No shared nodes, one cone per output
+  EXPECT_EQ(async_eval.num_tasks(), outputs.size());
+
+  RT::Evaluator<PT> eval(*g);
+  for (PT shift : {0.0, 0.25, 1.0}) {
+    std::vector<PT> inputs{};
+    for (const auto& xi : x) {
+      inputs.push_back(xi.value() + shift);
+    }
+    auto futures = async_eval.evaluate_async(inputs);
+    eval.evaluate(inputs);
+    ASSERT_EQ(futures.size(), outputs.size());
+    for (size_t o = 0; o < outputs.size(); ++o) {
+      EXPECT_EQ(futures[o].get(), eval.value(outputs[o]));
+    }
+    async_eval.wait();
+    EXPECT_TRUE(async_eval.guards_hold());
+  }
+}
+
+TEST(test_RT_AsyncEvaluator, SharedNodes) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+  RType z = 0.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  z.register_graph(g);
+
+  // `shared` is needed by the first two outputs, the third output is independent and the last
+  // output is itself needed by the second one
+  const RType shared = f(x, y);
+  const RType last   = f(shared, shared);
+  const std::array outputs{(shared * x).id(), (sin(shared) + last).id(), f(z, z).id(), last.id()};
+
+  RT::AsyncEvaluator<PT> async_eval(*g, outputs, 1ul, 2ul);
+  // One shared component and a cone per output, the cone of the last output is empty
+  EXPECT_EQ(async_eval.num_tasks(), 5ul);
+
+  const std::array inputs{0.7, 3.1, 2.0};
+  const auto futures = async_eval.evaluate_async(inputs);
+  RT::Evaluator<PT> eval(*g);
+  eval.evaluate(inputs);
+  for (size_t o = 0; o < outputs.size(); ++o) {
+    EXPECT_EQ(futures[o].get(), eval.value(outputs[o]));
+  }
+}
+
+TEST(test_RT_AsyncEvaluator, InverseColumns) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr Eigen::Index n = 6;
+  Eigen::MatrixX<RType> A(n, n);
+  auto g = std::make_shared<RT::Graph<PT>>();
+  for (Eigen::Index j = 0; j < n; ++j) {
+    for (Eigen::Index i = 0; i < n; ++i) {
+      A(i, j) = 1.0 / static_cast<double>(i + j + 1) + (i == j ? static_cast<double>(n) : 0.0);
+      A(i, j).register_graph(g);
+    }
+  }
+  const Eigen::MatrixX<RType> A_inv = A.llt().solve(Eigen::MatrixX<RType>::Identity(n, n));
+
+  std::vector<int64_t> outputs{};
+  for (const auto& r : A_inv.reshaped()) {
+    outputs.push_back(r.id());
+  }
+  // The factorization is shared, the solve for every column is independent and the positivity
+  // checks of the factorization form the guard task
+  RT::AsyncEvaluator<PT> async_eval(*g, outputs, static_cast<size_t>(n));
+  EXPECT_EQ(async_eval.num_tasks(), static_cast<size_t>(n) + 2ul);
+
+  std::vector<PT> inputs{};
+  for (const auto& a : A.reshaped()) {
+    inputs.push_back(2.0 * a.value());
+  }
+  const auto futures = async_eval.evaluate_async(inputs);
+  RT::Evaluator<PT> eval(*g);
+  eval.evaluate(inputs);
+  for (size_t o = 0; o < outputs.size(); ++o) {
+    EXPECT_EQ(futures[o].get(), eval.value(outputs[o]));
+  }
+  async_eval.wait();
+  EXPECT_TRUE(async_eval.guards_hold());
+
+  // The futures of an evaluation stay valid after the next evaluation started
+  const auto next = async_eval.evaluate_async(inputs);
+  EXPECT_EQ(next[0].get(), futures[0].get());
+}
+
+TEST(test_RT_AsyncEvaluator, Guard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  auto g  = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+
+  RType res;
+  if (x > 0.0) {
+    res = x * x;
+  } else {
+    res = -x;
+  }
+
+  const std::array outputs{res.id()};
+  RT::AsyncEvaluator<PT> async_eval(*g, outputs, 1ul, 2ul);
+  // The cone of the output and the task of the guard
+  EXPECT_EQ(async_eval.num_tasks(), 2ul);
+  {
+    const std::array inputs{3.0};
+    EXPECT_DOUBLE_EQ(async_eval.evaluate_async(inputs)[0].get(), 9.0);
+    async_eval.wait();
+    EXPECT_TRUE(async_eval.guards_hold());
+  }
+  {
+    const std::array inputs{-2.0};
+    EXPECT_DOUBLE_EQ(async_eval.evaluate_async(inputs)[0].get(), 4.0);
+    async_eval.wait();
+    EXPECT_FALSE(async_eval.guards_hold());
+  }
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include "BatchEvaluator.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+template <typename T>
+void f(Eigen::Vector2<T>& v) {
+  T u;
+  u    = v(0) * v(0) * v(1) * v(1);
+  v(0) = sin(u);
+  v(1) = v(1) * u;
+}
+
+}  // namespace
+
+template <typename BatchEval>
+class test_RT_BatchEvaluator : public testing::Test {};
+
+using Widths = testing::Types<RT::BatchEvaluator<double, 4>,
+                              RT::BatchEvaluator<double, 8>,
+                              RT::BatchEvaluator<double, 16>>;
+TYPED_TEST_SUITE(test_RT_BatchEvaluator, Widths);
+
+TYPED_TEST(test_RT_BatchEvaluator, SameAsScalar) {
+  using PT         = double;
+  using RType      = RT::RecordType<PT>;
+  constexpr auto W = TypeParam::width();
+
+  Eigen::Vector2<RType> v{1.0, 2.0};
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(v, g);
+  f(v);
+
+  std::vector<PT> inputs(2 * W);
+  for (size_t l = 0; l < W; ++l) {
+    inputs[l]     = 0.1 * static_cast<PT>(l);
+    inputs[W + l] = 1.0 - 0.05 * static_cast<PT>(l);
+  }
+
+  TypeParam batch_eval(*g);
+  batch_eval.evaluate(inputs);
+
+  RT::Evaluator<PT> eval(*g);
+  for (size_t l = 0; l < W; ++l) {
+    const std::array lane_inputs{inputs[l], inputs[W + l]};
+    eval.evaluate(lane_inputs);
+    EXPECT_TRUE(batch_eval.guards_hold(l));
+    for (int64_t id = 0; id < static_cast<int64_t>(g->values().size()); ++id) {
+      EXPECT_EQ(batch_eval.value(id, l), eval.value(id)) << "Node " << id << ", lane " << l;
+    }
+  }
+}
+
+TEST(test_RT_BatchEvaluator, Guard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  RType res;
+  if (x < y) {
+    res = x * y;
+  } else {
+    res = x + y;
+  }
+
+  RT::BatchEvaluator<PT, 4> eval(*g);
+  const std::array inputs{1.0, 5.0, 3.0, 4.0, 2.0, 4.0, 3.0, 4.0};
+  eval.evaluate(inputs);
+
+  EXPECT_TRUE(eval.guards_hold(0));
+  EXPECT_FALSE(eval.guards_hold(1));
+  EXPECT_FALSE(eval.guards_hold(2));
+  EXPECT_FALSE(eval.guards_hold(3));
+  EXPECT_DOUBLE_EQ(eval.value(res.id(), 0), 2.0);
+
+  const auto lanes = eval.lanes(res.id());
+  EXPECT_DOUBLE_EQ(lanes[1], 20.0);
+}
+
+TEST(test_RT_BatchEvaluator, Int) {
+  using PT    = int;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 17;
+  RType y = 5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  const RType res = (x / y) * y + x % y - x;
+
+  RT::BatchEvaluator<PT, 4> eval(*g);
+  const std::array inputs{17, -23, 8, 100, 5, 4, 3, -7};
+  eval.evaluate(inputs);
+  for (size_t l = 0; l < 4; ++l) {
+    EXPECT_EQ(eval.value(res.id(), l), 0) << "Lane " << l;
+  }
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "Bytecode.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+template <typename T>
+[[nodiscard]] auto f(const T& x, const T& y) -> T {
+  const T c = 2.0;
+  return sin(x) * y + sqrt(x) - x / y + c;
+}
+
+}  // namespace
+
+TEST(test_RT_Bytecode, MatchesEvaluator) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res1 = f(x, y);
+  const RType res2 = f(y, res1);
+
+  const std::array outputs{res1.id(), res2.id()};
+  RT::BytecodeInterpreter<PT> interpreter(*g, outputs);
+  RT::Evaluator<PT> eval(*g);
+  for (const auto& [x_new, y_new] :
+       {std::pair{1.5, 2.5}, std::pair{0.7, 3.1}, std::pair{4.0, 1.5}}) {
+    const std::array inputs{x_new, y_new};
+    interpreter.evaluate(inputs);
+    eval.evaluate(inputs);
+
+    EXPECT_TRUE(interpreter.guards_hold());
+    EXPECT_EQ(interpreter.output(0), eval.value(res1.id()));
+    EXPECT_EQ(interpreter.output(1), eval.value(res2.id()));
+  }
+
+  EXPECT_LT(interpreter.bytecode().num_registers, g->operations().size());
+}
+
+TEST(test_RT_Bytecode, RegisterReuse) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 0.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+
+  // Long chain, only a few values are live at the same time
+  const RType a = 0.9;
+  RType res     = x;
+  for (int i = 0; i < 1000; ++i) {
+    res = sin(res) * a + x;
+  }
+
+  const std::array outputs{res.id()};
+  RT::BytecodeInterpreter<PT> interpreter(*g, outputs);
+  const auto& bytecode = interpreter.bytecode();
+  EXPECT_LE(bytecode.num_registers, 4ul);
+
+  // Copies into `res` are coalesced
+  EXPECT_LT(bytecode.code.size(), g->operations().size());
+  for (const auto& ins : bytecode.code) {
+    EXPECT_TRUE(ins.num_args == 0 || ins.op != RT::NodeType::VAR);
+  }
+
+  const std::array inputs{0.25};
+  interpreter.evaluate(inputs);
+  PT expected = 0.25;
+  for (int i = 0; i < 1000; ++i) {
+    expected = std::sin(expected) * 0.9 + 0.25;
+  }
+  EXPECT_EQ(interpreter.output(0), expected);
+}
+
+TEST(test_RT_Bytecode, DeadCodeElimination) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  const RType used   = x * y;
+  const RType unused = sin(x) + cos(y);
+
+  const std::array outputs{used.id()};
+  RT::BytecodeInterpreter<PT> interpreter(*g, outputs);
+
+  // Two loads and the product
+  ASSERT_EQ(interpreter.bytecode().code.size(), 3ul);
+  EXPECT_EQ(interpreter.bytecode().code.back().op, RT::NodeType::MUL);
+
+  const std::array inputs{3.0, 4.0};
+  interpreter.evaluate(inputs);
+  EXPECT_EQ(interpreter.output(0), 12.0);
+}
+
+TEST(test_RT_Bytecode, Guard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  RType res;
+  if (x < y) {
+    res = x * y;
+  } else {
+    res = x + y;
+  }
+
+  const std::array outputs{res.id()};
+  RT::BytecodeInterpreter<PT> interpreter(*g, outputs);
+  {
+    const std::array inputs{3.0, 4.0};
+    interpreter.evaluate(inputs);
+    EXPECT_TRUE(interpreter.guards_hold());
+    EXPECT_EQ(interpreter.output(0), 12.0);
+  }
+
+  {
+    const std::array inputs{5.0, 4.0};
+    interpreter.evaluate(inputs);
+    EXPECT_FALSE(interpreter.guards_hold());
+    ASSERT_EQ(interpreter.violated_guards().size(), 1ul);
+    EXPECT_EQ(g->operations()[static_cast<size_t>(interpreter.violated_guards()[0])],
+              RT::NodeType::GUARD);
+  }
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "Checkpointing.hpp"
+#include "Derivatives.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+// Explicit Euler step of a damped pendulum with a nonlinear forcing
+template <typename T>
+[[nodiscard]] auto step(const std::vector<T>& state) -> std::vector<T> {
+  const T dt = 0.01;
+  const T c  = 0.1;
+  return {state[0] + dt * state[1],
+          state[1] - dt * (sin(state[0]) + c * state[1] * state[2]),
+          state[2] + dt * cos(state[0] * state[1])};
+}
+
+}  // namespace
+
+TEST(test_RT_Checkpointing, MaxReversibleSteps) {
+  EXPECT_EQ(RT::max_reversible_steps(0, 5), 1ul);
+  EXPECT_EQ(RT::max_reversible_steps(5, 0), 1ul);
+  EXPECT_EQ(RT::max_reversible_steps(1, 3), 4ul);
+  EXPECT_EQ(RT::max_reversible_steps(3, 2), 10ul);
+  EXPECT_EQ(RT::max_reversible_steps(10, 10), 184756ul);
+  EXPECT_EQ(RT::max_reversible_steps(1000, 1000), std::numeric_limits<size_t>::max());
+}
+
+TEST(test_RT_Checkpointing, GradientMatchesFullTape) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr size_t num_steps = 50;
+  const std::array<PT, 3> initial_state{0.8, -0.3, 0.5};
+  const std::array<PT, 3> seeds{1.0, -2.0, 0.5};
+
+  // Reference: tape of the whole loop
+  std::vector<RType> full_state(std::cbegin(initial_state), std::cend(initial_state));
+  auto full_graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(full_state, full_graph);
+  for (size_t i = 0; i < num_steps; ++i) {
+    full_state = step(full_state);
+  }
+  std::vector<int64_t> outputs{};
+  for (const auto& s : full_state) {
+    outputs.push_back(s.id());
+  }
+  const auto expected = RT::gradient<PT>(*full_graph, outputs, seeds);
+
+  // Tape of a single step
+  std::vector<RType> state(std::cbegin(initial_state), std::cend(initial_state));
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(state, graph);
+  const auto next = step(state);
+  RT::mark_iteration_boundary(next, graph);
+
+  size_t prev_evaluated_steps = 0;
+  for (size_t max_checkpoints : {1ul, 2ul, 3ul, 5ul, 8ul, 100ul}) {
+    RT::CheckpointedGradient<PT> checkpointed(*graph, max_checkpoints);
+    checkpointed.evaluate(initial_state, num_steps, seeds);
+
+    for (size_t i = 0; i < 3; ++i) {
+      EXPECT_NEAR(checkpointed.state()[i], full_state[i].value(), 1e-12)
+          << "max_checkpoints = " << max_checkpoints;
+      EXPECT_NEAR(checkpointed.gradient()[i], expected[i], 1e-12)
+          << "max_checkpoints = " << max_checkpoints;
+    }
+    EXPECT_LE(checkpointed.max_used_checkpoints(), max_checkpoints);
+
+    // More memory never needs more recomputation
+    if (prev_evaluated_steps > 0) {
+      EXPECT_LE(checkpointed.num_evaluated_steps(), prev_evaluated_steps);
+    }
+    prev_evaluated_steps = checkpointed.num_evaluated_steps();
+  }
+}
+
+TEST(test_RT_Checkpointing, NumEvaluatedSteps) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  std::vector<RType> state{0.1, 0.2, 0.3};
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(state, graph);
+  const auto next = step(state);
+  RT::mark_iteration_boundary(next, graph);
+
+  const std::array<PT, 3> initial_state{0.1, 0.2, 0.3};
+  const std::array<PT, 3> seeds{1.0, 1.0, 1.0};
+  constexpr size_t num_steps = 20;
+
+  // Only the initial state: every step is replayed from the start
+  RT::CheckpointedGradient<PT> no_checkpoints(*graph, 1);
+  no_checkpoints.evaluate(initial_state, num_steps, seeds);
+  EXPECT_EQ(no_checkpoints.num_evaluated_steps(), num_steps * (num_steps + 1) / 2);
+
+  // One checkpoint per step: every step is evaluated once forward and once for the reverse sweep
+  RT::CheckpointedGradient<PT> all_checkpoints(*graph, num_steps);
+  all_checkpoints.evaluate(initial_state, num_steps, seeds);
+  EXPECT_EQ(all_checkpoints.num_evaluated_steps(), 2 * num_steps - 1);
+  EXPECT_EQ(all_checkpoints.max_used_checkpoints(), num_steps);
+
+  // Binomial bound: with s free checkpoints and r repetitions at most (r + 1) evaluations per step
+  for (size_t max_checkpoints = 2; max_checkpoints < num_steps; ++max_checkpoints) {
+    size_t num_repetitions = 0;
+    while (RT::max_reversible_steps(max_checkpoints - 1, num_repetitions) < num_steps) {
+      ++num_repetitions;
+    }
+    RT::CheckpointedGradient<PT> checkpointed(*graph, max_checkpoints);
+    checkpointed.evaluate(initial_state, num_steps, seeds);
+    EXPECT_LE(checkpointed.num_evaluated_steps(), (num_repetitions + 1) * num_steps)
+        << "max_checkpoints = " << max_checkpoints;
+  }
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "EigenSupport.hpp"
+
+#include <Eigen/Dense>
+
+TEST(test_RT_EigenSupport, Sum) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr Eigen::Index n = 4;
+  Eigen::VectorX<RType> vec(n);
+  vec << 1.0, 2.0, 3.0, 4.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(vec, g);
+
+  RType res = vec.sum();
+  EXPECT_DOUBLE_EQ(res.value(), 10.0);
+  EXPECT_EQ(res.node_type(), RT::NodeType::SUM);
+
+  const auto& ops = g->operations();
+  ASSERT_EQ(ops.size(), static_cast<size_t>(n) + 1ul);
+
+  const auto& deps = g->dependencies();
+  ASSERT_EQ(deps.size(), 2ul * static_cast<size_t>(n) + 2ul);
+  for (Eigen::Index i = 0; i < n; ++i) {
+    EXPECT_EQ(deps[static_cast<size_t>(n + i)], vec(i).id());
+  }
+  EXPECT_EQ(deps[2 * n], -n);
+  EXPECT_EQ(deps[2 * n + 1], res.id());
+}
+
+TEST(test_RT_EigenSupport, Dot) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr Eigen::Index n = 3;
+  Eigen::VectorX<RType> lhs(n);
+  lhs << 1.0, 2.0, 3.0;
+  Eigen::VectorX<RType> rhs(n);
+  rhs << 4.0, 5.0, 6.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(lhs, g);
+  RT::register_variable(rhs, g);
+
+  RType res = lhs.dot(rhs);
+  EXPECT_DOUBLE_EQ(res.value(), 32.0);
+
+  const auto& ops = g->operations();
+  ASSERT_EQ(ops.size(), 2ul * static_cast<size_t>(n) + 1ul);
+  EXPECT_EQ(res.node_type(), RT::NodeType::DOT);
+
+  const auto& deps = g->dependencies();
+  for (Eigen::Index i = 0; i < n; ++i) {
+    EXPECT_EQ(deps[static_cast<size_t>(2 * n + i)], lhs(i).id());
+    EXPECT_EQ(deps[static_cast<size_t>(3 * n + i)], rhs(i).id());
+  }
+  EXPECT_EQ(deps[static_cast<size_t>(4 * n)], -2 * n);
+}
+
+TEST(test_RT_EigenSupport, SquaredNorm) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  Eigen::Vector3<RType> vec{1.0, 2.0, 2.0};
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(vec, g);
+
+  RType res = vec.squaredNorm();
+  EXPECT_DOUBLE_EQ(res.value(), 9.0);
+
+  size_t dot_count = 0;
+  for (auto op : g->operations()) {
+    dot_count += static_cast<size_t>(op == RT::NodeType::DOT);
+    EXPECT_NE(op, RT::NodeType::MUL);
+    EXPECT_NE(op, RT::NodeType::ADD);
+  }
+  EXPECT_EQ(dot_count, 1ul);
+}
+
+TEST(test_RT_EigenSupport, MatrixProduct) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr Eigen::Index n = 2;
+  Eigen::MatrixX<RType> lhs(n, n);
+  lhs << 1.0, 2.0, 3.0, 4.0;
+  Eigen::MatrixX<RType> rhs(n, n);
+  rhs << 5.0, 6.0, 7.0, 8.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(lhs.reshaped(), g);
+  RT::register_variable(rhs.reshaped(), g);
+
+  Eigen::MatrixX<RType> res = lhs * rhs;
+  EXPECT_DOUBLE_EQ(res(0, 0).value(), 19.0);
+  EXPECT_DOUBLE_EQ(res(0, 1).value(), 22.0);
+  EXPECT_DOUBLE_EQ(res(1, 0).value(), 43.0);
+  EXPECT_DOUBLE_EQ(res(1, 1).value(), 50.0);
+
+  // One dot product and one copy into the result per coefficient
+  size_t dot_count = 0;
+  for (auto op : g->operations()) {
+    dot_count += static_cast<size_t>(op == RT::NodeType::DOT);
+    EXPECT_NE(op, RT::NodeType::MUL);
+    EXPECT_NE(op, RT::NodeType::ADD);
+  }
+  EXPECT_EQ(dot_count, static_cast<size_t>(n * n));
+  EXPECT_EQ(g->operations().size(), static_cast<size_t>(2 * n * n + 2 * n * n));
+}
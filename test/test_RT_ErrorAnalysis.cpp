@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+#include "ErrorAnalysis.hpp"
+#include "Evaluator.hpp"
+#include "MixedPrecisionEvaluator.hpp"
+#include "RecordType.hpp"
+
+#include "TestKernel.hpp"
+
+TEST(test_RT_ErrorAnalysis, IntervalContainsValues) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res = f(x, f(x, y));
+
+  const RT::Tape<PT> tape(*g);
+  const std::array<RT::Interval<PT>, 2> box{{{1.0, 2.0}, {0.5, 4.0}}};
+  const auto intervals = RT::interval_sweep<PT>(tape, box);
+  ASSERT_EQ(intervals.size(), tape.num_nodes());
+
+  // Every node of every sample has to be contained in its interval
+  RT::Evaluator<PT> eval(*g);
+  for (int i = 0; i <= 10; ++i) {
+    for (int j = 0; j <= 10; ++j) {
+      const std::array inputs{1.0 + 0.1 * i, 0.5 + 0.35 * j};
+      eval.evaluate(inputs);
+      for (size_t idx = 0; idx < tape.num_nodes(); ++idx) {
+        EXPECT_TRUE(intervals[idx].contains(eval.values()[idx]))
+            << "node " << idx << " at (" << inputs[0] << ", " << inputs[1] << ")";
+      }
+    }
+  }
+  EXPECT_GT(intervals[static_cast<size_t>(res.id())].width(), 0.0);
+}
+
+TEST(test_RT_ErrorAnalysis, IntervalOperations) {
+  using PT        = double;
+  using RType     = RT::RecordType<PT>;
+  constexpr PT pi = std::numbers::pi;
+
+  RType x = 1.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  const RType s   = sin(x);
+  const RType c   = cos(x);
+  const RType inv = 1.0 / x;
+  const RType sq  = x * x;
+
+  const RT::Tape<PT> tape(*g);
+  const auto range = [&](PT lower, PT upper) {
+    const std::array<RT::Interval<PT>, 1> box{{{lower, upper}}};
+    return RT::interval_sweep<PT>(tape, box);
+  };
+
+  // The maximum of sin is inside, the minimum is not
+  auto intervals = range(0.0, pi);
+  EXPECT_EQ(intervals[static_cast<size_t>(s.id())].upper, 1.0);
+  EXPECT_LE(intervals[static_cast<size_t>(s.id())].lower, 0.0);
+  EXPECT_GT(intervals[static_cast<size_t>(s.id())].lower, -1e-15);
+  EXPECT_EQ(intervals[static_cast<size_t>(c.id())].lower, -1.0);
+  EXPECT_EQ(intervals[static_cast<size_t>(c.id())].upper, 1.0);
+  EXPECT_LE(intervals[static_cast<size_t>(sq.id())].lower, 0.0);
+  EXPECT_GE(intervals[static_cast<size_t>(sq.id())].upper, pi * pi);
+
+  // Zero in the denominator
+  EXPECT_EQ(intervals[static_cast<size_t>(inv.id())].upper, std::numeric_limits<PT>::infinity());
+
+  intervals = range(-0.1, 0.1);
+  EXPECT_EQ(intervals[static_cast<size_t>(c.id())].upper, 1.0);
+  EXPECT_NEAR(intervals[static_cast<size_t>(c.id())].lower, std::cos(0.1), 1e-15);
+
+  // x * x is not aware that both arguments are the same
+  EXPECT_NEAR(intervals[static_cast<size_t>(sq.id())].lower, -0.01, 1e-15);
+
+  intervals = range(2.0, 4.0);
+  EXPECT_NEAR(intervals[static_cast<size_t>(inv.id())].lower, 0.25, 1e-15);
+  EXPECT_NEAR(intervals[static_cast<size_t>(inv.id())].upper, 0.5, 1e-15);
+}
+
+TEST(test_RT_ErrorAnalysis, DivisionByIntervalContainingZero) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 0.5;
+  RType y = 0.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType q   = x / y;
+  const RType res = q + x;
+
+  // 0 * inf does not produce NaN bounds
+  const RT::Tape<PT> tape(*g);
+  const std::array<RT::Interval<PT>, 2> box{{{0.0, 1.0}, {-1.0, 1.0}}};
+  const auto intervals = RT::interval_sweep<PT>(tape, box);
+  for (auto id : {q.id(), res.id()}) {
+    EXPECT_EQ(intervals[static_cast<size_t>(id)].lower, -std::numeric_limits<PT>::infinity());
+    EXPECT_EQ(intervals[static_cast<size_t>(id)].upper, std::numeric_limits<PT>::infinity());
+  }
+  EXPECT_TRUE(intervals[static_cast<size_t>(q.id())].contains(q.value()));
+}
+
+TEST(test_RT_ErrorAnalysis, UncertainGuards) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+
+  const RType threshold = 1.5;
+  RType res;
+  if (x < threshold) {
+    res = x * x;
+  } else {
+    res = x;
+  }
+
+  const RT::Tape<PT> tape(*g);
+  const std::array<RT::Interval<PT>, 1> inside{{{0.0, 1.0}}};
+  EXPECT_TRUE(RT::uncertain_guards<PT>(tape, RT::interval_sweep<PT>(tape, inside)).empty());
+
+  const std::array<RT::Interval<PT>, 1> across{{{0.0, 2.0}}};
+  const auto guards = RT::uncertain_guards<PT>(tape, RT::interval_sweep<PT>(tape, across));
+  ASSERT_EQ(guards.size(), 1ul);
+  EXPECT_EQ(tape.op(guards[0]), RT::NodeType::GUARD);
+}
+
+TEST(test_RT_ErrorAnalysis, RoundingErrorBoundsFloatReplay) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  RType res = x;
+  for (int i = 0; i < 10; ++i) {
+    res = f(res, y);
+  }
+
+  const RT::Tape<PT> tape(*g);
+  const auto bounds = RT::rounding_error_sweep<PT>(
+      tape, tape.values(), static_cast<PT>(std::numeric_limits<float>::epsilon()) / 2);
+
+  RT::MixedPrecisionEvaluator<float, PT> replay(*g);
+  replay.evaluate();
+  const auto stats = replay.error_statistics();
+  for (size_t idx = 0; idx < tape.num_nodes(); ++idx) {
+    // First order bound, the second order terms are far below the float precision
+    EXPECT_LE(stats.absolute_errors[idx], bounds[idx] * (1.0 + 1e-6)) << "node " << idx;
+  }
+  EXPECT_GT(bounds[static_cast<size_t>(res.id())], 0.0);
+}
+
+TEST(test_RT_ErrorAnalysis, FloatSafeNodes) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+
+  // Catastrophic cancellation, the large intermediate must stay double
+  const RType big       = 1e8;
+  const RType shifted   = x + big;
+  const RType cancelled = shifted - big;
+  // Well conditioned
+  const RType root   = sqrt(x);
+  const RType scaled = root * 2.0;
+
+  const std::array outputs{cancelled.id(), scaled.id()};
+  const auto analysis = RT::analyze_precision<PT>(*g, outputs, 1e-6);
+  ASSERT_EQ(analysis.float_safe.size(), g->operations().size());
+  EXPECT_FALSE(analysis.float_safe[static_cast<size_t>(shifted.id())]);
+  EXPECT_GT(analysis.float_errors[static_cast<size_t>(shifted.id())], 1.0);
+  EXPECT_TRUE(analysis.float_safe[static_cast<size_t>(root.id())]);
+  EXPECT_TRUE(analysis.float_safe[static_cast<size_t>(scaled.id())]);
+  EXPECT_NEAR(analysis.sensitivities[static_cast<size_t>(root.id())], 1.0, 1e-15);
+  EXPECT_LT(analysis.num_float_safe, analysis.float_safe.size());
+  EXPECT_GT(analysis.num_float_safe, 0ul);
+}
+
+TEST(test_RT_ErrorAnalysis, FloatSafeComparisons) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+
+  // Both values only feed a guard, rounding `near` to float flips the branch
+  const RType near = x * (1.0 + 1e-10);
+  const RType far  = x * 3.0;
+  RType res        = sqrt(x);
+  if (near > 1.0) {
+    res = res * 2.0;
+  }
+  if (far > 1.0) {
+    res = res + 1.0;
+  }
+
+  const std::array outputs{res.id()};
+  const auto analysis = RT::analyze_precision<PT>(*g, outputs, 1e-6);
+  EXPECT_EQ(analysis.sensitivities[static_cast<size_t>(near.id())], 0.0);
+  EXPECT_EQ(analysis.float_errors[static_cast<size_t>(near.id())], 0.0);
+  EXPECT_GT(analysis.flip_risks[static_cast<size_t>(near.id())], 1.0);
+  EXPECT_FALSE(analysis.float_safe[static_cast<size_t>(near.id())]);
+  // The input feeds `near` as well
+  EXPECT_FALSE(analysis.float_safe[static_cast<size_t>(x.id())]);
+
+  EXPECT_LT(analysis.flip_risks[static_cast<size_t>(far.id())], 1e-6);
+  EXPECT_TRUE(analysis.float_safe[static_cast<size_t>(far.id())]);
+  EXPECT_TRUE(analysis.float_safe[static_cast<size_t>(res.id())]);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <Eigen/Dense>
+
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+template <typename T>
+[[nodiscard]] auto f(const T& x, const T& y) -> T {
+  const T c = 2.0;
+  return sin(x) * y + sqrt(x) - x / y + c;
+}
+
+}  // namespace
+
+TEST(test_RT_Evaluator, RecordedInputs) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res = f(x, y);
+
+  ASSERT_EQ(g->inputs().size(), 2ul);
+  EXPECT_EQ(g->inputs()[0], x.id());
+  EXPECT_EQ(g->inputs()[1], y.id());
+
+  RT::Evaluator<PT> eval(*g);
+  const std::array inputs{1.5, 2.5};
+  eval.evaluate(inputs);
+
+  EXPECT_TRUE(eval.guards_hold());
+  ASSERT_EQ(eval.values().size(), g->values().size());
+  for (size_t i = 0; i < g->values().size(); ++i) {
+    EXPECT_EQ(eval.values()[i], g->values()[i]) << "Node " << i;
+  }
+  EXPECT_EQ(eval.value(res.id()), res.value());
+}
+
+TEST(test_RT_Evaluator, NewInputs) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res = f(x, y);
+
+  RT::Evaluator<PT> eval(*g);
+  for (const auto& [x_new, y_new] : {std::pair{0.7, 3.1}, std::pair{4.0, -1.5}}) {
+    const std::array inputs{x_new, y_new};
+    eval.evaluate(inputs);
+
+    // Same operations without recording
+    const auto expected = f(RType{x_new}, RType{y_new}).value();
+    EXPECT_EQ(eval.value(res.id()), expected);
+    EXPECT_NEAR(eval.value(res.id()), f(x_new, y_new), 1e-12);
+  }
+}
+
+TEST(test_RT_Evaluator, Guard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  RType res;
+  if (x < y) {
+    res = x * y;
+  } else {
+    res = x + y;
+  }
+
+  RT::Evaluator<PT> eval(*g);
+  {
+    const std::array inputs{3.0, 4.0};
+    eval.evaluate(inputs);
+    EXPECT_TRUE(eval.guards_hold());
+    EXPECT_DOUBLE_EQ(eval.value(res.id()), 12.0);
+  }
+
+  {
+    const std::array inputs{5.0, 4.0};
+    eval.evaluate(inputs);
+    EXPECT_FALSE(eval.guards_hold());
+    ASSERT_EQ(eval.violated_guards().size(), 1ul);
+    EXPECT_EQ(g->operations()[static_cast<size_t>(eval.violated_guards()[0])],
+              RT::NodeType::GUARD);
+  }
+}
+
+TEST(test_RT_Evaluator, Select) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  const RType cond    = compare(x, y, RT::ComparisonType::LT);
+  const RType product = x * y;
+  const RType sum     = x + y;
+  const RType res     = select(cond, product, sum);
+
+  RT::Evaluator<PT> eval(*g);
+  const std::array inputs{5.0, 4.0};
+  eval.evaluate(inputs);
+
+  EXPECT_TRUE(eval.guards_hold());
+  EXPECT_DOUBLE_EQ(eval.value(res.id()), 9.0);
+}
+
+TEST(test_RT_Evaluator, Int) {
+  using PT    = int;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 17;
+  RType y = 5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  const RType res = (x / y) * y + x % y - -x;
+  EXPECT_EQ(res.value(), 34);
+
+  RT::Evaluator<PT> eval(*g);
+  const std::array inputs{-23, 4};
+  eval.evaluate(inputs);
+  EXPECT_EQ(eval.value(res.id()), (-23 / 4) * 4 + -23 % 4 - 23);
+}
+
+TEST(test_RT_Evaluator, CustomOp) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  const auto op_id = RT::register_custom_op<PT>(
+      "hypot", 2, [](std::span<const PT> args) { return std::hypot(args[0], args[1]); });
+
+  RType x = 3.0;
+  RType y = 4.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  const RType res = custom_op(op_id, x, y);
+  EXPECT_DOUBLE_EQ(res.value(), 5.0);
+
+  RT::Evaluator<PT> eval(*g);
+  const std::array inputs{5.0, 12.0};
+  eval.evaluate(inputs);
+  EXPECT_DOUBLE_EQ(eval.value(res.id()), 13.0);
+}
+
+TEST(test_RT_Evaluator, Matrix) {
+  using PT    = Eigen::MatrixXd;
+  using RType = RT::RecordType<PT>;
+
+  RType A = PT(PT::Identity(3, 3));
+  RType b = PT(PT::Ones(3, 1));
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  A.register_graph(g);
+  b.register_graph(g);
+
+  const RType res = transpose(b) * solve(A * A, b);
+  EXPECT_DOUBLE_EQ(res.value()(0, 0), 3.0);
+
+  const PT A_new = PT::Random(3, 3) + 3.0 * PT::Identity(3, 3);
+  const PT b_new = PT::Random(3, 1);
+
+  RT::Evaluator<PT> eval(*g);
+  const std::array inputs{A_new, b_new};
+  eval.evaluate(inputs);
+
+  const PT expected = b_new.transpose() * (A_new * A_new).partialPivLu().solve(b_new);
+  EXPECT_NEAR(eval.value(res.id())(0, 0), expected(0, 0), 1e-12);
+}
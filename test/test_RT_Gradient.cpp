@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <Eigen/Dense>
+
+#include "Derivatives.hpp"
+#include "EigenSupport.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+template <typename T>
+void f(Eigen::Vector2<T>& v) {
+  T u;
+  u    = v(0) * v(0) * v(1) * v(1);
+  v(0) = sin(u);
+  v(1) = v(1) * u;
+}
+
+template <typename T>
+[[nodiscard]] auto g(const T& x, const T& y) -> T {
+  return sqrt(x) / y - cos(x * y) + (-x);
+}
+
+}  // namespace
+
+TEST(test_RT_Gradient, AllOperations) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  const PT x0 = 1.3;
+  const PT y0 = 0.7;
+  RType x     = x0;
+  RType y     = y0;
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(graph);
+  y.register_graph(graph);
+  const RType res = g(x, y);
+
+  const std::array outputs{res.id()};
+  const std::array seeds{1.0};
+  const auto grad = RT::gradient<PT>(*graph, outputs, seeds);
+  ASSERT_EQ(grad.size(), 2ul);
+
+  const auto dx = 0.5 / (std::sqrt(x0) * y0) + y0 * std::sin(x0 * y0) - 1.0;
+  const auto dy = -std::sqrt(x0) / (y0 * y0) + x0 * std::sin(x0 * y0);
+  EXPECT_NEAR(grad[0], dx, 1e-12);
+  EXPECT_NEAR(grad[1], dy, 1e-12);
+}
+
+TEST(test_RT_Gradient, MultipleOutputs) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  const PT a = 1.0;
+  const PT b = 2.0;
+  Eigen::Vector2<RType> v{a, b};
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(v, graph);
+  f(v);
+
+  const auto u = a * a * b * b;
+
+  // Rows of the Jacobian
+  const std::array outputs{v(0).id(), v(1).id()};
+  {
+    const std::array seeds{1.0, 0.0};
+    const auto grad = RT::gradient<PT>(*graph, outputs, seeds);
+    EXPECT_NEAR(grad[0], std::cos(u) * 2.0 * a * b * b, 1e-12);
+    EXPECT_NEAR(grad[1], std::cos(u) * 2.0 * a * a * b, 1e-12);
+  }
+  {
+    const std::array seeds{0.0, 1.0};
+    const auto grad = RT::gradient<PT>(*graph, outputs, seeds);
+    EXPECT_NEAR(grad[0], 2.0 * a * b * b * b, 1e-12);
+    EXPECT_NEAR(grad[1], 3.0 * a * a * b * b, 1e-12);
+  }
+}
+
+TEST(test_RT_Gradient, FiniteDifferences) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 0.4;
+  RType y = 1.9;
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(graph);
+  y.register_graph(graph);
+  const RType res = g(x, y);
+
+  // Gradient at new inputs using the values of a replay
+  const std::array inputs{2.1, -0.8};
+  RT::Evaluator<PT> eval(*graph);
+  eval.evaluate(inputs);
+
+  const std::array outputs{res.id()};
+  const std::array seeds{1.0};
+  const auto grad = RT::gradient<PT>(eval.tape(), eval.values(), outputs, seeds);
+
+  constexpr PT h  = 1e-6;
+  const auto fd_x = (g(inputs[0] + h, inputs[1]) - g(inputs[0] - h, inputs[1])) / (2.0 * h);
+  const auto fd_y = (g(inputs[0], inputs[1] + h) - g(inputs[0], inputs[1] - h)) / (2.0 * h);
+  EXPECT_NEAR(grad[0], fd_x, 1e-6);
+  EXPECT_NEAR(grad[1], fd_y, 1e-6);
+}
+
+TEST(test_RT_Gradient, SelectAndGuard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 3.0;
+  RType y = 2.0;
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(graph);
+  y.register_graph(graph);
+
+  RType res;
+  if (x > y) {
+    res = select(compare(x, y, RT::ComparisonType::GT), x * x, y * y);
+  } else {
+    res = x + y;
+  }
+
+  const std::array outputs{res.id()};
+  const std::array seeds{1.0};
+  const auto grad = RT::gradient<PT>(*graph, outputs, seeds);
+  EXPECT_DOUBLE_EQ(grad[0], 6.0);
+  EXPECT_DOUBLE_EQ(grad[1], 0.0);
+}
+
+TEST(test_RT_Gradient, DotAndCustomOp) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  const auto op_id = RT::register_custom_op<PT>(
+      "hypot",
+      2,
+      [](std::span<const PT> args) { return std::hypot(args[0], args[1]); },
+      [](std::span<const PT> args, size_t i) { return args[i] / std::hypot(args[0], args[1]); });
+
+  Eigen::Vector3<RType> v{1.0, 2.0, 2.0};
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(v, graph);
+
+  const RType norm2 = v.squaredNorm();
+  const RType res   = custom_op(op_id, norm2, v(0));
+  EXPECT_DOUBLE_EQ(res.value(), std::hypot(9.0, 1.0));
+
+  const std::array outputs{res.id()};
+  const std::array seeds{1.0};
+  const auto grad = RT::gradient<PT>(*graph, outputs, seeds);
+
+  const auto h = std::hypot(9.0, 1.0);
+  EXPECT_NEAR(grad[0], 9.0 / h * 2.0 + 1.0 / h, 1e-12);
+  EXPECT_NEAR(grad[1], 9.0 / h * 4.0, 1e-12);
+  EXPECT_NEAR(grad[2], 9.0 / h * 4.0, 1e-12);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include "Graph.hpp"
+#include "RecordType.hpp"
+
+TEST(test_RT_Graph_Matrix, Gemm) {
+  using PT    = Eigen::MatrixXd;
+  using RType = RT::RecordType<PT>;
+
+  const PT A = PT::Random(2, 3);
+  const PT B = PT::Random(3, 4);
+
+  RType rt1 = A;
+  RType rt2 = B;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  rt1.register_graph(g);
+  rt2.register_graph(g);
+
+  const RType rt3 = rt1 * rt2;
+
+  EXPECT_EQ(rt3.node_type(), RT::NodeType::GEMM);
+  EXPECT_TRUE(rt3.value().isApprox(A * B));
+
+  ASSERT_EQ(g->operations().size(), 3ul);
+  EXPECT_EQ(g->operations()[2], RT::NodeType::GEMM);
+
+  const auto shape = g->shape(rt3.id());
+  EXPECT_EQ(shape.rows, 2);
+  EXPECT_EQ(shape.cols, 4);
+
+  EXPECT_EQ(g->count_ops(), 1ul);
+  EXPECT_EQ(g->count_flops(), 2ul * 2ul * 4ul * 3ul);
+}
+
+TEST(test_RT_Graph_Matrix, ElementwiseAndTranspose) {
+  using PT    = Eigen::Matrix<double, 2, 2>;
+  using RType = RT::RecordType<PT>;
+
+  const PT A = PT::Random();
+  const PT B = PT::Random();
+
+  RType rt1 = A;
+  RType rt2 = B;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  rt1.register_graph(g);
+  rt2.register_graph(g);
+
+  const RType sum   = rt1 + rt2;
+  const RType prod  = cwise_product(rt1, rt2);
+  const RType trans = transpose(rt1);
+
+  EXPECT_EQ(sum.node_type(), RT::NodeType::ADD);
+  EXPECT_EQ(prod.node_type(), RT::NodeType::CWISE_MUL);
+  EXPECT_EQ(trans.node_type(), RT::NodeType::TRANSPOSE);
+
+  EXPECT_TRUE(sum.value().isApprox(A + B));
+  EXPECT_TRUE(prod.value().isApprox(A.cwiseProduct(B)));
+  EXPECT_TRUE(trans.value().isApprox(A.transpose()));
+
+  // Transpose does not count as an operation
+  EXPECT_EQ(g->count_ops(), 2ul);
+  EXPECT_EQ(g->count_flops(), 4ul + 4ul);
+}
+
+TEST(test_RT_Graph_Matrix, Solve) {
+  using PT    = Eigen::MatrixXd;
+  using RType = RT::RecordType<PT>;
+
+  constexpr Eigen::Index n = 4;
+  const PT A               = PT::Random(n, n) + static_cast<double>(n) * PT::Identity(n, n);
+  const PT B               = PT::Random(n, 2);
+
+  RType rt1 = A;
+  RType rt2 = B;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  rt1.register_graph(g);
+  rt2.register_graph(g);
+
+  const RType X = solve(rt1, rt2);
+
+  EXPECT_EQ(X.node_type(), RT::NodeType::SOLVE);
+  EXPECT_TRUE((A * X.value()).isApprox(B));
+
+  const auto shape = g->shape(X.id());
+  EXPECT_EQ(shape.rows, n);
+  EXPECT_EQ(shape.cols, 2);
+
+  EXPECT_EQ(g->count_flops(), static_cast<size_t>(2 * n * n * n / 3 + 2 * n * n * 2));
+}
+
+TEST(test_RT_Graph_Matrix, ScalarFlops) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType rt1 = 1.0;
+  RType rt2 = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  rt1.register_graph(g);
+  rt2.register_graph(g);
+
+  [[maybe_unused]] const RType rt3 = rt1 * rt2 + rt1;
+
+  const auto shape = g->shape(rt1.id());
+  EXPECT_EQ(shape.rows, 1);
+  EXPECT_EQ(shape.cols, 1);
+
+  EXPECT_EQ(g->count_ops(), 2ul);
+  EXPECT_EQ(g->count_flops(), g->count_ops());
+}
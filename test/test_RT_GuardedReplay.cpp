@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "GuardedReplay.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+// Two branches that depend on the inputs
+template <typename T>
+[[nodiscard]] auto f(const std::vector<T>& x) -> std::vector<T> {
+  T y;
+  if (x[0] < x[1]) {
+    y = x[0] * x[1];
+  } else {
+    y = x[0] + x[1];
+  }
+  const T zero = 0.0;
+  if (x[0] > zero) {
+    y = sin(y) * 2.0;
+  } else {
+    y = -y;
+  }
+  return {y, sqrt(x[1] * x[1] + 1.0)};
+}
+
+using PT    = double;
+using RType = RT::RecordType<PT>;
+
+}  // namespace
+
+TEST(test_RT_GuardedReplay, MatchesFunction) {
+  RT::GuardedReplay<PT> replay(f<RType>);
+
+  const std::array<std::array<PT, 2>, 8> inputs{{{1.0, 2.0},
+                                                  {1.5, 2.5},
+                                                  {3.0, 2.0},
+                                                  {-1.0, 2.0},
+                                                  {-3.0, -4.0},
+                                                  {0.5, 0.7},
+                                                  {3.0, 2.0},
+                                                  {-1.0, 0.0}}};
+  for (const auto& x : inputs) {
+    const auto& y       = replay.evaluate(x);
+    const auto expected = f(std::vector<PT>(x.begin(), x.end()));
+    ASSERT_EQ(y.size(), 2ul);
+    EXPECT_EQ(y[0], expected[0]) << "x = (" << x[0] << ", " << x[1] << ")";
+    EXPECT_EQ(y[1], expected[1]) << "x = (" << x[0] << ", " << x[1] << ")";
+  }
+
+  // Four combinations of branches, every evaluation is either replayed or recorded
+  EXPECT_EQ(replay.num_records(), 4ul);
+  EXPECT_EQ(replay.num_traces(), 4ul);
+  EXPECT_EQ(replay.num_replays() + replay.num_records(), inputs.size());
+}
+
+TEST(test_RT_GuardedReplay, SwitchToCachedTrace) {
+  RT::GuardedReplay<PT> replay(f<RType>);
+
+  // Both branches of the first comparison are recorded once
+  replay.evaluate(std::array{1.0, 2.0});
+  replay.evaluate(std::array{3.0, 2.0});
+  EXPECT_EQ(replay.num_records(), 2ul);
+
+  // Alternating branches only continue the replay with the other trace after the first guard
+  for (int i = 0; i < 10; ++i) {
+    const std::array x{i % 2 == 0 ? 1.0 + 0.1 * i : 3.0 + 0.1 * i, 2.0};
+    const auto expected = f(std::vector<PT>(x.begin(), x.end()));
+    EXPECT_EQ(replay.evaluate(x)[0], expected[0]);
+  }
+  EXPECT_EQ(replay.num_records(), 2ul);
+  EXPECT_EQ(replay.num_replays(), 10ul);
+  EXPECT_EQ(replay.num_switches(), 10ul);
+  EXPECT_EQ(replay.outputs().size(), 2ul);
+}
+
+TEST(test_RT_GuardedReplay, CacheSize) {
+  RT::GuardedReplay<PT> replay(f<RType>, 1ul);
+
+  replay.evaluate(std::array{1.0, 2.0});
+  replay.evaluate(std::array{3.0, 2.0});
+  replay.evaluate(std::array{1.0, 2.0});
+  EXPECT_EQ(replay.num_traces(), 1ul);
+  EXPECT_EQ(replay.num_records(), 3ul);
+  EXPECT_EQ(replay.num_switches(), 0ul);
+
+  replay.evaluate(std::array{1.5, 2.0});
+  EXPECT_EQ(replay.num_records(), 3ul);
+  EXPECT_EQ(replay.num_replays(), 1ul);
+}
+
+TEST(test_RT_GuardedReplay, DataDependentLoop) {
+  // The number of iterations depends on the input
+  const auto halve = [](const std::vector<RType>& x) {
+    RType y         = x[0];
+    const RType one = 1.0;
+    while (y > one) {
+      y = y * 0.5;
+    }
+    return std::vector<RType>{y};
+  };
+  RT::GuardedReplay<PT> replay(halve);
+
+  for (PT x : {3.0, 3.5, 7.0, 2.5, 6.0, 0.5, 3.9, 7.9}) {
+    PT expected = x;
+    while (expected > 1.0) {
+      expected *= 0.5;
+    }
+    EXPECT_EQ(replay.evaluate(std::array{x})[0], expected) << "x = " << x;
+  }
+  // One trace per number of iterations: 2, 3 and 0
+  EXPECT_EQ(replay.num_records(), 3ul);
+  EXPECT_EQ(replay.num_replays(), 5ul);
+}
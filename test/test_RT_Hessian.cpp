@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <Eigen/Dense>
+
+#include "Derivatives.hpp"
+#include "EigenSupport.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+template <typename T>
+[[nodiscard]] auto g(const T& x, const T& y) -> T {
+  return sin(x * y) + sqrt(x) / y + cos(x);
+}
+
+// Analytic Hessian of `g`
+[[nodiscard]] auto g_hessian(double x, double y) -> Eigen::Matrix2d {
+  Eigen::Matrix2d H;
+  const auto s = std::sin(x * y);
+  const auto c = std::cos(x * y);
+  H(0, 0)      = -y * y * s - 0.25 / (std::pow(x, 1.5) * y) - std::cos(x);
+  H(0, 1)      = c - x * y * s - 0.5 / (std::sqrt(x) * y * y);
+  H(1, 0)      = H(0, 1);
+  H(1, 1)      = -x * x * s + 2.0 * std::sqrt(x) / (y * y * y);
+  return H;
+}
+
+}  // namespace
+
+TEST(test_RT_Hessian, Analytic) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  const PT x0 = 1.2;
+  const PT y0 = 0.8;
+  RType x     = x0;
+  RType y     = y0;
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(graph);
+  y.register_graph(graph);
+  const RType res = g(x, y);
+
+  const auto H = g_hessian(x0, y0);
+  const std::array outputs{res.id()};
+  const std::array seeds{1.0};
+  const std::array directions{
+      Eigen::Vector2d{1.0, 0.0}, Eigen::Vector2d{0.0, 1.0}, Eigen::Vector2d{0.3, -2.0}};
+  for (const auto& v : directions) {
+    const std::array direction{v(0), v(1)};
+    const auto hvp = RT::hessian_vector_product<PT>(*graph, outputs, seeds, direction);
+    ASSERT_EQ(hvp.size(), 2ul);
+
+    const Eigen::Vector2d expected = H * v;
+    EXPECT_NEAR(hvp[0], expected(0), 1e-12);
+    EXPECT_NEAR(hvp[1], expected(1), 1e-12);
+  }
+}
+
+TEST(test_RT_Hessian, SquaredNorm) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  Eigen::Vector3<RType> v{1.0, -2.0, 0.5};
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(v, graph);
+  const RType res = v.squaredNorm();
+
+  // Hessian of the squared norm is 2 * I
+  const std::array outputs{res.id()};
+  const std::array seeds{1.0};
+  const std::array direction{0.5, 1.0, -3.0};
+  const auto hvp = RT::hessian_vector_product<PT>(*graph, outputs, seeds, direction);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_DOUBLE_EQ(hvp[i], 2.0 * direction[i]);
+  }
+}
+
+TEST(test_RT_Hessian, FiniteDifferences) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.2;
+  RType y = 0.8;
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(graph);
+  y.register_graph(graph);
+  const RType res = g(x, y);
+
+  const std::array outputs{res.id()};
+  const std::array seeds{1.0};
+  const std::array direction{0.7, -0.4};
+
+  RT::Evaluator<PT> eval(*graph);
+  const auto gradient_at = [&](const std::array<PT, 2>& inputs) {
+    eval.evaluate(inputs);
+    return RT::gradient<PT>(eval.tape(), eval.values(), outputs, seeds);
+  };
+
+  constexpr PT h      = 1e-6;
+  const auto grad_fwd = gradient_at({2.0 + h * direction[0], 1.5 + h * direction[1]});
+  const auto grad_bwd = gradient_at({2.0 - h * direction[0], 1.5 - h * direction[1]});
+
+  const std::array inputs{2.0, 1.5};
+  eval.evaluate(inputs);
+  const auto hvp =
+      RT::hessian_vector_product<PT>(eval.tape(), eval.values(), outputs, seeds, direction);
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_NEAR(hvp[i], (grad_fwd[i] - grad_bwd[i]) / (2.0 * h), 1e-6);
+  }
+}
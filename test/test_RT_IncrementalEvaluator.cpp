@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "Evaluator.hpp"
+#include "IncrementalEvaluator.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+template <typename T>
+[[nodiscard]] auto f(const std::vector<T>& x) -> T {
+  T res = x[0];
+  for (size_t i = 1; i < x.size(); ++i) {
+    res = res * cos(x[i]) + sqrt(x[i - 1] * x[i - 1] + x[i]);
+  }
+  return res;
+}
+
+}  // namespace
+
+TEST(test_RT_IncrementalEvaluator, MatchesFullReplay) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr size_t n = 20;
+  std::vector<RType> x(n);
+  std::vector<PT> inputs(n);
+  for (size_t i = 0; i < n; ++i) {
+    inputs[i] = 1.0 + 0.1 * static_cast<PT>(i);
+    x[i]      = inputs[i];
+  }
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(x, g);
+  const RType res = f(x);
+
+  RT::Evaluator<PT> eval(*g);
+  RT::IncrementalEvaluator<PT> inc_eval(*g);
+  EXPECT_EQ(inc_eval.update(), 0ul);
+
+  for (size_t i : {7ul, 0ul, 19ul, 3ul}) {
+    inputs[i] += 0.25;
+    inc_eval.set_input(i, inputs[i]);
+    inc_eval.update();
+    eval.evaluate(inputs);
+
+    EXPECT_GT(inc_eval.num_touched(), 0ul);
+    EXPECT_LT(inc_eval.num_touched(), g->operations().size());
+    for (size_t id = 0; id < g->values().size(); ++id) {
+      EXPECT_EQ(inc_eval.values()[id], eval.values()[id]) << "Node " << id;
+    }
+    EXPECT_EQ(inc_eval.value(res.id()), f(inputs));
+  }
+
+  // Same inputs: nothing to do
+  EXPECT_EQ(inc_eval.evaluate(inputs), 0ul);
+}
+
+TEST(test_RT_IncrementalEvaluator, DirtyCone) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr size_t n = 100;
+  std::vector<RType> x(n, RType{0.5});
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(x, g);
+
+  // Independent chains of two nodes each
+  std::vector<int64_t> y_ids{};
+  std::vector<PT> y_values{};
+  for (const auto& xi : x) {
+    const RType square = xi * xi;
+    const RType yi     = sin(square);
+    y_ids.push_back(yi.id());
+    y_values.push_back(yi.value());
+  }
+
+  RT::IncrementalEvaluator<PT> inc_eval(*g);
+  inc_eval.set_input(42, 0.75);
+  EXPECT_EQ(inc_eval.update(), 2ul);
+  EXPECT_EQ(inc_eval.value(y_ids[42]), std::sin(0.75 * 0.75));
+  EXPECT_EQ(inc_eval.value(y_ids[41]), y_values[41]);
+
+  inc_eval.set_input(0, 0.25);
+  inc_eval.set_input(99, 0.25);
+  EXPECT_EQ(inc_eval.update(), 4ul);
+}
+
+TEST(test_RT_IncrementalEvaluator, UnchangedValueStopsPropagation) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  const RType cond    = compare(x, y, RT::ComparisonType::LT);
+  const RType product = x * y;
+  const RType sum     = y + y;
+  const RType res     = select(cond, sum, product);
+  const RType out     = sqrt(res) + res;
+
+  RT::IncrementalEvaluator<PT> inc_eval(*g);
+
+  // Only the comparison and the product are recomputed, the result of the select is still `sum`
+  inc_eval.set_input(0, 1.5);
+  EXPECT_EQ(inc_eval.update(), 3ul);
+  EXPECT_EQ(inc_eval.value(out.id()), out.value());
+
+  // The condition flips
+  inc_eval.set_input(0, 3.0);
+  EXPECT_GT(inc_eval.update(), 3ul);
+  EXPECT_DOUBLE_EQ(inc_eval.value(out.id()), std::sqrt(6.0) + 6.0);
+}
+
+TEST(test_RT_IncrementalEvaluator, Guard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  RType res;
+  if (x < y) {
+    res = x * y;
+  } else {
+    res = x + y;
+  }
+
+  RT::IncrementalEvaluator<PT> inc_eval(*g);
+  inc_eval.set_input(0, 5.0);
+  inc_eval.update();
+  EXPECT_FALSE(inc_eval.guards_hold());
+  ASSERT_EQ(inc_eval.violated_guards().size(), 1ul);
+  EXPECT_EQ(g->operations()[static_cast<size_t>(inc_eval.violated_guards()[0])],
+            RT::NodeType::GUARD);
+
+  inc_eval.set_input(0, 0.5);
+  inc_eval.update();
+  EXPECT_TRUE(inc_eval.guards_hold());
+  EXPECT_DOUBLE_EQ(inc_eval.value(res.id()), 1.0);
+}
+
+TEST(test_RT_IncrementalEvaluator, SignedZero) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 0.0;
+  RType y = 1.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  // -0 compares equal to +0, but the division distinguishes them
+  const RType inv_x = 1.0 / x;
+  const RType inv_y = 1.0 / (y * 0.0);
+
+  RT::Evaluator<PT> eval(*g);
+  RT::IncrementalEvaluator<PT> inc_eval(*g);
+  const std::vector<PT> inputs{-0.0, -1.0};
+  inc_eval.evaluate(inputs);
+  eval.evaluate(inputs);
+
+  EXPECT_EQ(inc_eval.value(inv_x.id()), -std::numeric_limits<PT>::infinity());
+  EXPECT_EQ(inc_eval.value(inv_x.id()), eval.value(inv_x.id()));
+  EXPECT_EQ(inc_eval.value(inv_y.id()), -std::numeric_limits<PT>::infinity());
+  EXPECT_EQ(inc_eval.value(inv_y.id()), eval.value(inv_y.id()));
+}
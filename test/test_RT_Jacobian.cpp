@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include "Derivatives.hpp"
+#include "EigenSupport.hpp"
+#include "RecordType.hpp"
+
+TEST(test_RT_Jacobian, Inverse) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  Eigen::Matrix3d A_value;
+  A_value << 4.0, 1.0, 0.5, 1.0, 3.0, -0.2, 0.5, -0.2, 2.0;
+  Eigen::Matrix3<RType> A = A_value.cast<RType>();
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(A.reshaped(), graph);
+
+  const Eigen::Matrix3<RType> A_inv = A.inverse();
+  std::vector<int64_t> outputs{};
+  for (const auto& e : A_inv.reshaped()) {
+    outputs.push_back(e.id());
+  }
+
+  const Eigen::Matrix3d Y = A_value.inverse();
+  for (size_t max_lanes : {1ul, 2ul, 4ul, 9ul, 16ul}) {
+    const auto jac = RT::jacobian<PT>(*graph, outputs, max_lanes);
+    ASSERT_EQ(jac.size(), 81ul);
+
+    // d Y(i, j) / d A(k, l) = -Y(i, k) * Y(l, j), both stored in column major order
+    for (Eigen::Index j = 0; j < 3; ++j) {
+      for (Eigen::Index i = 0; i < 3; ++i) {
+        for (Eigen::Index l = 0; l < 3; ++l) {
+          for (Eigen::Index k = 0; k < 3; ++k) {
+            const auto out = static_cast<size_t>(i + 3 * j);
+            const auto in  = static_cast<size_t>(k + 3 * l);
+            EXPECT_NEAR(jac[out * 9 + in], -Y(i, k) * Y(l, j), 1e-12)
+                << "max_lanes = " << max_lanes;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(test_RT_Jacobian, SameAsGradient) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 0.3;
+  RType y = 1.7;
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(graph);
+  y.register_graph(graph);
+
+  const RType a = sin(x * y);
+  const RType b = sqrt(y) - x;
+  const RType c = cos(a) * b;
+
+  const std::array outputs{a.id(), b.id(), c.id()};
+  const auto jac = RT::jacobian<PT>(*graph, outputs, 2);
+  ASSERT_EQ(jac.size(), 6ul);
+
+  for (size_t o = 0; o < outputs.size(); ++o) {
+    std::array seeds{0.0, 0.0, 0.0};
+    seeds[o]        = 1.0;
+    const auto grad = RT::gradient<PT>(*graph, outputs, seeds);
+    EXPECT_DOUBLE_EQ(jac[o * 2], grad[0]) << "Output " << o;
+    EXPECT_DOUBLE_EQ(jac[o * 2 + 1], grad[1]) << "Output " << o;
+  }
+}
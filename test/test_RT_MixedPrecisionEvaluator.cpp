@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "DoubleDouble.hpp"
+#include "Evaluator.hpp"
+#include "MixedPrecisionEvaluator.hpp"
+#include "RecordType.hpp"
+
+#include "TestKernel.hpp"
+
+namespace {
+
+[[nodiscard]] auto abs_diff(const RT::DoubleDouble& a, const RT::DoubleDouble& b) -> double {
+  return std::abs(static_cast<double>(a - b));
+}
+
+}  // namespace
+
+TEST(test_RT_MixedPrecisionEvaluator, DoubleDouble) {
+  using DD = RT::DoubleDouble;
+
+  const DD one   = 1.0;
+  const DD three = 3.0;
+  EXPECT_LT(abs_diff(one / three * three, one), 1e-31);
+  EXPECT_NE((one / three).lo(), 0.0);
+
+  const DD root2 = sqrt(DD{2.0});
+  EXPECT_LT(abs_diff(root2 * root2, DD{2.0}), 1e-31);
+  EXPECT_EQ(sqrt(DD{0.0}), DD{0.0});
+
+  // 1 + 2^-80 is not representable as double
+  const DD tiny  = std::ldexp(1.0, -80);
+  const DD sum   = one + tiny;
+  EXPECT_EQ(sum.hi(), 1.0);
+  EXPECT_EQ(sum.lo(), std::ldexp(1.0, -80));
+  EXPECT_EQ(sum - one, tiny);
+  EXPECT_GT(sum, one);
+
+  for (double x : {0.3, 2.0, -5.0, 100.0}) {
+    const DD s = sin(DD{x});
+    const DD c = cos(DD{x});
+    EXPECT_LT(abs_diff(s * s + c * c, one), 1e-30) << "x = " << x;
+    const auto xl = static_cast<long double>(x);
+    EXPECT_LT(static_cast<double>(std::abs(static_cast<long double>(s) - std::sin(xl))), 1e-18);
+    EXPECT_LT(static_cast<double>(std::abs(static_cast<long double>(c) - std::cos(xl))), 1e-18);
+  }
+}
+
+TEST(test_RT_MixedPrecisionEvaluator, SamePrecision) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res = f(x, f(x, y));
+
+  RT::MixedPrecisionEvaluator<double, PT> eval(*g);
+  eval.evaluate();
+  EXPECT_TRUE(eval.guards_hold());
+  EXPECT_EQ(eval.value(res.id()), res.value());
+
+  const auto stats = eval.error_statistics();
+  EXPECT_EQ(stats.max_absolute_error, 0.0);
+  EXPECT_EQ(stats.max_relative_error, 0.0);
+  EXPECT_EQ(stats.absolute_errors.size(), g->operations().size());
+}
+
+TEST(test_RT_MixedPrecisionEvaluator, Float) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res = f(x, f(x, y));
+
+  RT::MixedPrecisionEvaluator<float, PT> eval(*g);
+  eval.evaluate();
+  EXPECT_TRUE(eval.guards_hold());
+  EXPECT_FLOAT_EQ(eval.value(res.id()), static_cast<float>(res.value()));
+
+  const auto stats = eval.error_statistics();
+  EXPECT_GT(stats.max_relative_error, 0.0);
+  EXPECT_LT(stats.max_relative_error, 1e-6);
+  EXPECT_GT(stats.mean_relative_error, 0.0);
+  ASSERT_GE(stats.worst_node, 0);
+  EXPECT_EQ(stats.relative_errors[static_cast<size_t>(stats.worst_node)],
+            stats.max_relative_error);
+
+  // New inputs
+  const std::array inputs{0.7, 3.1};
+  eval.evaluate(inputs);
+  RT::Evaluator<PT> reference(*g);
+  reference.evaluate(inputs);
+  EXPECT_NEAR(eval.value(res.id()), reference.value(res.id()), 1e-5);
+  EXPECT_LT(eval.error_statistics(reference.values()).max_relative_error, 1e-6);
+}
+
+TEST(test_RT_MixedPrecisionEvaluator, HigherPrecisionReference) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  RType res = x;
+  for (int i = 0; i < 20; ++i) {
+    res = f(res, y);
+  }
+
+  RT::MixedPrecisionEvaluator<RT::DoubleDouble, PT> dd(*g);
+  RT::MixedPrecisionEvaluator<long double, PT> ld(*g);
+  RT::MixedPrecisionEvaluator<double, PT> d(*g);
+  RT::MixedPrecisionEvaluator<float, PT> s(*g);
+  dd.evaluate();
+  ld.evaluate();
+  d.evaluate();
+  s.evaluate();
+
+  // The error shrinks with the precision of the replay
+  const auto ld_error = ld.error_statistics(dd.values()).max_relative_error;
+  const auto d_error  = d.error_statistics(dd.values()).max_relative_error;
+  const auto s_error  = s.error_statistics(dd.values()).max_relative_error;
+  EXPECT_LT(ld_error, d_error);
+  EXPECT_LT(d_error, s_error);
+  EXPECT_LT(d_error, 1e-11);
+  EXPECT_NEAR(static_cast<double>(dd.value(res.id())), res.value(), 1e-11);
+}
+
+TEST(test_RT_MixedPrecisionEvaluator, GuardFlips) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0 + 1e-10;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+
+  const RType one = 1.0;
+  RType res;
+  if (x > one) {
+    res = x - one;
+  } else {
+    res = one - x;
+  }
+
+  RT::MixedPrecisionEvaluator<double, PT> d(*g);
+  d.evaluate();
+  EXPECT_TRUE(d.guards_hold());
+
+  // In float `x` rounds to one and the comparison changes
+  RT::MixedPrecisionEvaluator<float, PT> s(*g);
+  s.evaluate();
+  EXPECT_FALSE(s.guards_hold());
+  ASSERT_EQ(s.violated_guards().size(), 1ul);
+  EXPECT_EQ(g->operations()[static_cast<size_t>(s.violated_guards()[0])], RT::NodeType::GUARD);
+}
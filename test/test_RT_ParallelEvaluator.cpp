@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "Evaluator.hpp"
+#include "ParallelEvaluator.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+// Matrix product of two (n x n) matrices stored in row major order
+template <typename T>
+[[nodiscard]] auto matmul(const std::vector<T>& A, const std::vector<T>& B, size_t n)
+    -> std::vector<T> {
+  std::vector<T> C(n * n);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      T sum = A[i * n] * B[j];
+      for (size_t k = 1; k < n; ++k) {
+        sum += A[i * n + k] * B[k * n + j];
+      }
+      C[i * n + j] = sum;
+    }
+  }
+  return C;
+}
+
+}  // namespace
+
+TEST(test_RT_ParallelEvaluator, MatrixProduct) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr size_t n = 12;
+  std::vector<RType> A(n * n);
+  std::vector<RType> B(n * n);
+  for (size_t i = 0; i < n * n; ++i) {
+    A[i] = static_cast<PT>(i);
+    B[i] = 1.0 / static_cast<PT>(i + 1);
+  }
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(A, g);
+  RT::register_variable(B, g);
+  const auto C = matmul(A, B, n);
+
+  std::vector<PT> inputs(2 * n * n);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i] = 0.5 + 0.25 * static_cast<PT>(i % 7);
+  }
+
+  RT::Evaluator<PT> eval(*g);
+  eval.evaluate(inputs);
+
+  for (size_t num_threads : {1ul, 2ul, 3ul, 4ul}) {
+    RT::ParallelEvaluator<PT> par_eval(*g, num_threads);
+    EXPECT_EQ(par_eval.num_threads(), num_threads);
+    EXPECT_GT(par_eval.num_levels(), n);
+
+    par_eval.evaluate(inputs);
+    EXPECT_TRUE(par_eval.guards_hold());
+    for (int64_t id = 0; id < static_cast<int64_t>(g->values().size()); ++id) {
+      ASSERT_EQ(par_eval.value(id), eval.value(id)) << "Node " << id << ", " << num_threads
+                                                    << " threads";
+    }
+  }
+}
+
+TEST(test_RT_ParallelEvaluator, Guard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  RType res;
+  if (x < y) {
+    res = x * y;
+  } else {
+    res = x + y;
+  }
+
+  RT::ParallelEvaluator<PT> eval(*g, 2);
+  {
+    const std::array inputs{3.0, 4.0};
+    eval.evaluate(inputs);
+    EXPECT_TRUE(eval.guards_hold());
+    EXPECT_DOUBLE_EQ(eval.value(res.id()), 12.0);
+  }
+  {
+    const std::array inputs{5.0, 4.0};
+    eval.evaluate(inputs);
+    EXPECT_FALSE(eval.guards_hold());
+    ASSERT_EQ(eval.violated_guards().size(), 1ul);
+  }
+}
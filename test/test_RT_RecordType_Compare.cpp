@@ -51,3 +51,112 @@ TEST(test_RT_RecordType_Compare, Double) {
     EXPECT_TRUE(rt2 == rt1);
   }
 }
+
+TEST(test_RT_RecordType_Compare, RecordGuard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType rt1(1.0);
+  RType rt2(2.0);
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  rt1.register_graph(g);
+  rt2.register_graph(g);
+
+  EXPECT_TRUE(rt1 < rt2);
+
+  const auto& deps = g->dependencies();
+  const auto& ops  = g->operations();
+  const auto& vals = g->values();
+
+  // - deps -------------------------------------
+  ASSERT_EQ(deps.size(), 9ul);
+  auto d = deps.cbegin();
+  EXPECT_EQ(*d++, rt1.id());
+  EXPECT_EQ(*d++, rt2.id());
+
+  EXPECT_EQ(*d++, rt1.id());
+  EXPECT_EQ(*d++, rt2.id());
+  EXPECT_EQ(*d++, -2);
+  EXPECT_EQ(*d++, 2);
+
+  EXPECT_EQ(*d++, 2);
+  EXPECT_EQ(*d++, -1);
+  EXPECT_EQ(*d++, 3);
+  // - deps -------------------------------------
+
+  // - ops --------------------------------------
+  ASSERT_EQ(ops.size(), 4ul);
+  auto o = ops.cbegin();
+  EXPECT_EQ(*o++, RT::NodeType::VAR);
+  EXPECT_EQ(*o++, RT::NodeType::VAR);
+  EXPECT_EQ(*o++, RT::NodeType::CMP);
+  EXPECT_EQ(*o++, RT::NodeType::GUARD);
+  // - ops --------------------------------------
+
+  // - vals -------------------------------------
+  ASSERT_EQ(vals.size(), 4ul);
+  auto v = vals.cbegin();
+  EXPECT_DOUBLE_EQ(*v++, 1.0);
+  EXPECT_DOUBLE_EQ(*v++, 2.0);
+  EXPECT_DOUBLE_EQ(*v++, 1.0);
+  EXPECT_DOUBLE_EQ(*v++, 1.0);
+  // - vals -------------------------------------
+
+  EXPECT_EQ(static_cast<RT::ComparisonType>(g->attribute(2)), RT::ComparisonType::LT);
+}
+
+TEST(test_RT_RecordType_Compare, RecordAllComparisons) {
+  using PT    = int;
+  using RType = RT::RecordType<PT>;
+
+  RType rt1(1);
+  RType rt2(1);
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  rt1.register_graph(g);
+  rt2.register_graph(g);
+
+  EXPECT_FALSE(rt1 < rt2);
+  EXPECT_TRUE(rt1 <= rt2);
+  EXPECT_FALSE(rt1 > rt2);
+  EXPECT_TRUE(rt1 >= rt2);
+  EXPECT_TRUE(rt1 == rt2);
+  EXPECT_FALSE(rt1 != rt2);
+
+  EXPECT_EQ(g->count_op(RT::NodeType::CMP), 6ul);
+  EXPECT_EQ(g->count_op(RT::NodeType::GUARD), 6ul);
+
+  const auto& ops  = g->operations();
+  const auto& vals = g->values();
+  constexpr std::array expected_cmp{
+      RT::ComparisonType::LT,
+      RT::ComparisonType::LE,
+      RT::ComparisonType::GT,
+      RT::ComparisonType::GE,
+      RT::ComparisonType::EQ,
+      RT::ComparisonType::NE,
+  };
+  constexpr std::array expected_outcome{0, 1, 0, 1, 1, 0};
+  for (size_t i = 0; i < expected_cmp.size(); ++i) {
+    const auto cmp_id = static_cast<int64_t>(2 + 2 * i);
+    ASSERT_EQ(ops[static_cast<size_t>(cmp_id)], RT::NodeType::CMP);
+    ASSERT_EQ(ops[static_cast<size_t>(cmp_id) + 1], RT::NodeType::GUARD);
+    EXPECT_EQ(static_cast<RT::ComparisonType>(g->attribute(cmp_id)), expected_cmp[i]);
+    EXPECT_EQ(vals[static_cast<size_t>(cmp_id) + 1], expected_outcome[i]);
+  }
+}
+
+TEST(test_RT_RecordType_Compare, UnregisteredNoGuard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType rt1(1.0);
+  RType rt2(2.0);
+
+  EXPECT_TRUE(rt1 < rt2);
+  EXPECT_EQ(rt1.graph(), nullptr);
+  EXPECT_EQ(rt2.graph(), nullptr);
+  EXPECT_EQ(rt1.id(), RT::UNREGISTERED);
+  EXPECT_EQ(rt2.id(), RT::UNREGISTERED);
+}
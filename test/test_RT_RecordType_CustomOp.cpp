@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "RecordType.hpp"
+#include "ToPython.hpp"
+
+namespace {
+
+[[nodiscard]] auto read_file(const std::filesystem::path& file) -> std::string {
+  std::ifstream in(file);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+[[nodiscard]] auto register_hypot3() -> int64_t {
+  static const int64_t op_id = RT::register_custom_op<double>(
+      "hypot3",
+      3,
+      [](std::span<const double> args) { return std::hypot(args[0], args[1], args[2]); },
+      [](std::span<const double> args, size_t i) {
+        return args[i] / std::hypot(args[0], args[1], args[2]);
+      });
+  return op_id;
+}
+
+}  // namespace
+
+TEST(test_RT_RecordType_CustomOp, Register) {
+  const auto op_id = register_hypot3();
+  const auto& op   = RT::CustomOpRegistry<double>::get(op_id);
+
+  EXPECT_EQ(op.name, "hypot3");
+  EXPECT_EQ(op.arity, 3ul);
+  ASSERT_TRUE(static_cast<bool>(op.derivative));
+
+  const std::array args{1.0, 2.0, 2.0};
+  EXPECT_DOUBLE_EQ(op.forward(args), 3.0);
+  EXPECT_DOUBLE_EQ(op.derivative(args, 1), 2.0 / 3.0);
+}
+
+TEST(test_RT_RecordType_CustomOp, ConcurrentRegister) {
+  const auto op_id = register_hypot3();
+
+  // Register further operations while other threads look up an existing one
+  constexpr size_t num_threads = 4;
+  constexpr size_t num_ops     = 64;
+  std::vector<std::vector<int64_t>> ids(num_threads);
+  {
+    std::vector<std::jthread> threads{};
+    for (size_t t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t] {
+        for (size_t i = 0; i < num_ops; ++i) {
+          ids[t].push_back(RT::register_custom_op<double>(
+              "identity", 1, [](std::span<const double> args) { return args[0]; }));
+          EXPECT_EQ(RT::CustomOpRegistry<double>::get(op_id).name, "hypot3");
+        }
+      });
+    }
+  }
+
+  std::vector<int64_t> all_ids{};
+  for (const auto& thread_ids : ids) {
+    all_ids.insert(std::end(all_ids), std::cbegin(thread_ids), std::cend(thread_ids));
+  }
+  std::sort(std::begin(all_ids), std::end(all_ids));
+  EXPECT_EQ(std::adjacent_find(std::cbegin(all_ids), std::cend(all_ids)), std::cend(all_ids));
+  EXPECT_GE(RT::CustomOpRegistry<double>::size(), num_threads * num_ops + 1ul);
+}
+
+TEST(test_RT_RecordType_CustomOp, Unregistered) {
+  using RType = RT::RecordType<double>;
+
+  const auto op_id = register_hypot3();
+
+  RType x = 1.0;
+  RType y = 2.0;
+  RType z = 2.0;
+
+  RType res = custom_op(op_id, x, y, z);
+  EXPECT_DOUBLE_EQ(res.value(), 3.0);
+  EXPECT_EQ(res.node_type(), RT::NodeType::CUSTOM);
+  EXPECT_EQ(res.id(), RT::UNREGISTERED);
+}
+
+TEST(test_RT_RecordType_CustomOp, Record) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  const auto op_id = register_hypot3();
+
+  RType x = 1.0;
+  RType y = 2.0;
+  RType z = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(x, g);
+  RT::register_variable(y, g);
+  RT::register_variable(z, g);
+
+  const RType res = custom_op(op_id, x, y, z);
+
+  const auto& deps = g->dependencies();
+  const auto& ops  = g->operations();
+  const auto& vals = g->values();
+
+  // - deps -------------------------------------
+  ASSERT_EQ(deps.size(), 3ul + 5ul);
+  auto d = deps.cbegin();
+  EXPECT_EQ(*d++, x.id());
+  EXPECT_EQ(*d++, y.id());
+  EXPECT_EQ(*d++, z.id());
+
+  EXPECT_EQ(*d++, x.id());
+  EXPECT_EQ(*d++, y.id());
+  EXPECT_EQ(*d++, z.id());
+  EXPECT_EQ(*d++, -3);
+  EXPECT_EQ(*d++, res.id());
+  // - deps -------------------------------------
+
+  ASSERT_EQ(ops.size(), 4ul);
+  EXPECT_EQ(ops[3], RT::NodeType::CUSTOM);
+  ASSERT_EQ(vals.size(), 4ul);
+  EXPECT_DOUBLE_EQ(vals[3], 3.0);
+
+  EXPECT_EQ(g->attribute(res.id()), op_id);
+  EXPECT_EQ(g->count_ops(), 1ul);
+}
+
+TEST(test_RT_RecordType_CustomOp, RecordSpan) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  const auto op_id = register_hypot3();
+
+  std::vector<RType> v{1.0, 2.0, 2.0};
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(v, g);
+
+  const RType res = custom_op(op_id, std::span<const RType>(v));
+  EXPECT_DOUBLE_EQ(res.value(), 3.0);
+
+  ASSERT_EQ(g->operations().size(), 4ul);
+  EXPECT_EQ(g->operations()[3], RT::NodeType::CUSTOM);
+  EXPECT_EQ(g->attribute(res.id()), op_id);
+}
+
+TEST(test_RT_RecordType_CustomOp, Output) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  const auto op_id = register_hypot3();
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(x, g);
+  RT::register_variable(y, g);
+
+  [[maybe_unused]] const RType res = custom_op(op_id, x, y, x * y);
+
+  const auto dir = std::filesystem::temp_directory_path();
+
+  const auto dot_file = dir / "test_RT_RecordType_CustomOp.dot";
+  g->to_dot(dot_file);
+  EXPECT_NE(read_file(dot_file).find("CUSTOM hypot3"), std::string::npos);
+
+  const auto py_file = dir / "test_RT_RecordType_CustomOp.py";
+  RT::to_python(g.get(), py_file);
+  const auto py_code = read_file(py_file);
+  EXPECT_NE(py_code.find("def hypot3(*args):"), std::string::npos);
+  EXPECT_NE(py_code.find("v3 = hypot3(v0, v1, v2, )"), std::string::npos);
+}
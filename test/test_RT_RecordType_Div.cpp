@@ -8,7 +8,6 @@ TEST(test_RT_RecordType_Div, Double) {
   using PT    = double;
   using RType = RT::RecordType<PT>;
 
-  // TODO: Add test for integer types when `invert` is fixed
   {
     RType rt1(6.0);
     RType rt2(3.0);
@@ -50,3 +49,57 @@ TEST(test_RT_RecordType_Div, Double) {
     EXPECT_EQ(rt3.node_type(), RT::NodeType::MUL);
   }
 }
+
+TEST(test_RT_RecordType_Div, Int) {
+  using PT    = int;
+  using RType = RT::RecordType<PT>;
+
+  {
+    RType rt1(7);
+    RType rt2(2);
+    rt1 /= rt2;
+
+    EXPECT_EQ(rt1.value(), 3);
+    EXPECT_EQ(rt1.node_type(), RT::NodeType::VAR);
+  }
+
+  {
+    RType rt1(-7);
+    RType rt2(2);
+
+    auto g = std::make_shared<RT::Graph<PT>>();
+    rt1.register_graph(g);
+    rt2.register_graph(g);
+
+    RType rt3 = rt1 / rt2;
+
+    // Truncates towards zero
+    EXPECT_EQ(rt3.value(), -7 / 2);
+    EXPECT_NE(rt3.id(), rt1.id());
+    EXPECT_NE(rt3.id(), rt2.id());
+    EXPECT_EQ(rt3.node_type(), RT::NodeType::DIV);
+
+    const auto& deps = g->dependencies();
+    ASSERT_EQ(deps.size(), 2ul + 4ul);
+    EXPECT_EQ(deps[2], rt1.id());
+    EXPECT_EQ(deps[3], rt2.id());
+    EXPECT_EQ(deps[4], -2);
+    EXPECT_EQ(deps[5], rt3.id());
+  }
+}
+
+TEST(test_RT_RecordType_Div, Unsigned) {
+  using PT    = uint64_t;
+  using RType = RT::RecordType<PT>;
+
+  RType rt1(17ul);
+  RType rt2(5ul);
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  rt1.register_graph(g);
+  rt2.register_graph(g);
+
+  RType rt3 = rt1 / rt2;
+  EXPECT_EQ(rt3.value(), 3ul);
+  EXPECT_EQ(rt3.node_type(), RT::NodeType::DIV);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "RecordType.hpp"
+
+TEST(test_RT_RecordType_Mod, Int) {
+  using PT    = int;
+  using RType = RT::RecordType<PT>;
+
+  {
+    RType rt1(7);
+    RType rt2(3);
+    rt1 %= rt2;
+
+    EXPECT_EQ(rt1.value(), 1);
+    EXPECT_EQ(rt1.node_type(), RT::NodeType::VAR);
+  }
+
+  {
+    RType rt1(-7);
+    RType rt2(3);
+
+    auto g = std::make_shared<RT::Graph<PT>>();
+    rt1.register_graph(g);
+    rt2.register_graph(g);
+
+    RType rt3 = rt1 % rt2;
+
+    // Sign follows the dividend
+    EXPECT_EQ(rt3.value(), -7 % 3);
+    EXPECT_NE(rt3.id(), rt1.id());
+    EXPECT_NE(rt3.id(), rt2.id());
+    EXPECT_EQ(rt3.node_type(), RT::NodeType::MOD);
+
+    const auto& deps = g->dependencies();
+    ASSERT_EQ(deps.size(), 2ul + 4ul);
+    EXPECT_EQ(deps[2], rt1.id());
+    EXPECT_EQ(deps[3], rt2.id());
+    EXPECT_EQ(deps[4], -2);
+    EXPECT_EQ(deps[5], rt3.id());
+  }
+}
+
+TEST(test_RT_RecordType_Mod, Unsigned) {
+  using PT    = unsigned;
+  using RType = RT::RecordType<PT>;
+
+  RType rt1(17u);
+  RType rt2(5u);
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  rt1.register_graph(g);
+  rt2.register_graph(g);
+
+  RType rt3 = rt1 % rt2;
+  EXPECT_EQ(rt3.value(), 2u);
+  EXPECT_EQ(rt3.node_type(), RT::NodeType::MOD);
+
+  // Index arithmetic, i.e. row and column of a linear index
+  RType idx  = 11u;
+  RType cols = 4u;
+  idx.register_graph(g);
+  EXPECT_EQ((idx / cols).value(), 2u);
+  EXPECT_EQ((idx % cols).value(), 3u);
+  EXPECT_EQ(g->count_op(RT::NodeType::DIV), 1ul);
+  EXPECT_EQ(g->count_op(RT::NodeType::MOD), 2ul);
+}
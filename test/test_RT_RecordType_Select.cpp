@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "RecordType.hpp"
+
+TEST(test_RT_RecordType_Select, Int) {
+  using PT    = int;
+  using RType = RT::RecordType<PT>;
+
+  {
+    RType rt1(1);
+    RType rt2(2);
+
+    RType cond = compare(rt1, rt2, RT::ComparisonType::LT);
+    EXPECT_EQ(cond.value(), 1);
+    EXPECT_EQ(cond.node_type(), RT::NodeType::CMP);
+
+    RType res = select(cond, rt1, rt2);
+    EXPECT_EQ(res.value(), 1);
+    EXPECT_EQ(res.node_type(), RT::NodeType::SELECT);
+  }
+
+  {
+    RType rt1(1);
+    RType rt2(2);
+
+    auto g = std::make_shared<RT::Graph<PT>>();
+    rt1.register_graph(g);
+    rt2.register_graph(g);
+
+    RType res = select(compare(rt1, rt2, RT::ComparisonType::GE), rt1, rt2);
+    EXPECT_EQ(res.value(), 2);
+
+    // No guard is recorded for branch free code
+    EXPECT_EQ(g->count_op(RT::NodeType::GUARD), 0ul);
+    EXPECT_EQ(g->count_op(RT::NodeType::CMP), 1ul);
+    EXPECT_EQ(g->count_op(RT::NodeType::SELECT), 1ul);
+  }
+}
+
+TEST(test_RT_RecordType_Select, Double) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType rt1(-3.0);
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  rt1.register_graph(g);
+
+  // Branch free absolute value
+  const RType cond = compare(rt1, 0.0, RT::ComparisonType::LT);
+  const RType neg  = -rt1;
+  const RType res  = select(cond, neg, rt1);
+  EXPECT_DOUBLE_EQ(res.value(), 3.0);
+
+  const auto& deps = g->dependencies();
+  const auto& ops  = g->operations();
+  const auto& vals = g->values();
+
+  // - deps -------------------------------------
+  // 0: rt1, 1: literal 0.0, 2: CMP, 3: NEG, 4: SELECT
+  ASSERT_EQ(deps.size(), 1ul + 1ul + 4ul + 3ul + 5ul);
+  EXPECT_EQ(deps[0], rt1.id());
+  EXPECT_EQ(deps[1], 1);
+
+  EXPECT_EQ(deps[2], rt1.id());
+  EXPECT_EQ(deps[3], 1);
+  EXPECT_EQ(deps[4], -2);
+  EXPECT_EQ(deps[5], 2);
+
+  EXPECT_EQ(deps[6], rt1.id());
+  EXPECT_EQ(deps[7], -1);
+  EXPECT_EQ(deps[8], 3);
+
+  EXPECT_EQ(deps[9], 2);
+  EXPECT_EQ(deps[10], 3);
+  EXPECT_EQ(deps[11], rt1.id());
+  EXPECT_EQ(deps[12], -3);
+  EXPECT_EQ(deps[13], 4);
+  // - deps -------------------------------------
+
+  // - ops --------------------------------------
+  ASSERT_EQ(ops.size(), 5ul);
+  EXPECT_EQ(ops[2], RT::NodeType::CMP);
+  EXPECT_EQ(ops[3], RT::NodeType::NEG);
+  EXPECT_EQ(ops[4], RT::NodeType::SELECT);
+  // - ops --------------------------------------
+
+  // - vals -------------------------------------
+  ASSERT_EQ(vals.size(), 5ul);
+  EXPECT_DOUBLE_EQ(vals[2], 1.0);
+  EXPECT_DOUBLE_EQ(vals[3], 3.0);
+  EXPECT_DOUBLE_EQ(vals[4], 3.0);
+  // - vals -------------------------------------
+}
@@ -5,7 +5,6 @@
 #include "RecordType.hpp"
 
 TEST(test_RT_RecordType_Sub, Int) {
-  // TODO: Add test for unsigned integer when negation is fixed
   using PT    = int;
   using RType = RT::RecordType<PT>;
   {
@@ -43,7 +42,7 @@ TEST(test_RT_RecordType_Sub, Int) {
     EXPECT_EQ(rt3.value(), 3);
     EXPECT_NE(rt3.id(), rt1.id());
     EXPECT_NE(rt3.id(), rt2.id());
-    EXPECT_EQ(rt3.node_type(), RT::NodeType::ADD);
+    EXPECT_EQ(rt3.node_type(), RT::NodeType::SUB);
   }
 
   {
@@ -59,7 +58,7 @@ TEST(test_RT_RecordType_Sub, Int) {
     EXPECT_EQ(rt3.value(), 3);
     EXPECT_NE(rt3.id(), rt1.id());
     EXPECT_NE(rt3.id(), rt2.id());
-    EXPECT_EQ(rt3.node_type(), RT::NodeType::ADD);
+    EXPECT_EQ(rt3.node_type(), RT::NodeType::SUB);
   }
 }
 
@@ -121,3 +120,51 @@ TEST(test_RT_RecordType_Sub, Double) {
     EXPECT_EQ(rt3.node_type(), RT::NodeType::ADD);
   }
 }
+
+TEST(test_RT_RecordType_Sub, Unsigned) {
+  using PT    = unsigned;
+  using RType = RT::RecordType<PT>;
+
+  {
+    RType rt1(3u);
+    RType rt2(6u);
+
+    auto g = std::make_shared<RT::Graph<PT>>();
+    rt1.register_graph(g);
+    rt2.register_graph(g);
+
+    RType rt3 = rt1 - rt2;
+
+    EXPECT_EQ(rt3.value(), 3u - 6u);
+    EXPECT_EQ(rt3.node_type(), RT::NodeType::SUB);
+
+    const auto& deps = g->dependencies();
+    ASSERT_EQ(deps.size(), 2ul + 4ul);
+    EXPECT_EQ(deps[2], rt1.id());
+    EXPECT_EQ(deps[3], rt2.id());
+    EXPECT_EQ(deps[4], -2);
+    EXPECT_EQ(deps[5], rt3.id());
+  }
+
+  {
+    RType rt1(1u);
+
+    auto g = std::make_shared<RT::Graph<PT>>();
+    rt1.register_graph(g);
+
+    RType rt2 = -rt1;
+
+    EXPECT_EQ(rt2.value(), -1u);
+    EXPECT_EQ(rt2.node_type(), RT::NodeType::NEG);
+  }
+
+  {
+    using PT8 = uint8_t;
+    RT::RecordType<PT8> rt1(static_cast<PT8>(250));
+    RT::RecordType<PT8> rt2(static_cast<PT8>(10));
+
+    EXPECT_EQ((rt1 + rt2).value(), static_cast<PT8>(250 + 10));
+    EXPECT_EQ((rt2 - rt1).value(), static_cast<PT8>(10 - 250));
+    EXPECT_EQ((-rt2).value(), static_cast<PT8>(-10));
+  }
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "Derivatives.hpp"
+#include "RecordType.hpp"
+#include "SparseJacobian.hpp"
+
+namespace {
+
+// y(i) = sin(x(i)) * x(i + 1) + x(i - 1), banded Jacobian
+template <typename T>
+[[nodiscard]] auto banded(const std::vector<T>& x) -> std::vector<T> {
+  const auto n = x.size();
+  std::vector<T> y(n);
+  for (size_t i = 0; i < n; ++i) {
+    y[i] = sin(x[i]);
+    if (i + 1 < n) {
+      y[i] = y[i] * x[i + 1];
+    }
+    if (i > 0) {
+      y[i] = y[i] + x[i - 1];
+    }
+  }
+  return y;
+}
+
+}  // namespace
+
+TEST(test_RT_SparseJacobian, Banded) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr size_t n = 40;
+  std::vector<RType> x(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = 0.1 * static_cast<PT>(i);
+  }
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(x, graph);
+  const auto y = banded(x);
+
+  std::vector<int64_t> outputs{};
+  for (const auto& e : y) {
+    outputs.push_back(e.id());
+  }
+
+  const RT::Tape<PT> tape(*graph);
+  const auto pattern = RT::jacobian_sparsity(tape, std::span<const int64_t>(outputs));
+  EXPECT_EQ(pattern.num_rows, n);
+  EXPECT_EQ(pattern.num_cols, n);
+  EXPECT_EQ(pattern.num_nonzeros(), 3 * n - 2);
+
+  // A tridiagonal matrix needs three colors
+  const auto colors = RT::color_columns(pattern);
+  EXPECT_EQ(*std::max_element(std::cbegin(colors), std::cend(colors)), 2ul);
+
+  const auto sparse = RT::sparse_jacobian<PT>(*graph, outputs);
+  const auto dense  = RT::jacobian<PT>(*graph, outputs);
+  ASSERT_EQ(sparse.num_nonzeros(), 3 * n - 2);
+
+  const auto rows = sparse.row_indices();
+  std::vector<PT> expanded(n * n, 0.0);
+  for (size_t k = 0; k < sparse.num_nonzeros(); ++k) {
+    EXPECT_LE(rows[k] > sparse.col_indices[k] ? rows[k] - sparse.col_indices[k]
+                                              : sparse.col_indices[k] - rows[k],
+              1ul);
+    expanded[rows[k] * n + sparse.col_indices[k]] = sparse.values[k];
+  }
+  for (size_t k = 0; k < n * n; ++k) {
+    EXPECT_DOUBLE_EQ(expanded[k], dense[k]) << "Entry (" << k / n << ", " << k % n << ")";
+  }
+}
+
+TEST(test_RT_SparseJacobian, IgnoreComparisons) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  std::vector<RType> x{1.0, 2.0, 3.0};
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(x, graph);
+
+  // Only depends on x(1) and x(2), x(0) is part of the condition
+  const RType res = select(compare(x[0], x[1], RT::ComparisonType::LT), x[1] * x[1], x[2]);
+
+  const std::array outputs{res.id()};
+  const auto jac = RT::sparse_jacobian<PT>(*graph, outputs);
+  ASSERT_EQ(jac.num_nonzeros(), 2ul);
+  EXPECT_EQ(jac.col_indices[0], 1ul);
+  EXPECT_EQ(jac.col_indices[1], 2ul);
+  EXPECT_DOUBLE_EQ(jac.values[0], 4.0);
+  EXPECT_DOUBLE_EQ(jac.values[1], 0.0);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+
+#include "StaticGraph.hpp"
+
+#include "TestKernel.hpp"
+
+namespace {
+
+// Same kernel as `example_AAD_112`
+template <typename T>
+[[nodiscard]] constexpr auto aad_112(std::array<T, 2> v) -> std::array<T, 2> {
+  const T u = v[0] * v[0] * v[1] * v[1];
+  v[0]      = std::sin(u);
+  v[1]      = v[1] * u;
+  return v;
+}
+
+template <typename T>
+[[nodiscard]] constexpr auto polynomial(const T& x) -> T {
+  const T two   = 2.0;
+  const T three = 3.0;
+  return (x * x - two * three) / (x + 1.0) - -x;
+}
+
+constexpr auto f_graph = RT::record_static<double, 2>([](const auto& x) { return f(x[0], x[1]); });
+constexpr auto aad_112_graph =
+    RT::record_static<double, 2>([](const auto& x) { return aad_112(x); });
+constexpr auto polynomial_graph =
+    RT::record_static<double, 1>([](const auto& x) { return polynomial(x[0]); });
+
+}  // namespace
+
+TEST(test_RT_StaticGraph, Recording) {
+  static_assert(decltype(f_graph)::num_inputs == 2);
+  static_assert(decltype(f_graph)::num_outputs == 1);
+  // Two inputs, 9 operations and the constant `c`
+  static_assert(f_graph.num_nodes == 12);
+  static_assert(aad_112_graph.num_outputs == 2);
+
+  // `two * three` is folded into a single constant
+  static_assert(polynomial_graph.num_nodes == 9);
+  static_assert(polynomial_graph.nodes[2].op == RT::NodeType::LITERAL);
+  static_assert(polynomial_graph.nodes[2].value == 6.0);
+}
+
+TEST(test_RT_StaticGraph, CompileTimeEvaluation) {
+  static_assert(RT::static_evaluate<polynomial_graph>({3.0})[0] == polynomial(3.0));
+  static_assert(RT::static_evaluate<polynomial_graph>({-0.5})[0] == polynomial(-0.5));
+}
+
+TEST(test_RT_StaticGraph, MatchesFunction) {
+  for (double x : {0.1, 0.5, 1.0, 2.5, 10.0}) {
+    for (double y : {-3.0, 0.3, 1.0, 7.5}) {
+      EXPECT_EQ(RT::static_evaluate<f_graph>({x, y})[0], f(x, y));
+
+      const auto expected = aad_112(std::array{x, y});
+      const auto result   = RT::static_evaluate<aad_112_graph>({x, y});
+      EXPECT_EQ(result[0], expected[0]);
+      EXPECT_EQ(result[1], expected[1]);
+    }
+  }
+}
+
+TEST(test_RT_StaticGraph, ConstantOutput) {
+  constexpr auto graph = RT::record_static<double, 1>([](const auto& x) {
+    using T = std::remove_cvref_t<decltype(x[0])>;
+    return std::array<T, 2>{x[0] * 2.0, T{1.5} * 2.0};
+  });
+  static_assert(graph.num_nodes == 4);
+  const auto result = RT::static_evaluate<graph>({4.0});
+  EXPECT_EQ(result[0], 8.0);
+  EXPECT_EQ(result[1], 3.0);
+}
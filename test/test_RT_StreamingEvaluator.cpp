@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "Bytecode.hpp"
+#include "RecordType.hpp"
+#include "StreamingEvaluator.hpp"
+
+#include "TestKernel.hpp"
+
+namespace {
+
+using PT    = double;
+using RType = RT::RecordType<PT>;
+
+}  // namespace
+
+TEST(test_RT_StreamingEvaluator, MatchesInterpreter) {
+  std::array<RType, 6> x{1.5, 2.5, 0.7, 3.1, 4.0, 0.5};
+  auto g = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(x, g);
+
+  std::vector<int64_t> outputs{};
+  RType acc = x[0];
+  for (size_t i = 1; i < x.size(); ++i) {
+    acc = f(acc * acc + 1.0, x[i]);
+    outputs.push_back(acc.id());
+  }
+  const RType zero = 0.0;
+  if (acc > zero) {
+    outputs.push_back((acc * 2.0).id());
+  }
+
+  const auto bytecode = RT::compile(*g, outputs);
+  const auto file     = std::filesystem::temp_directory_path() / "test_RT_StreamingEvaluator.rtbc";
+  // Small chunks so that operands and constants are split between chunks
+  constexpr size_t chunk_size = 7;
+  RT::save_bytecode(bytecode, file, chunk_size);
+
+  RT::StreamingEvaluator<PT> stream(file);
+  EXPECT_EQ(stream.num_chunks(), (bytecode.code.size() + chunk_size - 1) / chunk_size);
+  RT::BytecodeInterpreter<PT> interpreter(bytecode);
+  for (PT shift : {0.0, 0.5, -20.0}) {
+    std::vector<PT> inputs{};
+    for (const auto& xi : x) {
+      inputs.push_back(std::abs(xi.value() + shift) + 0.1);
+    }
+    interpreter.evaluate(inputs);
+    stream.evaluate(inputs);
+    for (size_t o = 0; o < outputs.size(); ++o) {
+      EXPECT_EQ(stream.output(o), interpreter.output(o));
+    }
+    EXPECT_EQ(stream.violated_guards(), interpreter.violated_guards());
+  }
+  EXPECT_LT(stream.resident_size(), bytecode.working_set_size());
+
+  std::filesystem::remove(file);
+}
+
+TEST(test_RT_StreamingEvaluator, GuardViolation) {
+  RType x = 1.0;
+  auto g  = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  const RType one = 1.0;
+  const RType y   = x > one ? x * x : x;
+
+  const std::array outputs{y.id()};
+  const auto file =
+      std::filesystem::temp_directory_path() / "test_RT_StreamingEvaluator_Guard.rtbc";
+  RT::save_bytecode(RT::compile(*g, outputs), file, 2ul);
+
+  RT::StreamingEvaluator<PT> stream(file);
+  stream.evaluate(std::array{0.5});
+  EXPECT_TRUE(stream.guards_hold());
+  stream.evaluate(std::array{2.0});
+  EXPECT_FALSE(stream.guards_hold());
+  EXPECT_EQ(stream.violated_guards().size(), 1ul);
+
+  std::filesystem::remove(file);
+}
+
+TEST(test_RT_StreamingEvaluator, InvalidFile) {
+  const auto file = std::filesystem::temp_directory_path() / "test_RT_StreamingEvaluator_Bad.rtbc";
+  std::filesystem::remove(file);
+  EXPECT_THROW(RT::StreamingEvaluator<PT>{file}, std::runtime_error);
+
+  {
+    std::ofstream out(file);
+    out << "not a bytecode file, but long enough to contain a header";
+  }
+  EXPECT_THROW(RT::StreamingEvaluator<PT>{file}, std::runtime_error);
+
+  // Truncated chunks are reported by `evaluate`
+  RType x = 1.0;
+  auto g  = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  const std::array outputs{f(x, x).id()};
+  RT::save_bytecode(RT::compile(*g, outputs), file, 3ul);
+  std::filesystem::resize_file(file, std::filesystem::file_size(file) - 4);
+  RT::StreamingEvaluator<PT> stream(file);
+  EXPECT_THROW(stream.evaluate(std::array{1.0}), std::runtime_error);
+  EXPECT_THROW(RT::StreamingEvaluator<float>{file}, std::runtime_error);
+
+  std::filesystem::remove(file);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <Eigen/Dense>
+
+#include "Derivatives.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+
+namespace {
+
+template <typename T>
+void f(Eigen::Vector2<T>& v) {
+  T u;
+  u    = v(0) * v(0) * v(1) * v(1);
+  v(0) = sin(u);
+  v(1) = v(1) * u;
+}
+
+template <typename T>
+[[nodiscard]] auto g(const T& x, const T& y, const T& z) -> T {
+  return sqrt(x) / y - cos(x * z) + (-z);
+}
+
+}  // namespace
+
+TEST(test_RT_Tangent, JacobianVectorProduct) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  const PT a = 1.0;
+  const PT b = 2.0;
+  Eigen::Vector2<RType> v{a, b};
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(v, graph);
+  f(v);
+
+  const auto u = a * a * b * b;
+  Eigen::Matrix2d J;
+  J << std::cos(u) * 2.0 * a * b * b, std::cos(u) * 2.0 * a * a * b, 2.0 * a * b * b * b,
+      3.0 * a * a * b * b;
+
+  const std::array outputs{v(0).id(), v(1).id()};
+  const std::array direction{0.3, -1.2};
+  const auto jvp = RT::jacobian_vector_product<PT>(*graph, outputs, direction);
+
+  const Eigen::Vector2d expected = J * Eigen::Vector2d{direction[0], direction[1]};
+  ASSERT_EQ(jvp.size(), 2ul);
+  EXPECT_NEAR(jvp[0], expected(0), 1e-12);
+  EXPECT_NEAR(jvp[1], expected(1), 1e-12);
+}
+
+TEST(test_RT_Tangent, SameAsReverse) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.3;
+  RType y = 0.7;
+  RType z = -0.4;
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(graph);
+  y.register_graph(graph);
+  z.register_graph(graph);
+  const RType res = g(x, y, z);
+
+  RT::Evaluator<PT> eval(*graph);
+  const std::array inputs{0.9, 2.0, 1.5};
+  eval.evaluate(inputs);
+
+  const std::array outputs{res.id()};
+  const std::array seeds{1.0};
+  const auto grad = RT::gradient<PT>(eval.tape(), eval.values(), outputs, seeds);
+
+  // Identity as directions gives the full Jacobian in one sweep
+  constexpr size_t k = 3;
+  std::vector<PT> directions(3 * k, 0.0);
+  for (size_t i = 0; i < k; ++i) {
+    directions[i * k + i] = 1.0;
+  }
+  const auto jac =
+      RT::jacobian_matrix_product<PT>(eval.tape(), eval.values(), outputs, directions, k);
+  ASSERT_EQ(jac.size(), k);
+  for (size_t i = 0; i < k; ++i) {
+    EXPECT_NEAR(jac[i], grad[i], 1e-12) << "Input " << i;
+  }
+}
+
+TEST(test_RT_Tangent, VectorMode) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  Eigen::Vector2<RType> v{0.8, -1.1};
+
+  auto graph = std::make_shared<RT::Graph<PT>>();
+  RT::register_variable(v, graph);
+  f(v);
+
+  const std::array outputs{v(0).id(), v(1).id()};
+
+  // Directions (1, 2), (-3, 0.5), (0, 1) and (4, 4), stored input major
+  constexpr size_t k = 4;
+  const std::array<PT, 2 * k> directions{1.0, -3.0, 0.0, 4.0, 2.0, 0.5, 1.0, 4.0};
+  const auto jmp = RT::jacobian_matrix_product<PT>(*graph, outputs, directions, k);
+  ASSERT_EQ(jmp.size(), 2 * k);
+
+  for (size_t d = 0; d < k; ++d) {
+    const std::array direction{directions[d], directions[k + d]};
+    const auto jvp = RT::jacobian_vector_product<PT>(*graph, outputs, direction);
+    EXPECT_DOUBLE_EQ(jmp[d], jvp[0]) << "Direction " << d;
+    EXPECT_DOUBLE_EQ(jmp[k + d], jvp[1]) << "Direction " << d;
+  }
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "Bytecode.hpp"
+#include "RecordType.hpp"
+#include "ThreadedInterpreter.hpp"
+
+namespace {
+
+template <typename T>
+[[nodiscard]] auto f(const T& x, const T& y) -> T {
+  const T c = 2.0;
+  return sin(x) * y + sqrt(x) - x / y + c * cos(y);
+}
+
+constexpr std::array ALL_OPTIONS{
+    RT::ThreadedInterpreterOptions{.superinstructions = true, .computed_goto = true},
+    RT::ThreadedInterpreterOptions{.superinstructions = false, .computed_goto = true},
+    RT::ThreadedInterpreterOptions{.superinstructions = true, .computed_goto = false},
+    RT::ThreadedInterpreterOptions{.superinstructions = false, .computed_goto = false},
+};
+
+}  // namespace
+
+TEST(test_RT_ThreadedInterpreter, MatchesBytecodeInterpreter) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res1 = f(x, y);
+  const RType cond = compare(res1, y, RT::ComparisonType::GT);
+  const RType res2 = select(cond, -res1, f(y, x));
+
+  const std::array outputs{res1.id(), res2.id()};
+  const auto bytecode = RT::compile(*g, outputs);
+  RT::BytecodeInterpreter<PT> reference(bytecode);
+  for (const auto& options : ALL_OPTIONS) {
+    RT::ThreadedInterpreter<PT> interpreter(bytecode, options);
+    EXPECT_EQ(interpreter.num_superinstructions() > 0, options.superinstructions);
+
+    for (const auto& [x_new, y_new] :
+         {std::pair{1.5, 2.5}, std::pair{0.7, 3.1}, std::pair{4.0, 0.5}}) {
+      const std::array inputs{x_new, y_new};
+      interpreter.evaluate(inputs);
+      reference.evaluate(inputs);
+
+      EXPECT_TRUE(interpreter.guards_hold());
+      EXPECT_EQ(interpreter.output(0), reference.output(0));
+      EXPECT_EQ(interpreter.output(1), reference.output(1));
+    }
+  }
+}
+
+TEST(test_RT_ThreadedInterpreter, Superinstructions) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+  RType z = 3.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  z.register_graph(g);
+
+  // MUL followed by ADD, INV followed by MUL
+  const RType fma   = x * y + z;
+  const RType ratio = fma / x;
+
+  const std::array outputs{ratio.id()};
+  const auto bytecode = RT::compile(*g, outputs);
+  const auto pairs    = RT::profile_op_pairs(bytecode);
+  ASSERT_EQ(pairs.size(), 2ul);
+  for (const auto& pair : pairs) {
+    EXPECT_EQ(pair.count, 1ul);
+  }
+
+  RT::ThreadedInterpreter<PT> interpreter(bytecode);
+  EXPECT_EQ(interpreter.num_superinstructions(), 2ul);
+
+  const std::array inputs{2.0, 3.0, 4.0};
+  interpreter.evaluate(inputs);
+  EXPECT_EQ(interpreter.output(0), (2.0 * 3.0 + 4.0) * (1.0 / 2.0));
+}
+
+TEST(test_RT_ThreadedInterpreter, Int) {
+  using PT    = int;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 17;
+  RType y = 5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res = (x - y) * (x / y) + x % y;
+
+  const std::array outputs{res.id()};
+  for (const auto& options : ALL_OPTIONS) {
+    RT::ThreadedInterpreter<PT> interpreter(*g, outputs, options);
+    const std::array inputs{23, 4};
+    interpreter.evaluate(inputs);
+    EXPECT_EQ(interpreter.output(0), (23 - 4) * (23 / 4) + 23 % 4);
+  }
+}
+
+TEST(test_RT_ThreadedInterpreter, Guard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  RType res;
+  if (x < y) {
+    res = x * y;
+  } else {
+    res = x + y;
+  }
+
+  const std::array outputs{res.id()};
+  for (const auto& options : ALL_OPTIONS) {
+    RT::ThreadedInterpreter<PT> interpreter(*g, outputs, options);
+    {
+      const std::array inputs{3.0, 4.0};
+      interpreter.evaluate(inputs);
+      EXPECT_TRUE(interpreter.guards_hold());
+      EXPECT_EQ(interpreter.output(0), 12.0);
+    }
+
+    {
+      const std::array inputs{5.0, 4.0};
+      interpreter.evaluate(inputs);
+      EXPECT_FALSE(interpreter.guards_hold());
+      ASSERT_EQ(interpreter.violated_guards().size(), 1ul);
+      EXPECT_EQ(g->operations()[static_cast<size_t>(interpreter.violated_guards()[0])],
+                RT::NodeType::GUARD);
+    }
+  }
+}
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "Derivatives.hpp"
+#include "Evaluator.hpp"
+#include "RecordType.hpp"
+#include "ToCpp.hpp"
+
+#include "TestKernel.hpp"
+
+namespace {
+
+[[nodiscard]] auto read_file(const std::filesystem::path& file) -> std::string {
+  std::ifstream in(file);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+// Symmetric positive definite matrix
+template <typename T>
+[[nodiscard]] auto spd_matrix(Eigen::Index n) -> Eigen::MatrixX<T> {
+  Eigen::MatrixX<T> A(n, n);
+  for (Eigen::Index j = 0; j < n; ++j) {
+    for (Eigen::Index i = 0; i < n; ++i) {
+      A(i, j) = 1.0 / static_cast<double>(i + j + 1) + (i == j ? static_cast<double>(n) : 0.0);
+    }
+  }
+  return A;
+}
+
+}  // namespace
+
+TEST(test_RT_ToCpp, GeneratedCode) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  [[maybe_unused]] const RType res = f(x, y);
+
+  const auto cpp_file = std::filesystem::temp_directory_path() / "test_RT_ToCpp.cpp";
+  RT::to_cpp(g.get(), cpp_file);
+  const auto code = read_file(cpp_file);
+  EXPECT_NE(code.find("using T = double;"), std::string::npos);
+  EXPECT_NE(code.find("extern \"C\" std::int64_t f("), std::string::npos);
+  EXPECT_NE(code.find("inputs[1 * num_lanes + l]"), std::string::npos);
+  EXPECT_NE(code.find("std::sin("), std::string::npos);
+  // 0.1 is written exactly
+  EXPECT_NE(code.find("0x1.999999999999ap-4"), std::string::npos);
+  EXPECT_NE(code.find("outputs[0 * num_lanes + l] = v" + std::to_string(res.id())),
+            std::string::npos);
+}
+
+TEST(test_RT_ToCpp, MatchesEvaluator) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res1 = f(x, y);
+  const RType cond = compare(res1, y, RT::ComparisonType::GT);
+  const RType res2 = select(cond, -res1, f(y, x));
+
+  const std::array outputs{res1.id(), res2.id()};
+  const RT::CompiledFunction<PT> compiled(*g, outputs);
+  EXPECT_EQ(compiled.num_inputs(), 2ul);
+  EXPECT_EQ(compiled.num_outputs(), 2ul);
+
+  RT::Evaluator<PT> eval(*g);
+  const std::array<std::array<PT, 2>, 3> lanes{{{1.5, 2.5}, {0.7, 3.1}, {4.0, 0.5}}};
+  for (const auto& inputs : lanes) {
+    std::array<PT, 2> values{};
+    EXPECT_EQ(compiled.evaluate(inputs, values), 0);
+    eval.evaluate(inputs);
+    EXPECT_EQ(values[0], eval.value(res1.id()));
+    EXPECT_EQ(values[1], eval.value(res2.id()));
+  }
+
+  // All lanes at once, input `i` of lane `l` is stored at `i * num_lanes + l`
+  std::vector<PT> batch_inputs(2 * lanes.size());
+  std::vector<PT> batch_outputs(2 * lanes.size());
+  for (size_t l = 0; l < lanes.size(); ++l) {
+    batch_inputs[l]                = lanes[l][0];
+    batch_inputs[lanes.size() + l] = lanes[l][1];
+  }
+  EXPECT_EQ(compiled.evaluate(batch_inputs, batch_outputs, lanes.size()), 0);
+  for (size_t l = 0; l < lanes.size(); ++l) {
+    eval.evaluate(lanes[l]);
+    EXPECT_EQ(batch_outputs[l], eval.value(res1.id()));
+    EXPECT_EQ(batch_outputs[lanes.size() + l], eval.value(res2.id()));
+  }
+}
+
+TEST(test_RT_ToCpp, Int) {
+  using PT    = int;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 17;
+  RType y = 5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res = (x - y) * (x / y) + x % y - 3;
+
+  const std::array outputs{res.id()};
+  const RT::CompiledFunction<PT> compiled(*g, outputs);
+  const std::array inputs{23, 4};
+  std::array<PT, 1> values{};
+  EXPECT_EQ(compiled.evaluate(inputs, values), 0);
+  EXPECT_EQ(values[0], (23 - 4) * (23 / 4) + 23 % 4 - 3);
+}
+
+TEST(test_RT_ToCpp, Guard) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.0;
+  RType y = 2.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+
+  RType res;
+  if (x < y) {
+    res = x * y;
+  } else {
+    res = x + y;
+  }
+
+  const std::array outputs{res.id()};
+  const RT::CompiledFunction<PT> compiled(*g, outputs);
+
+  // Lanes (3, 4), (5, 4) and (6, 7), the second lane takes the other branch
+  const std::array inputs{3.0, 5.0, 6.0, 4.0, 4.0, 7.0};
+  std::array<PT, 3> values{};
+  EXPECT_EQ(compiled.evaluate(inputs, values, 3), 1);
+  EXPECT_EQ(values[0], 12.0);
+  EXPECT_EQ(values[2], 42.0);
+}
+
+TEST(test_RT_ToCpp, CompileError) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  static const int64_t op_id = RT::register_custom_op<PT>(
+      "not_implemented", 1, [](std::span<const PT> args) { return args[0]; });
+
+  RType x = 1.0;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  const RType res = custom_op(op_id, x);
+
+  // The declared custom operation is never defined
+  const std::array outputs{res.id()};
+  EXPECT_THROW(RT::CompiledFunction<PT>(*g, outputs), std::runtime_error);
+}
+
+TEST(test_RT_ToCpp, AdjointMatchesGradient) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType res1 = f(x, y);
+  const RType cond = compare(res1, y, RT::ComparisonType::GT);
+  const RType res2 = select(cond, -res1, f(y, x) * x);
+
+  const std::array outputs{res1.id(), res2.id()};
+  const RT::CompiledFunction<PT> compiled(*g, outputs, {.adjoint = true});
+
+  RT::Evaluator<PT> eval(*g);
+  const std::array seeds{0.5, -2.0};
+  for (const auto& [x_new, y_new] :
+       {std::pair{1.5, 2.5}, std::pair{0.7, 3.1}, std::pair{4.0, 0.5}}) {
+    const std::array inputs{x_new, y_new};
+    std::array<PT, 2> values{};
+    std::array<PT, 2> adjoints{};
+    EXPECT_EQ(compiled.evaluate_adjoint(inputs, seeds, values, adjoints), 0);
+
+    eval.evaluate(inputs);
+    const auto expected = RT::gradient<PT>(eval.tape(), eval.values(), outputs, seeds);
+    EXPECT_EQ(values[0], eval.value(res1.id()));
+    EXPECT_EQ(values[1], eval.value(res2.id()));
+    EXPECT_EQ(adjoints[0], expected[0]);
+    EXPECT_EQ(adjoints[1], expected[1]);
+  }
+}
+
+TEST(test_RT_ToCpp, AdjointLLTFiniteDifferences) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr Eigen::Index n = 5;
+  Eigen::MatrixX<RType> A  = spd_matrix<RType>(n);
+  auto g                   = std::make_shared<RT::Graph<PT>>();
+  for (Eigen::Index j = 0; j < n; ++j) {
+    for (Eigen::Index i = 0; i < n; ++i) {
+      A(i, j).register_graph(g);
+    }
+  }
+  const Eigen::MatrixX<RType> A_inv = A.llt().solve(Eigen::MatrixX<RType>::Identity(n, n));
+
+  std::vector<int64_t> outputs{};
+  std::vector<PT> seeds{};
+  for (const auto& r : A_inv.reshaped()) {
+    outputs.push_back(r.id());
+    seeds.push_back(0.1 * static_cast<PT>(seeds.size() + 1));
+  }
+  const RT::CompiledFunction<PT> compiled(*g, outputs, {.adjoint = true});
+
+  const Eigen::MatrixX<PT> A_value = spd_matrix<PT>(n);
+  const std::vector<PT> inputs(A_value.data(), A_value.data() + A_value.size());
+  std::vector<PT> values(outputs.size());
+  std::vector<PT> adjoints(inputs.size());
+  ASSERT_EQ(compiled.evaluate_adjoint(inputs, seeds, values, adjoints), 0);
+
+  // Central differences of `sum_o seeds[o] * A_inv[o]`
+  const auto weighted_sum = [&](const std::vector<PT>& x) {
+    std::vector<PT> y(outputs.size());
+    EXPECT_EQ(compiled.evaluate(x, y), 0);
+    PT sum = 0.0;
+    for (size_t o = 0; o < y.size(); ++o) {
+      sum += seeds[o] * y[o];
+    }
+    return sum;
+  };
+  constexpr PT h = 1e-6;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto x_plus  = inputs;
+    auto x_minus = inputs;
+    x_plus[i] += h;
+    x_minus[i] -= h;
+    const auto fd = (weighted_sum(x_plus) - weighted_sum(x_minus)) / (2.0 * h);
+    EXPECT_NEAR(adjoints[i], fd, 1e-7) << "input " << i;
+  }
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include <Eigen/Dense>
+
+#include "RecordType.hpp"
+#include "Tape.hpp"
+#include "ToPython.hpp"
+
+namespace {
+
+[[nodiscard]] auto read_file(const std::filesystem::path& file) -> std::string {
+  std::ifstream in(file);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+}  // namespace
+
+TEST(test_RT_ToPython, Adjoint) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 1.5;
+  RType y = 2.5;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  [[maybe_unused]] const RType res = sin(x) * y + sqrt(x);
+
+  const auto py_file = std::filesystem::temp_directory_path() / "test_RT_ToPython_Adjoint.py";
+  RT::to_python(g.get(), py_file, true);
+  const auto code = read_file(py_file);
+  EXPECT_NE(code.find("def f_adjoint(v0,v1,s5,):"), std::string::npos);
+  EXPECT_NE(code.find("a3 = a4 * v1"), std::string::npos);
+  EXPECT_NE(code.find("a0 = a3 * (math.cos(v0))"), std::string::npos);
+  EXPECT_NE(code.find("a0 += a2 * (1.0 / (2.0 * v2))"), std::string::npos);
+  EXPECT_NE(code.find("return a0, a1, "), std::string::npos);
+}
+
+// Compare the generated adjoint of an LLT solve with central differences of the generated primal
+TEST(test_RT_ToPython, AdjointLLTFiniteDifferences) {
+  using PT    = double;
+  using RType = RT::RecordType<PT>;
+
+  constexpr Eigen::Index n = 5;
+  Eigen::MatrixX<RType> A(n, n);
+  auto g = std::make_shared<RT::Graph<PT>>();
+  for (Eigen::Index j = 0; j < n; ++j) {
+    for (Eigen::Index i = 0; i < n; ++i) {
+      A(i, j) = 1.0 / static_cast<double>(i + j + 1) + (i == j ? static_cast<double>(n) : 0.0);
+      A(i, j).register_graph(g);
+    }
+  }
+  [[maybe_unused]] const Eigen::MatrixX<RType> A_inv =
+      A.llt().solve(Eigen::MatrixX<RType>::Identity(n, n));
+
+  const auto dir     = std::filesystem::temp_directory_path();
+  const auto py_file = dir / "test_RT_ToPython_llt.py";
+  RT::to_python(g.get(), py_file, true);
+  EXPECT_NE(read_file(py_file).find("def f_adjoint("), std::string::npos);
+
+  if (std::system("python3 -c pass > /dev/null 2>&1") != 0) {
+    GTEST_SKIP() << "python3 is not available.";
+  }
+
+  // The arguments of `f` are the recorded values of all inputs and constants
+  const auto check_file = dir / "test_RT_ToPython_llt_check.py";
+  {
+    std::ofstream out(check_file);
+    out << "import sys\n";
+    out << "sys.path.insert(0, '" << dir.string() << "')\n";
+    out << "from test_RT_ToPython_llt import f, f_adjoint\n\n";
+    out << "x = [" << std::setprecision(17);
+    const RT::Tape<PT> tape(*g);
+    for (int64_t id = 0; id < static_cast<int64_t>(tape.num_nodes()); ++id) {
+      if (tape.args(id).empty()) {
+        out << tape.values()[static_cast<size_t>(id)] << ", ";
+      }
+    }
+    out << "]\n";
+    out << "num_outputs = len(f(*x))\n";
+    out << "seeds = [0.1 * (o + 1) for o in range(num_outputs)]\n";
+    out << "adjoints = f_adjoint(*x, *seeds)\n";
+    out << "h = 1e-6\n";
+    out << "for i in range(len(x)):\n";
+    out << "    xp = list(x)\n";
+    out << "    xm = list(x)\n";
+    out << "    xp[i] += h\n";
+    out << "    xm[i] -= h\n";
+    out << "    fd = sum(s * (p - m) for s, p, m in zip(seeds, f(*xp), f(*xm))) / (2 * h)\n";
+    out << "    if abs(fd - adjoints[i]) > 1e-6 * max(1.0, abs(fd)):\n";
+    out << "        print(i, fd, adjoints[i])\n";
+    out << "        sys.exit(1)\n";
+  }
+  EXPECT_EQ(std::system(("python3 '" + check_file.string() + "'").c_str()), 0);
+}
+
+// Python integers are unbounded, the generated code has to wrap around like the unsigned type
+TEST(test_RT_ToPython, UnsignedWrapAround) {
+  using PT    = uint8_t;
+  using RType = RT::RecordType<PT>;
+
+  RType x = 3;
+  RType y = 200;
+
+  auto g = std::make_shared<RT::Graph<PT>>();
+  x.register_graph(g);
+  y.register_graph(g);
+  const RType diff = x - y;
+  const RType neg  = -x;
+  const RType prod = (x + y) * y;
+
+  const auto dir     = std::filesystem::temp_directory_path();
+  const auto py_file = dir / "test_RT_ToPython_unsigned.py";
+  RT::to_python(g.get(), py_file);
+  EXPECT_NE(read_file(py_file).find(") % 2**8"), std::string::npos);
+
+  if (std::system("python3 -c pass > /dev/null 2>&1") != 0) {
+    GTEST_SKIP() << "python3 is not available.";
+  }
+
+  const auto check_file = dir / "test_RT_ToPython_unsigned_check.py";
+  {
+    std::ofstream out(check_file);
+    out << "import sys\n";
+    out << "sys.path.insert(0, '" << dir.string() << "')\n";
+    out << "from test_RT_ToPython_unsigned import f\n\n";
+    out << "expected = (" << +diff.value() << ", " << +neg.value() << ", " << +prod.value()
+        << ")\n";
+    out << "sys.exit(0 if f(3, 200) == expected else 1)\n";
+  }
+  EXPECT_EQ(std::system(("python3 '" + check_file.string() + "'").c_str()), 0);
+}